@@ -0,0 +1,120 @@
+#include "Benchmark.h"
+#include <chrono>
+#include <iostream>
+
+// at least this buffers are processed for each measure, after the warmup
+#define BENCHMARK_MIN_BUFFERS 32
+#define BENCHMARK_WARMUP_BUFFERS 8
+
+Benchmark::Benchmark(){
+    bufferSizes = { 16, 64, 256, 1024, 4096 };
+    oversampleLevels = { 1, 2, 4 };
+    sampleRate = 44100.0;
+    seconds = 0.05;
+}
+
+double Benchmark::measure( int bufferSize ){
+    for( int i=0; i<BENCHMARK_WARMUP_BUFFERS; ++i ){
+        processor.processAndCopyOutput( nullptr, 0, bufferSize );
+    }
+
+    long buffers = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    while( buffers < BENCHMARK_MIN_BUFFERS || elapsed < seconds ){
+        for( int i=0; i<BENCHMARK_MIN_BUFFERS; ++i ){
+            processor.processAndCopyOutput( nullptr, 0, bufferSize );
+        }
+        buffers += BENCHMARK_MIN_BUFFERS;
+        elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+    return elapsed * 1.0e9 / double( buffers * bufferSize );
+}
+
+void Benchmark::run( std::ostream & csv, std::string filter ){
+
+    csv << "name,kind,inputs,rate,buffer_size,oversample,ns_per_sample,voices_per_core\n";
+
+    for( Entry & entry : entries ){
+        if( entry.name.find( filter ) == std::string::npos ){ continue; }
+        std::cerr << "benchmarking " << entry.name << "\n";
+
+        pdsp::Unit* unit = nullptr;
+        std::shared_ptr<pdsp::Patchable> object = entry.create( unit );
+
+        std::vector<std::string> inputs = object->getInputsList();
+        std::vector<std::string> outputs = object->getOutputsList();
+        if( outputs.empty() ){
+            std::cerr << entry.name << " has no outputs, skipped\n";
+            continue;
+        }
+
+        std::vector<StockSignal> signals( inputs.size() );
+        std::vector<pdsp::ValueControl> controls( inputs.size() );
+        for( pdsp::ValueControl & control : controls ){
+            control.set( 0.5f );
+        }
+
+        std::vector<int> levels = oversampleLevels;
+        if( unit == nullptr || ! entry.oversampled ){ levels = { 1 }; }
+
+        std::vector<std::string> rates = { "audio", "control" };
+        if( inputs.empty() ){ rates = { "none" }; }
+
+        for( const std::string & rate : rates ){
+            for( int oversample : levels ){
+                if( unit != nullptr && entry.oversampled ){
+                    unit->setOversampleLevel( oversample );
+                }
+                for( StockSignal & signal : signals ){
+                    signal.setOversampleLevel( oversample );
+                }
+
+                for( int bufferSize : bufferSizes ){
+                    pdsp::prepareAllToPlay( bufferSize, sampleRate );
+
+                    // time of the signals alone
+                    double overhead = 0.0;
+                    if( rate == "audio" ){
+                        for( StockSignal & signal : signals ){
+                            signal >> processor.blackhole;
+                        }
+                        overhead = measure( bufferSize );
+                        for( StockSignal & signal : signals ){
+                            signal.disconnectAll();
+                        }
+                    }
+
+                    for( size_t i=0; i<inputs.size(); ++i ){
+                        if( rate == "audio" ){
+                            signals[i] >> object->in( inputs[i].c_str() );
+                        }else{
+                            controls[i] >> object->in( inputs[i].c_str() );
+                        }
+                    }
+                    for( const std::string & output : outputs ){
+                        object->out( output.c_str() ) >> processor.blackhole;
+                    }
+
+                    double ns = measure( bufferSize ) - overhead;
+                    if( ns < 0.0 ){ ns = 0.0; }
+                    double voices = ( ns > 0.0 ) ? ( 1.0e9 / sampleRate ) / ns : 0.0;
+
+                    object->disconnectAll();
+                    for( pdsp::ValueControl & control : controls ){
+                        control.disconnectAll();
+                    }
+                    for( StockSignal & signal : signals ){
+                        signal.disconnectAll();
+                    }
+
+                    csv << entry.name << "," << ( unit != nullptr ? "unit" : "module" ) << ","
+                        << inputs.size() << "," << rate << "," << bufferSize << "," << oversample << ","
+                        << ns << "," << voices << "\n";
+                    csv.flush();
+                }
+            }
+        }
+        pdsp::releaseAll();
+    }
+}
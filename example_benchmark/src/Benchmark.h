@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ofxPDSP.h"
+#include "StockUnits.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+
+// measures the processing time of Units and modules, without window or audio device
+// each one is patched to the blackhole of a Processor, with all its inputs fed at audio rate or at control rate
+// the time of the signals feeding the inputs is measured apart and subtracted
+
+class Benchmark {
+
+public:
+    Benchmark();
+
+    // adds a Unit or module, setup is called after the construction to load tables or samples
+    // set oversampled to false for the Units that have their own oversample levels, like the resamplers
+    template<typename T>
+    void add( std::string name, std::function<void(T&)> setup = nullptr, bool oversampled = true ){
+        Entry entry;
+        entry.name = name;
+        entry.oversampled = oversampled;
+        entry.create = [setup]( pdsp::Unit* & unit ){
+            std::shared_ptr<T> object = std::make_shared<T>();
+            if( setup ){ setup( *object ); }
+            unit = asUnit( object.get() );
+            return std::shared_ptr<pdsp::Patchable>( object );
+        };
+        entries.push_back( entry );
+    }
+
+    // runs all the added entries with a name containing filter, writing one CSV line for each measure
+    void run( std::ostream & csv, std::string filter = "" );
+
+    std::vector<int> bufferSizes;
+    std::vector<int> oversampleLevels;
+    double sampleRate;
+    double seconds; // time measured for each configuration
+
+private:
+    struct Entry {
+        std::string name;
+        bool oversampled;
+        std::function<std::shared_ptr<pdsp::Patchable>( pdsp::Unit* & unit )> create;
+    };
+
+    // the oversample level can be set only for single Units
+    static pdsp::Unit* asUnit( pdsp::Unit* unit ){ return unit; }
+    static pdsp::Unit* asUnit( pdsp::Patchable* module ){ return nullptr; }
+
+    double measure( int bufferSize );
+
+    std::vector<Entry> entries;
+    pdsp::Processor processor;
+};
@@ -0,0 +1,33 @@
+#include "StockUnits.h"
+#include <vector>
+
+StockSignal::StockSignal(){
+    addOutput( "signal", output );
+    updateOutputNodes();
+    state = 1;
+}
+
+void StockSignal::process( int bufferSize ) noexcept {
+    float* buffer = getOutputBufferToFill( output );
+    for( int n=0; n<bufferSize; ++n ){
+        state = state * 1664525u + 1013904223u;
+        buffer[n] = float( state >> 8 ) * ( 1.0f / 16777216.0f );
+    }
+}
+
+StockData::StockData(){
+    // one second of noise, used also as impulse response
+    std::vector<float> noise( 44100 );
+    uint32_t state = 1;
+    for( size_t i=0; i<noise.size(); ++i ){
+        state = state * 1664525u + 1013904223u;
+        noise[i] = float( state >> 8 ) * ( 2.0f / 16777216.0f ) - 1.0f;
+    }
+    sample.load( noise.data(), 44100.0, noise.size() );
+
+    waveTable.setup( 512, 64 );
+    waveTable.addSawWave( 64 );
+    waveTable.addSquareWave( 64 );
+
+    dataTable.setup( 512, 64 );
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "ofxPDSP.h"
+#include <cstdint>
+
+// the stock Units and modules, shared by example_benchmark and example_realtimecheck
+// a new Unit or module has to be added only in addStockUnits()
+// example_realtimecheck compiles this folder with PROJECT_EXTERNAL_SOURCE_PATHS, see its config.make
+
+// audio rate pseudo random signal in the [0, 1) range, always the same, it also works as a trigger
+class StockSignal : public pdsp::Unit {
+public:
+    StockSignal();
+private:
+    void prepareUnit( int expectedBufferSize, double sampleRate ) override {}
+    void releaseResources() override {}
+    void process( int bufferSize ) noexcept override;
+    pdsp::OutputNode output;
+    uint32_t state;
+};
+
+// data for the entries that need it
+struct StockData {
+    StockData();
+
+    pdsp::SampleBuffer sample;
+    pdsp::WaveTable waveTable;
+    pdsp::DataTable dataTable;
+};
+
+// calls harness.add<T>( name, setup, oversampled ) for each stock Unit and module, data has to outlive the harness entries
+// oversampled is false for the Units that have their own oversample levels, like the resamplers
+template<typename Harness>
+void addStockUnits( Harness & harness, StockData & data ){
+
+    // ------------------------------ Units ------------------------------
+    // oscillators
+    harness.template add<pdsp::CheapSaw>( "CheapSaw" );
+    harness.template add<pdsp::CheapSine>( "CheapSine" );
+    harness.template add<pdsp::CheapTri>( "CheapTri" );
+    harness.template add<pdsp::CheapPulse>( "CheapPulse" );
+    harness.template add<pdsp::DPWTri>( "DPWTri" );
+    harness.template add<pdsp::BLEPSaw>( "BLEPSaw" );
+    harness.template add<pdsp::SineFB>( "SineFB" );
+    harness.template add<pdsp::WaveTableOsc>( "WaveTableOsc", [&]( pdsp::WaveTableOsc & osc ){ osc.setTable( data.waveTable ); } );
+    harness.template add<pdsp::DataOsc>( "DataOsc", [&]( pdsp::DataOsc & osc ){ osc.setTable( data.dataTable ); } );
+    harness.template add<pdsp::PMPhasor>( "PMPhasor" );
+    harness.template add<pdsp::LFOPhasor>( "LFOPhasor" );
+    harness.template add<pdsp::ClockedPhasor>( "ClockedPhasor" );
+    harness.template add<pdsp::PhasorShifter>( "PhasorShifter" );
+
+    // filters
+    harness.template add<pdsp::MultiLadder4>( "MultiLadder4" );
+    harness.template add<pdsp::SVF2>( "SVF2" );
+    harness.template add<pdsp::OnePole>( "OnePole" );
+    harness.template add<pdsp::APF1>( "APF1" );
+    harness.template add<pdsp::APF4>( "APF4" );
+    harness.template add<pdsp::BiquadLPF2>( "BiquadLPF2" );
+    harness.template add<pdsp::BiquadHPF2>( "BiquadHPF2" );
+    harness.template add<pdsp::BiquadBPF2>( "BiquadBPF2" );
+    harness.template add<pdsp::BiquadAPF2>( "BiquadAPF2" );
+    harness.template add<pdsp::BiquadNotch2>( "BiquadNotch2" );
+    harness.template add<pdsp::BiquadPeakEQ>( "BiquadPeakEQ" );
+    harness.template add<pdsp::BiquadLowShelf>( "BiquadLowShelf" );
+    harness.template add<pdsp::BiquadHighShelf>( "BiquadHighShelf" );
+
+    // envelopes and control
+    harness.template add<pdsp::ADSR>( "ADSR" );
+    harness.template add<pdsp::AHR>( "AHR" );
+    harness.template add<pdsp::TriggerGeiger>( "TriggerGeiger" );
+    harness.template add<pdsp::TriggeredRandom>( "TriggeredRandom" );
+    harness.template add<pdsp::SampleAndHold>( "SampleAndHold" );
+    harness.template add<pdsp::ToGateTrigger>( "ToGateTrigger" );
+
+    // delays
+    harness.template add<pdsp::Delay>( "Delay" );
+    harness.template add<pdsp::SRDelay>( "SRDelay" );
+    harness.template add<pdsp::LHDelay>( "LHDelay" );
+    harness.template add<pdsp::AllPassDelay>( "AllPassDelay" );
+    harness.template add<pdsp::SamplesDelay>( "SamplesDelay" );
+
+    // dynamics
+    harness.template add<pdsp::EnvelopeFollower>( "EnvelopeFollower" );
+    harness.template add<pdsp::RMSDetector>( "RMSDetector" );
+    harness.template add<pdsp::GainComputer>( "GainComputer" );
+
+    // utility and signal
+    harness.template add<pdsp::Amp>( "Amp" );
+    harness.template add<pdsp::Switch>( "Switch" );
+    harness.template add<pdsp::MaxValue2>( "MaxValue2" );
+    harness.template add<pdsp::OneBarTimeMs>( "OneBarTimeMs" );
+    harness.template add<pdsp::Bitcruncher>( "Bitcruncher" );
+    harness.template add<pdsp::Decimator>( "Decimator" );
+    harness.template add<pdsp::SoftClip>( "SoftClip" );
+    harness.template add<pdsp::Saturator1>( "Saturator1" );
+    harness.template add<pdsp::Saturator2>( "Saturator2" );
+    harness.template add<pdsp::AbsoluteValue>( "AbsoluteValue" );
+    harness.template add<pdsp::PositiveValue>( "PositiveValue" );
+    harness.template add<pdsp::BipolarToUnipolar>( "BipolarToUnipolar" );
+    harness.template add<pdsp::OneMinusInput>( "OneMinusInput" );
+    harness.template add<pdsp::SquarePeakDetector>( "SquarePeakDetector" );
+    harness.template add<pdsp::PitchToFreq>( "PitchToFreq" );
+    harness.template add<pdsp::FreqToMs>( "FreqToMs" );
+    harness.template add<pdsp::DBtoLin>( "DBtoLin" );
+    harness.template add<pdsp::LinToDB>( "LinToDB" );
+    harness.template add<pdsp::WhiteNoise>( "WhiteNoise" );
+
+    // resamplers
+    harness.template add<pdsp::IIRUpSampler2x>( "IIRUpSampler2x", nullptr, false );
+    harness.template add<pdsp::IIRDownSampler2x>( "IIRDownSampler2x", nullptr, false );
+    harness.template add<pdsp::ZeroUpSampler>( "ZeroUpSampler", nullptr, false );
+    harness.template add<pdsp::ZeroDownSampler>( "ZeroDownSampler", nullptr, false );
+
+    // samples
+    harness.template add<pdsp::Sampler>( "Sampler", [&]( pdsp::Sampler & sampler ){ sampler.addSample( &data.sample ); } );
+    harness.template add<pdsp::FDLConvolver>( "FDLConvolver", [&]( pdsp::FDLConvolver & convolver ){ convolver.loadIR( data.sample ); } );
+
+    // banks, many voices processed together
+    harness.template add<pdsp::PMPhasorBank>( "PMPhasorBank" );
+    harness.template add<pdsp::BLEPSawBank>( "BLEPSawBank" );
+    harness.template add<pdsp::MultiLadder4Bank>( "MultiLadder4Bank" );
+    harness.template add<pdsp::SVF2Bank>( "SVF2Bank" );
+    harness.template add<pdsp::ADSRBank>( "ADSRBank" );
+    harness.template add<pdsp::AmpBank>( "AmpBank" );
+
+    // ----------------------------- modules -----------------------------
+    harness.template add<pdsp::VAOscillator>( "VAOscillator" );
+    harness.template add<pdsp::FMOperator>( "FMOperator" );
+    harness.template add<pdsp::LFO>( "LFO" );
+    harness.template add<pdsp::ClockedLFO>( "ClockedLFO" );
+    harness.template add<pdsp::BitNoise>( "BitNoise" );
+    harness.template add<pdsp::TableOscillator>( "TableOscillator", [&]( pdsp::TableOscillator & osc ){ osc.setTable( data.waveTable ); } );
+    harness.template add<pdsp::DataOscillator>( "DataOscillator", [&]( pdsp::DataOscillator & osc ){ osc.setTable( data.dataTable ); } );
+    harness.template add<pdsp::VAFilter>( "VAFilter" );
+    harness.template add<pdsp::SVFilter>( "SVFilter" );
+    harness.template add<pdsp::CombFilter>( "CombFilter" );
+    harness.template add<pdsp::PhaserFilter>( "PhaserFilter" );
+    harness.template add<pdsp::LowCut>( "LowCut" );
+    harness.template add<pdsp::HighCut>( "HighCut" );
+    harness.template add<pdsp::PeakEQ>( "PeakEQ" );
+    harness.template add<pdsp::LowShelfEQ>( "LowShelfEQ" );
+    harness.template add<pdsp::HighShelfEQ>( "HighShelfEQ" );
+    harness.template add<pdsp::AAPeakEQ>( "AAPeakEQ" );
+    harness.template add<pdsp::AALowShelfEQ>( "AALowShelfEQ" );
+    harness.template add<pdsp::AAHighShelfEQ>( "AAHighShelfEQ" );
+    harness.template add<pdsp::Compressor>( "Compressor" );
+    harness.template add<pdsp::Ducker>( "Ducker" );
+    harness.template add<pdsp::BasiVerb>( "BasiVerb" );
+    harness.template add<pdsp::DimensionChorus>( "DimensionChorus" );
+    harness.template add<pdsp::Panner>( "Panner" );
+    harness.template add<pdsp::LinearCrossfader>( "LinearCrossfader" );
+    harness.template add<pdsp::GrainCloud>( "GrainCloud", [&]( pdsp::GrainCloud & cloud ){ cloud.setSample( &data.sample ); } );
+    harness.template add<pdsp::TriggeredGrain>( "TriggeredGrain", [&]( pdsp::TriggeredGrain & grain ){ grain.setSample( &data.sample ); } );
+    // IRVerb loads its impulse response from a file, FDLConvolver uses the same convolution
+}
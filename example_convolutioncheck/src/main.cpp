@@ -0,0 +1,97 @@
+#include "ofxPDSP.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+// headless check of pdsp::FDLConvolver against a direct convolution, no window or audio device is opened
+// the buffer sizes include sizes that are not a power of two, that split the partitions of the convolver
+// every size is checked with the uniform and with the non-uniform partitioning
+// the program returns 1 if the error is over the tolerance, so it can be run by scripts
+
+#define CHECK_IR_LENGTH 8000
+#define CHECK_LENGTH 24000
+#define CHECK_TOLERANCE 1.0e-4 // relative to the output peak
+
+// plays the same pseudo random signal used for the reference
+class Input : public pdsp::Unit {
+public:
+    Input( const std::vector<float> & signal ) : signal( signal ){
+        addOutput( "signal", output );
+        updateOutputNodes();
+        position = 0;
+    }
+private:
+    void prepareUnit( int expectedBufferSize, double sampleRate ) override { position = 0; }
+    void releaseResources() override {}
+    void process( int bufferSize ) noexcept override {
+        float* buffer = getOutputBufferToFill( output );
+        for( int n=0; n<bufferSize; ++n ){
+            buffer[n] = ( position < signal.size() ) ? signal[position] : 0.0f;
+            position++;
+        }
+    }
+    pdsp::OutputNode output;
+    const std::vector<float> & signal;
+    size_t position;
+};
+
+static std::vector<float> noise( size_t length, uint32_t state, float gain ){
+    std::vector<float> values( length );
+    for( size_t i=0; i<length; ++i ){
+        state = state * 1664525u + 1013904223u;
+        values[i] = ( float( state >> 8 ) * ( 2.0f / 16777216.0f ) - 1.0f ) * gain;
+    }
+    return values;
+}
+
+int main( int argc, char** argv ){
+
+    std::vector<float> ir = noise( CHECK_IR_LENGTH, 3, 0.05f );
+    std::vector<float> signal = noise( CHECK_LENGTH, 5, 0.5f );
+
+    std::vector<double> reference( CHECK_LENGTH, 0.0 );
+    double peak = 0.0;
+    for( int n=0; n<CHECK_LENGTH; ++n ){
+        for( int k=0; k<CHECK_IR_LENGTH && k<=n; ++k ){
+            reference[n] += double( ir[k] ) * double( signal[n-k] );
+        }
+        peak = std::max( peak, std::fabs( reference[n] ) );
+    }
+
+    pdsp::SampleBuffer impulseResponse;
+    impulseResponse.load( ir.data(), 44100.0, ir.size() );
+
+    int failed = 0;
+
+    for( int bufferSize : { 64, 256, 100, 300, 1000 } ){
+        for( bool nonUniform : { false, true } ){
+
+            pdsp::Processor processor( 1 );
+            Input input( signal );
+            pdsp::FDLConvolver convolver;
+            convolver.setNonUniformPartitioning( nonUniform );
+            convolver.loadIR( impulseResponse );
+            input >> convolver >> processor.channels[0];
+            pdsp::prepareAllToPlay( bufferSize, 44100.0 );
+
+            std::vector<float> buffer( bufferSize );
+            double error = 0.0;
+            for( int start=0; start + bufferSize <= CHECK_LENGTH; start += bufferSize ){
+                processor.processAndCopyInterleaved( buffer.data(), 1, bufferSize );
+                for( int n=0; n<bufferSize; ++n ){
+                    error = std::max( error, std::fabs( buffer[n] - reference[start+n] ) );
+                }
+            }
+            pdsp::releaseAll();
+
+            bool ok = error <= CHECK_TOLERANCE * peak;
+            std::cout << "buffer size " << bufferSize << ( nonUniform ? ", non-uniform" : ", uniform" )
+                      << ": max error " << error << " (peak " << peak << ") " << ( ok ? "ok" : "FAILED" ) << "\n";
+            if( ! ok ){ failed++; }
+        }
+    }
+
+    return ( failed > 0 ) ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+#include "RealtimeCheck.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// processing modes
+#define CHECK_RECURSIVE 0
+#define CHECK_COMPILED 1
+#define CHECK_PARALLEL 2
+#define CHECK_MODES 3
+
+static const char* modeNames[CHECK_MODES] = { "recursive", "compiled", "parallel" };
+
+RealtimeCheck::RealtimeCheck(){
+    bufferSize = 256;
+    buffers = 64;
+    sampleRate = 44100.0;
+    threads = 2;
+    control.set( 0.5f );
+}
+
+void RealtimeCheck::setMode( int mode ){
+    // the threads can be changed only while nothing is rendering
+    processor.setParallelThreads( mode==CHECK_PARALLEL ? threads : 1 );
+    processor.setCompiledGraph( mode != CHECK_RECURSIVE );
+}
+
+void RealtimeCheck::patch( pdsp::Patchable & object, pdsp::Patchable & source ){
+    for( const std::string & input : object.getInputsList() ){
+        source >> object.in( input.c_str() );
+    }
+    for( const std::string & output : object.getOutputsList() ){
+        object.out( output.c_str() ) >> processor.blackhole;
+    }
+}
+
+int RealtimeCheck::render( const std::string & name, const std::string & what ){
+    int before = pdsp::RealtimeChecker::getViolations();
+    for( int i=0; i<buffers; ++i ){
+        processor.processAndCopyOutput( nullptr, 0, bufferSize );
+    }
+    int found = pdsp::RealtimeChecker::getViolations() - before;
+
+    std::cerr << name << ", " << what << ": ";
+    if( found > 0 ){
+        std::cerr << found << " violations\n";
+    }else{
+        std::cerr << "ok\n";
+    }
+    return found;
+}
+
+int RealtimeCheck::repatch( const std::vector<Entry*> & selected ){
+
+    // all the objects are created before starting, as in an application that changes its patch while playing
+    std::vector<std::shared_ptr<pdsp::Patchable>> objects;
+    for( Entry* entry : selected ){
+        objects.push_back( entry->create() );
+    }
+    pdsp::prepareAllToPlay( bufferSize, sampleRate );
+
+    int before = pdsp::RealtimeChecker::getViolations();
+
+    std::atomic<bool> rendering( true );
+    std::thread audio( [&](){
+        while( rendering.load() ){
+            processor.processAndCopyOutput( nullptr, 0, bufferSize );
+            std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        }
+    });
+
+    for( size_t i=0; i<objects.size(); ++i ){
+        // each object is patched while the one before is still playing, that is removed after a while
+        // the outputs are not patched to other inputs, as not all of them expect unbounded values
+        pdsp::beginRepatch();
+        patch( *objects[i], signal );
+        pdsp::commitRepatch();
+
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+        if( i > 0 ){
+            objects[i-1]->disconnectAll();
+        }
+    }
+    if( ! objects.empty() ){
+        objects.back()->disconnectAll();
+    }
+
+    rendering = false;
+    audio.join();
+    signal.disconnectAll();
+
+    pdsp::releaseAll();
+
+    return pdsp::RealtimeChecker::getViolations() - before;
+}
+
+int RealtimeCheck::run( std::string filter ){
+
+    std::vector<Entry*> selected;
+    for( Entry & entry : entries ){
+        if( entry.name.find( filter ) != std::string::npos ){
+            selected.push_back( &entry );
+        }
+    }
+
+    int violations = 0;
+
+    for( int mode=0; mode<CHECK_MODES; ++mode ){
+        setMode( mode );
+        std::string modeName = modeNames[mode];
+
+        for( Entry* entry : selected ){
+            std::shared_ptr<pdsp::Patchable> object = entry->create();
+            pdsp::prepareAllToPlay( bufferSize, sampleRate );
+
+            patch( *object, signal );
+            violations += render( entry->name, modeName + ", audio rate inputs" );
+            object->disconnectAll();
+
+            patch( *object, control );
+            violations += render( entry->name, modeName + ", control rate inputs" );
+            object->disconnectAll();
+
+            signal.disconnectAll();
+            control.disconnectAll();
+            pdsp::releaseAll();
+        }
+
+        int found = repatch( selected );
+        std::cerr << "repatching while rendering, " << modeName << ": ";
+        if( found > 0 ){
+            std::cerr << found << " violations\n";
+        }else{
+            std::cerr << "ok\n";
+        }
+        violations += found;
+    }
+
+    setMode( CHECK_RECURSIVE );
+
+    return violations;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ofxPDSP.h"
+#include "StockUnits.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// runs the entries of addStockUnits() as Benchmark does, but it counts the real-time violations instead of the time
+// each entry is rendered for a fixed number of buffers with signal and with control inputs, in all the processing modes
+// then all the entries are patched and unpatched one after the other while another thread keeps rendering
+
+class RealtimeCheck {
+
+public:
+    RealtimeCheck();
+
+    // adds a Unit or module, setup is called after the construction to load tables or samples
+    // the same signature of Benchmark::add() to share addStockUnits(), the oversample levels are not changed here
+    template<typename T>
+    void add( std::string name, std::function<void(T&)> setup = nullptr, bool oversampled = true ){
+        Entry entry;
+        entry.name = name;
+        entry.create = [setup](){
+            std::shared_ptr<T> object = std::make_shared<T>();
+            if( setup ){ setup( *object ); }
+            return std::shared_ptr<pdsp::Patchable>( object );
+        };
+        entries.push_back( entry );
+    }
+
+    // checks all the added entries with a name containing filter, returns the number of violations
+    int run( std::string filter = "" );
+
+    int bufferSize;
+    int buffers;        // buffers rendered for each configuration
+    double sampleRate;
+    int threads;        // threads used for the parallel processing
+
+private:
+    struct Entry {
+        std::string name;
+        std::function<std::shared_ptr<pdsp::Patchable>()> create;
+    };
+
+    void setMode( int mode );
+    int render( const std::string & name, const std::string & what );
+    int repatch( const std::vector<Entry*> & selected );
+
+    // patches the object to the blackhole, with all its inputs fed by the signal or by the control
+    void patch( pdsp::Patchable & object, pdsp::Patchable & source );
+
+    std::vector<Entry> entries;
+    pdsp::Processor processor;
+    StockSignal signal;
+    pdsp::ValueControl control;
+};
@@ -0,0 +1,50 @@
+#include "ofxPDSP.h"
+#include "RealtimeCheck.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+// headless check of the real-time safety of the stock Units and modules, no window or audio device is opened
+// config.make defines PDSP_REALTIME_CHECKS, so the allocations, locks and blocking calls made while processing
+// are reported with the class of the Unit and a stack trace, see pdsp::RealtimeChecker
+// every Unit and module is rendered with the recursive, the compiled and the parallel processing,
+// then all of them are patched and unpatched while another thread is rendering
+// the program returns 1 if something is found, so it can be run by scripts
+//
+// options:
+//      --filter name       checks only the entries with a name containing name
+//      --buffers value     buffers rendered for each configuration, 64 by default
+//      --threads value     threads used for the parallel processing, 2 by default
+
+#ifndef PDSP_REALTIME_CHECKS
+#error "PDSP_REALTIME_CHECKS has to be defined for all the project, see config.make"
+#endif
+
+int main( int argc, char** argv ){
+
+    StockData data;
+    RealtimeCheck check;
+    std::string filter = "";
+
+    for( int i=1; i<argc; ++i ){
+        if( strcmp( argv[i], "--filter" )==0 && i+1<argc ){
+            filter = argv[++i];
+        }else if( strcmp( argv[i], "--buffers" )==0 && i+1<argc ){
+            check.buffers = atoi( argv[++i] );
+        }else if( strcmp( argv[i], "--threads" )==0 && i+1<argc ){
+            check.threads = atoi( argv[++i] );
+        }
+    }
+
+    // the Units and modules are listed in stock/StockUnits.h
+    addStockUnits( check, data );
+
+    int violations = check.run( filter );
+
+    if( violations > 0 ){
+        std::cout << violations << " real-time violations found\n";
+        return 1;
+    }
+    std::cout << "no real-time violations found\n";
+    return 0;
+}
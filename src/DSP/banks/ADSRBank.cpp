@@ -0,0 +1,428 @@
+
+#include "ADSRBank.h"
+#include <limits>
+
+pdsp::ADSRBank::VoiceEnvelope::VoiceEnvelope(){
+    stageSwitch = off;
+
+    attackTCO                       = 0.99999;    //digital
+    decayTCO = riseTCO = releaseTCO = exp(-4.95); //digital
+
+    sustainLevel = 0.0f;
+    decayNextStageLevel = 0.0f;
+    riseNextStageLevel = 0.0f;
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::reset( double sampleRate ){
+    setEnvelopeSampleRate( sampleRate );
+    stageSwitch = off;
+    envelopeOutput = 0.0;
+
+    calculateAttackTime();
+    calculateDecayTime();
+    calculateReleaseTime();
+    calculateRiseTime();
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::setAttackCurve( float hardness ){
+    float attackTCO = interpolate_linear(EnvelopeStage::digitalAttackTCO, EnvelopeStage::analogAttackTCO, hardness);
+    setAttackTCO(attackTCO);
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::setReleaseCurve( float hardness ){
+    float decayTCO  = interpolate_linear(EnvelopeStage::digitalDecayTCO, EnvelopeStage::analogDecayTCO, hardness);
+    setDecayTCO(decayTCO);
+    setRiseTCO(decayTCO);
+    setReleaseTCO(decayTCO);
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::retrigger( float triggerValue, float velocity, float sustain, float attackT, float decayT, float releaseT ){
+    // same as ADSR::onRetrigger()
+    if(triggerValue == PDSP_TRIGGER_OFF){
+            stageSwitch = releaseStage;
+    }else if( triggerValue > 0.0f ){
+            stageSwitch = attackStage;
+    }else if( triggerValue < 0.0f ){ //legato triggers
+            triggerValue = -triggerValue;
+            if(stageSwitch!=attackStage){
+                    if(triggerValue <= this->envelopeOutput){
+                            stageSwitch = decayStage;
+                    }else{
+                            stageSwitch = riseStage;
+                    }
+            }
+    }
+
+    triggerValue = (triggerValue > 1.0f) ? 1.0f : triggerValue;
+
+    this->intensity = (triggerValue * velocity)  + (1.0f-velocity);
+
+    setSustainLevel( sustain );
+
+    float riseT;
+    float riseNextLevel;
+    if(decayT < attackT){
+        riseT = decayT;
+    }else{
+        riseT = attackT;
+    }
+    if( this->intensity > envelopeOutput){
+        riseNextLevel = this->intensity;
+    }else{
+        riseNextLevel = sustainLevel;
+    }
+
+    setAttackTime( attackT );
+    setDecayTime( decayT, sustainLevel);
+    setRiseTime( riseT, riseNextLevel);
+    setReleaseTime( releaseT );
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::run(){
+    switch (stageSwitch){
+    case off         : envelopeOutput = 0.0; break;
+    case attackStage : Attack(stageSwitch, decayStage); break;
+    case decayStage  : Decay(stageSwitch, sustainStage); break;
+    case sustainStage: Sustain(); break;
+    case releaseStage: Release(stageSwitch, off); break;
+    case riseStage   : Rise(stageSwitch, decayStage); break;
+    }
+}
+
+bool pdsp::ADSRBank::VoiceEnvelope::running() const{
+    return ( stageSwitch != off && stageSwitch != sustainStage );
+}
+
+float pdsp::ADSRBank::VoiceEnvelope::level() const{
+    return envelopeOutput;
+}
+
+float pdsp::ADSRBank::VoiceEnvelope::sustain() const{
+    return sustainLevel;
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::setLevel( float value ){
+    envelopeOutput = value;
+}
+
+void pdsp::ADSRBank::VoiceEnvelope::lane( float & coeff, float & offset, float & ceiling, float & upperPre, float & upperPost, float & lowerPost ) const{
+
+    const float never = std::numeric_limits<float>::max();
+
+    coeff = 0.0f;
+    offset = 0.0f;
+    ceiling = never;
+    upperPre = never;
+    upperPost = never;
+    lowerPost = -never;
+
+    switch (stageSwitch){
+    case attackStage :
+        coeff = attackCoeff;
+        offset = attackOffset;
+        ceiling = intensity;
+        upperPre = intensity;
+        break;
+    case decayStage :
+        coeff = decayCoeff;
+        offset = decayOffset;
+        lowerPost = decayNextStageLevel;
+        break;
+    case sustainStage:
+        offset = sustainLevel;
+        break;
+    case releaseStage:
+        coeff = releaseCoeff;
+        offset = releaseOffset;
+        lowerPost = ( releaseTimeMs <= 0.0f ) ? never : 0.0f;
+        break;
+    case riseStage:
+        coeff = riseCoeff;
+        offset = riseOffset;
+        upperPost = riseNextStageLevel;
+        break;
+    default: break;
+    }
+}
+
+
+pdsp::ADSRBank::ADSRBank( int voices ) : VoiceBank( voices ),
+    input_trig( this->voices ), input_attack( this->voices ), input_decay( this->voices ),
+    input_sustain( this->voices ), input_release( this->voices ), input_velocity( this->voices ),
+    output( this->voices ), envelopes( this->voices ), triggers( this->voices, nullptr ),
+    active( this->voices, 0 ), meters( this->voices ){
+
+    for( int v=0; v<this->voices; ++v ){
+        addInput( voiceTag( "trig", v ), input_trig[v] );
+        addOutput( voiceTag( "signal", v ), output[v] );
+        addInput( voiceTag( "attack", v ), input_attack[v] );
+        addInput( voiceTag( "decay", v ), input_decay[v] );
+        addInput( voiceTag( "sustain", v ), input_sustain[v] );
+        addInput( voiceTag( "release", v ), input_release[v] );
+        addInput( voiceTag( "velocity", v ), input_velocity[v] );
+
+        voicePatchables[v].addVoiceInput( "trig", input_trig[v] );
+        voicePatchables[v].addVoiceOutput( "signal", output[v] );
+        voicePatchables[v].addVoiceInput( "attack", input_attack[v] );
+        voicePatchables[v].addVoiceInput( "decay", input_decay[v] );
+        voicePatchables[v].addVoiceInput( "sustain", input_sustain[v] );
+        voicePatchables[v].addVoiceInput( "release", input_release[v] );
+        voicePatchables[v].addVoiceInput( "velocity", input_velocity[v] );
+
+        input_attack[v].setDefaultValue(0.0f);
+        input_decay[v].setDefaultValue(150.0f);
+        input_sustain[v].setDefaultValue(0.5f);
+        input_release[v].setDefaultValue(150.0f);
+        input_velocity[v].setDefaultValue(1.0f);
+
+        meters[v].store(0.0f);
+    }
+    updateOutputNodes();
+
+    values = nullptr;
+    ofx_allocate_aligned( values, this->voices * 7 );
+    env       = values;
+    coeff     = values + this->voices;
+    offset    = values + this->voices * 2;
+    ceiling   = values + this->voices * 3;
+    upperPre  = values + this->voices * 4;
+    upperPost = values + this->voices * 5;
+    lowerPost = values + this->voices * 6;
+
+    outputLanes = nullptr;
+
+    if(dynamicConstruction){
+        prepareToPlay(globalBufferSize, globalSampleRate);
+    }
+}
+
+pdsp::ADSRBank::~ADSRBank(){
+    releaseResources();
+    ofx_deallocate_aligned( values );
+}
+
+pdsp::Patchable& pdsp::ADSRBank::set( float attackTimeMs, float decayTimeMs, float sustainLevel, float releaseTimeMs, float velocity ){
+    for( int v=0; v<voices; ++v ){
+        input_attack[v].setDefaultValue( attackTimeMs );
+        input_decay[v].setDefaultValue( decayTimeMs );
+        input_sustain[v].setDefaultValue( sustainLevel );
+        input_release[v].setDefaultValue( releaseTimeMs );
+        input_velocity[v].setDefaultValue( velocity );
+    }
+    return *this;
+}
+
+void pdsp::ADSRBank::setAttackCurve( float hardness ){
+    if(hardness < 0.0f) hardness = 0.0f;
+    if(hardness > 1.0f) hardness = 1.0f;
+
+    for( VoiceEnvelope & envelope : envelopes ){
+        envelope.setAttackCurve(hardness);
+    }
+}
+
+void pdsp::ADSRBank::setReleaseCurve( float hardness ){
+    if(hardness < 0.0f) hardness = 0.0f;
+    if(hardness > 1.0f) hardness = 1.0f;
+
+    for( VoiceEnvelope & envelope : envelopes ){
+        envelope.setReleaseCurve(hardness);
+    }
+}
+
+void pdsp::ADSRBank::setCurve( float hardness ){
+    setAttackCurve(hardness);
+    setReleaseCurve(hardness);
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_trig( int voice ){
+    return ch( voice ).in("trig");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_attack( int voice ){
+    return ch( voice ).in("attack");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_decay( int voice ){
+    return ch( voice ).in("decay");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_sustain( int voice ){
+    return ch( voice ).in("sustain");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_release( int voice ){
+    return ch( voice ).in("release");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::in_velocity( int voice ){
+    return ch( voice ).in("velocity");
+}
+
+pdsp::Patchable& pdsp::ADSRBank::out_signal( int voice ){
+    return ch( voice ).out("signal");
+}
+
+float pdsp::ADSRBank::meter_output( int voice ) const{
+    if( voice < 0 || voice >= voices ){ return 0.0f; }
+    return meters[voice].load();
+}
+
+void pdsp::ADSRBank::prepareUnit( int expectedBufferSize, double sampleRate){
+    for( int v=0; v<voices; ++v ){
+        envelopes[v].reset( sampleRate );
+        updateLane( v );
+    }
+    allocateLanes( outputLanes, expectedBufferSize );
+}
+
+void pdsp::ADSRBank::releaseResources(){
+    ofx_deallocate_aligned( outputLanes );
+}
+
+void pdsp::ADSRBank::updateLane( int voice ) noexcept {
+    env[voice] = envelopes[voice].level();
+    envelopes[voice].lane( coeff[voice], offset[voice], ceiling[voice], upperPre[voice], upperPost[voice], lowerPost[voice] );
+}
+
+int pdsp::ADSRBank::nextTrigger( int voice, int start, int bufferSize ) const noexcept {
+    const float* trigBuffer = triggers[voice];
+    if( trigBuffer != nullptr ){
+        for( int n=start; n<bufferSize; ++n ){
+            if( ! notTrigger( trigBuffer[n] ) ){
+                return n;
+            }
+        }
+    }
+    return bufferSize;
+}
+
+void pdsp::ADSRBank::scalarStep( int lane, int n ) noexcept {
+    // runs one sample of the 4 voices with the ADSR code, used when a voice changes stage
+    for( int v=lane; v<lane+4; ++v ){
+        envelopes[v].setLevel( env[v] );
+        envelopes[v].run();
+        outputLanes[ n*voices + v ] = envelopes[v].level();
+        updateLane( v );
+    }
+}
+
+void pdsp::ADSRBank::process(int bufferSize) noexcept {
+
+    bool anyActive = false;
+
+    for( int v=0; v<voices; ++v ){
+        int trigBufferState;
+        const float* trigBuffer = processInput(input_trig[v], trigBufferState);
+        triggers[v] = ( trigBufferState == AudioRate ) ? trigBuffer : nullptr;
+        active[v] = ( triggers[v] != nullptr || envelopes[v].running() );
+        if( active[v] ){ anyActive = true; }
+    }
+
+    if( anyActive ){
+        for( int g=0; g<groups; ++g ){
+            const int lane = g*4;
+            if( active[lane] || active[lane+1] || active[lane+2] || active[lane+3] ){
+                process_group( g, bufferSize );
+            }
+        }
+    }
+
+    for( int v=0; v<voices; ++v ){
+        if( active[v] ){
+            float* outputBuffer = getOutputBufferToFill(output[v]);
+            deinterleave( outputBuffer, outputLanes, v, bufferSize );
+            meters[v].store( outputBuffer[0] );
+        }else if( envelopes[v].stageSwitch == VoiceEnvelope::sustainStage ){
+            setControlRateOutput(output[v], envelopes[v].sustain());
+            meters[v].store( envelopes[v].sustain() );
+        }else{
+            setOutputToZero(output[v]);
+            meters[v].store( 0.0f );
+        }
+    }
+}
+
+void pdsp::ADSRBank::process_group( int group, int bufferSize ) noexcept {
+
+    const int lane = group*4;
+
+    int next[4];
+    for( int l=0; l<4; ++l ){
+        next[l] = nextTrigger( lane+l, 0, bufferSize );
+    }
+
+    ofx::f128 e   = ofx::m_load( env + lane );
+    ofx::f128 c   = ofx::m_load( coeff + lane );
+    ofx::f128 o   = ofx::m_load( offset + lane );
+    ofx::f128 top = ofx::m_load( ceiling + lane );
+    ofx::f128 uPre  = ofx::m_load( upperPre + lane );
+    ofx::f128 uPost = ofx::m_load( upperPost + lane );
+    ofx::f128 lPost = ofx::m_load( lowerPost + lane );
+
+    int n = 0;
+    while( n < bufferSize ){
+
+        int end = next[0];
+        for( int l=1; l<4; ++l ){
+            end = ( next[l] < end ) ? next[l] : end;
+        }
+
+        bool reload = false;
+
+        // vectorized segment, until the next trigger
+        for( ; n<end; ++n ){
+            ofx::f128 prev = e;
+            e = ofx::m_min( ofx::m_add( o, ofx::m_mul( prev, c ) ), top );
+
+            ofx::f128 change = ofx::m_or( ofx::m_cmp_ge( prev, uPre ),
+                               ofx::m_or( ofx::m_cmp_ge( e, uPost ), ofx::m_cmp_le( e, lPost ) ) );
+
+            if( ofx::m_any( change ) ){
+                ofx::m_store( env + lane, prev );
+                scalarStep( lane, n );
+                reload = true;
+                break;
+            }
+
+            ofx::m_store( outputLanes + n*voices + lane, e );
+        }
+
+        if( reload ){
+            ++n;
+        }else if( n < bufferSize ){
+            // trigger sample
+            ofx::m_store( env + lane, e );
+            for( int l=0; l<4; ++l ){
+                if( next[l] == n ){
+                    const int v = lane + l;
+                    envelopes[v].setLevel( env[v] );
+                    envelopes[v].retrigger( triggers[v][n],
+                                            processAndGetSingleValue(input_velocity[v], n),
+                                            processAndGetSingleValue(input_sustain[v], n),
+                                            processAndGetSingleValue(input_attack[v], n),
+                                            processAndGetSingleValue(input_decay[v], n),
+                                            processAndGetSingleValue(input_release[v], n) );
+                    next[l] = nextTrigger( v, n+1, bufferSize );
+                }
+            }
+            scalarStep( lane, n );
+            ++n;
+        }else{
+            break;
+        }
+
+        e     = ofx::m_load( env + lane );
+        c     = ofx::m_load( coeff + lane );
+        o     = ofx::m_load( offset + lane );
+        top   = ofx::m_load( ceiling + lane );
+        uPre  = ofx::m_load( upperPre + lane );
+        uPost = ofx::m_load( upperPost + lane );
+        lPost = ofx::m_load( lowerPost + lane );
+    }
+
+    ofx::m_store( env + lane, e );
+    for( int v=lane; v<lane+4; ++v ){
+        envelopes[v].setLevel( env[v] );
+    }
+}
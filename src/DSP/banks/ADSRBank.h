@@ -0,0 +1,190 @@
+
+// ADSRBank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_ADSRBANK_H_INCLUDED
+#define PDSP_BANKS_ADSRBANK_H_INCLUDED
+
+#include "VoiceBank.h"
+#include "../envelopes/stages/EnvelopeStage.h"
+#include "../envelopes/stages/AttackStage.h"
+#include "../envelopes/stages/DecayStage.h"
+#include "../envelopes/stages/RiseStage.h"
+#include "../envelopes/stages/SustainStage.h"
+#include "../envelopes/stages/ReleaseStage.h"
+
+namespace pdsp{
+    /*!
+    @brief Many voices of the ADSR envelope, processed together.
+
+    This is the same envelope of ADSR but it runs many voices at once, one for each SIMD lane. All the stages of the envelope are a one pole curve, so the per-sample update is calculated for 4 voices with each operation, and only the samples where a voice is triggered or changes stage are processed one voice at time. Each voice has the same inputs of ADSR and the "signal" output, select them with ch( voice ) or with the methods that take the voice index. The "bias" output and the dB triggering mode of ADSR are not available.
+    */
+class ADSRBank : public Unit, public VoiceBank
+{
+public:
+    /*!
+    @brief constructs the bank
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    */
+    ADSRBank( int voices = 8 );
+    ~ADSRBank();
+
+    /*!
+    @brief sets the default envelope values of all the voices and returns the unit ready to be patched.
+    @param[in] attackTimeMs attack time
+    @param[in] decayTimeMs decay time
+    @param[in] sustainLevel sustain level
+    @param[in] releaseTimeMs release time
+    @param[in] velocity sensitivity to trigger values
+    */
+    Patchable& set( float attackTimeMs, float decayTimeMs, float sustainLevel, float releaseTimeMs, float velocity = 1.0f );
+
+    /*!
+    @brief sets the curve of the attack stage of all the voices, as ADSR::setAttackCurve().
+    @param[in] hardness how much analog-like the analog curve is, value is clamped to the 0.0<-->1.0f range
+    */
+    void setAttackCurve( float hardness );
+
+    /*!
+    @brief sets the curve of the decay and release stages of all the voices, as ADSR::setReleaseCurve().
+    @param[in] hardness how much analog-like the analog curve is, value is clamped to the 0.0<-->1.0f range
+    */
+    void setReleaseCurve( float hardness );
+
+    /*!
+    @brief sets the curve of all the stages of all the voices.
+    @param[in] hardness how much analog-like the analog curve is, value is clamped to the 0.0<-->1.0f range
+    */
+    void setCurve( float hardness );
+
+    /*!
+    @brief Sets "trig" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. Patch an out_trig() here.
+    @param[in] voice voice index
+    */
+    Patchable& in_trig( int voice );
+
+    /*!
+    @brief Sets "attack" of the given voice as selected input and returns it ready to be patched. This input sets the attack time in milliseconds, taken once every trigger.
+    @param[in] voice voice index
+    */
+    Patchable& in_attack( int voice );
+
+    /*!
+    @brief Sets "decay" of the given voice as selected input and returns it ready to be patched. This input sets the decay time in milliseconds, taken once every trigger.
+    @param[in] voice voice index
+    */
+    Patchable& in_decay( int voice );
+
+    /*!
+    @brief Sets "sustain" of the given voice as selected input and returns it ready to be patched. This input sets the sustain level, taken once every trigger.
+    @param[in] voice voice index
+    */
+    Patchable& in_sustain( int voice );
+
+    /*!
+    @brief Sets "release" of the given voice as selected input and returns it ready to be patched. This input sets the release time in milliseconds, taken once every trigger.
+    @param[in] voice voice index
+    */
+    Patchable& in_release( int voice );
+
+    /*!
+    @brief Sets "velocity" of the given voice as selected input and returns it ready to be patched. This is the influence of the trigger values on the envelope output, from 0.0f to 1.0f.
+    @param[in] voice voice index
+    */
+    Patchable& in_velocity( int voice );
+
+    /*!
+    @brief Sets "signal" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice. This is the envelope output.
+    @param[in] voice voice index
+    */
+    Patchable& out_signal( int voice );
+
+    /*!
+    @brief returns the first value of the last processed output buffer of the given voice. This method is thread-safe.
+    @param[in] voice voice index
+    */
+    float meter_output( int voice ) const;
+
+private:
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    // the scalar state of a voice, the same stages of ADSR
+    class VoiceEnvelope :   public virtual EnvelopeStage,
+                            public virtual AttackStage,
+                            public virtual DecayStage,
+                            public virtual RiseStage,
+                            public virtual SustainStage,
+                            public virtual ReleaseStage
+    {
+    public:
+        VoiceEnvelope();
+
+        void reset( double sampleRate );
+        void setAttackCurve( float hardness );
+        void setReleaseCurve( float hardness );
+        void retrigger( float triggerValue, float velocity, float sustain, float attackT, float decayT, float releaseT );
+        void run();
+        bool running() const;
+        float level() const;
+        float sustain() const;
+        void setLevel( float value );
+
+        // fills the lane values for the vector update: env = min( offset + env*coeff, ceiling )
+        // and the thresholds that make the stage change
+        void lane( float & coeff, float & offset, float & ceiling, float & upperPre, float & upperPost, float & lowerPost ) const;
+
+        int stageSwitch;
+
+        static const int off          = 0;
+        static const int attackStage  = 1;
+        static const int decayStage   = 2;
+        static const int sustainStage = 3;
+        static const int releaseStage = 4;
+        static const int riseStage    = 5;
+    };
+/*!
+    @endcond
+*/
+
+    void process(int bufferSize) noexcept override;
+    void prepareUnit( int expectedBufferSize, double sampleRate) override;
+    void releaseResources() override;
+
+    void process_group( int group, int bufferSize ) noexcept;
+    void updateLane( int voice ) noexcept;
+    void scalarStep( int lane, int n ) noexcept;
+    int nextTrigger( int voice, int start, int bufferSize ) const noexcept;
+
+    std::vector<InputNode> input_trig;
+    std::vector<InputNode> input_attack;
+    std::vector<InputNode> input_decay;
+    std::vector<InputNode> input_sustain;
+    std::vector<InputNode> input_release;
+    std::vector<InputNode> input_velocity;
+    std::vector<OutputNode> output;
+
+    std::vector<VoiceEnvelope> envelopes;
+    std::vector<const float*> triggers;
+    std::vector<int> active;
+
+    // one value for each voice, aligned for the vector loads
+    float* values;
+    float* env;
+    float* coeff;
+    float* offset;
+    float* ceiling;
+    float* upperPre;
+    float* upperPost;
+    float* lowerPost;
+
+    float* outputLanes;
+
+    std::vector<std::atomic<float>> meters;
+};
+
+}//END NAMESPACE
+
+#endif  // PDSP_BANKS_ADSRBANK_H_INCLUDED
@@ -0,0 +1,85 @@
+
+#include "AmpBank.h"
+
+pdsp::AmpBank::AmpBank( int voices ) : VoiceBank( voices ),
+    input_signal( this->voices ), input_mod( this->voices ), output( this->voices ){
+
+    for( int v=0; v<this->voices; ++v ){
+        addInput( voiceTag( "signal", v ), input_signal[v] );
+        addInput( voiceTag( "mod", v ), input_mod[v] );
+        addOutput( voiceTag( "signal", v ), output[v] );
+
+        voicePatchables[v].addVoiceInput( "signal", input_signal[v] );
+        voicePatchables[v].addVoiceInput( "mod", input_mod[v] );
+        voicePatchables[v].addVoiceOutput( "signal", output[v] );
+
+        input_mod[v].setDefaultValue(0.0f);
+    }
+    updateOutputNodes();
+
+    if(dynamicConstruction){
+        prepareToPlay(globalBufferSize, globalSampleRate);
+    }
+}
+
+pdsp::Patchable& pdsp::AmpBank::set( float value ){
+    for( int v=0; v<voices; ++v ){
+        input_mod[v].setDefaultValue(value);
+    }
+    return *this;
+}
+
+pdsp::Patchable& pdsp::AmpBank::in_signal( int voice ){
+    return ch( voice ).in("signal");
+}
+
+pdsp::Patchable& pdsp::AmpBank::in_mod( int voice ){
+    return ch( voice ).in("mod");
+}
+
+pdsp::Patchable& pdsp::AmpBank::out_signal( int voice ){
+    return ch( voice ).out("signal");
+}
+
+void pdsp::AmpBank::prepareUnit ( int expectedBufferSize, double sampleRate ) {
+
+}
+
+void pdsp::AmpBank::releaseResources () {
+
+}
+
+void pdsp::AmpBank::process (int bufferSize) noexcept {
+
+    for( int v=0; v<voices; ++v ){
+
+        int modState;
+        const float* modBuffer = processInput(input_mod[v], modState);
+
+        if ( modBuffer[0] == 0.0f && modState != AudioRate ){
+            setOutputToZero(output[v]);
+            continue;
+        }
+
+        int signalState;
+        const float* signalBuffer = processInput(input_signal[v], signalState);
+
+        int switcher = signalState + modState*4;
+
+        switch ( switcher & 42 ) {
+        case 0:  // signal control rate, mod control rate
+            setControlRateOutput(output[v], modBuffer[0]*signalBuffer[0]);
+            break;
+        case 2:  // signal audio rate, mod control rate
+            ofx_Aeq_BmulS(getOutputBufferToFill(output[v]), signalBuffer, modBuffer[0], bufferSize);
+            break;
+        case 8:  // signal control rate, mod audio rate
+            ofx_Aeq_BmulS(getOutputBufferToFill(output[v]), modBuffer, signalBuffer[0], bufferSize);
+            break;
+        case 10: // signal audio rate, mod audio rate
+            ofx_Aeq_BmulC(getOutputBufferToFill(output[v]), signalBuffer, modBuffer, bufferSize);
+            break;
+        default: break;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+
+// AmpBank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_AMPBANK_H_INCLUDED
+#define PDSP_BANKS_AMPBANK_H_INCLUDED
+
+#include "VoiceBank.h"
+
+namespace pdsp{
+
+    /*!
+    @brief Many voices of the Amp, processed together.
+
+    Each voice multiplies its "signal" input for its "mod" input, as Amp does. The multiplication has no state, so each voice is processed on its own buffers with the same vectorized routines of Amp, this class is here to have the VCA of a polyphonic voice in the same bank layout of the other banks. If the "mod" input of a voice is running at control rate and it is equal to 0.0f its "signal" branch is not even calculated.
+    */
+class AmpBank : public Unit, public VoiceBank {
+
+public:
+    /*!
+    @brief constructs the bank
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    */
+    AmpBank( int voices = 8 );
+
+    /*!
+    @brief set the default "mod" value of all the voices and returns the unit ready to be patched.
+    @param[in] value Value to set for scaling the input signals, Default is 0.0f .
+    */
+    Patchable& set( float value );
+
+    /*!
+    @brief Sets "signal" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. This input is the signal/value to multiply.
+    @param[in] voice voice index
+    */
+    Patchable& in_signal( int voice );
+
+    /*!
+    @brief Sets "mod" of the given voice as selected input and returns it ready to be patched. The "signal" input of the voice is multiplied by this value/signal.
+    @param[in] voice voice index
+    */
+    Patchable& in_mod( int voice );
+
+    /*!
+    @brief Sets "signal" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice.
+    @param[in] voice voice index
+    */
+    Patchable& out_signal( int voice );
+
+private:
+    void prepareUnit ( int expectedBufferSize, double sampleRate ) override;
+    void releaseResources () override;
+    void process (int bufferSize) noexcept override;
+
+    std::vector<InputNode>  input_signal;
+    std::vector<InputNode>  input_mod;
+    std::vector<OutputNode> output;
+};
+
+}//END NAMESPACE
+
+#endif  // PDSP_BANKS_AMPBANK_H_INCLUDED
@@ -0,0 +1,136 @@
+
+#include "BLEPSawBank.h"
+#include "../oscillators/antialiased/BLEP/BLEPFunc.h"
+
+pdsp::BLEPSawBank::BLEPSawBank( int voices, Window_t window, bool eight, int length, bool interpolate ) : VoiceBank( voices ),
+    input_phase( this->voices ), input_inc( this->voices ), output( this->voices ), active( this->voices, 0 ){
+
+    setTable(window, eight, length, interpolate);
+
+    for( int v=0; v<this->voices; ++v ){
+        addInput( voiceTag( "phase", v ), input_phase[v] );
+        addInput( voiceTag( "inc", v ), input_inc[v] );
+        addOutput( voiceTag( "signal", v ), output[v] );
+
+        voicePatchables[v].addVoiceInput( "phase", input_phase[v] );
+        voicePatchables[v].addVoiceInput( "inc", input_inc[v] );
+        voicePatchables[v].addVoiceOutput( "signal", output[v] );
+    }
+    updateOutputNodes();
+
+    phaseLanes = nullptr;
+    incLanes = nullptr;
+    outputLanes = nullptr;
+
+    if(dynamicConstruction){
+        prepareToPlay(globalBufferSize, globalSampleRate);
+    }
+}
+
+pdsp::BLEPSawBank::BLEPSawBank( int voices ) : BLEPSawBank( voices, Rectangular, false, 4096, true ){}
+
+pdsp::BLEPSawBank::~BLEPSawBank(){
+    releaseResources();
+}
+
+pdsp::Patchable& pdsp::BLEPSawBank::in_phase( int voice ){
+    return ch( voice ).in("phase");
+}
+
+pdsp::Patchable& pdsp::BLEPSawBank::in_inc( int voice ){
+    return ch( voice ).in("inc");
+}
+
+pdsp::Patchable& pdsp::BLEPSawBank::out_signal( int voice ){
+    return ch( voice ).out("signal");
+}
+
+void pdsp::BLEPSawBank::prepareUnit( int expectedBufferSize, double sampleRate) {
+    allocateLanes( phaseLanes, expectedBufferSize );
+    allocateLanes( incLanes, expectedBufferSize );
+    allocateLanes( outputLanes, expectedBufferSize );
+}
+
+void pdsp::BLEPSawBank::releaseResources () {
+    ofx_deallocate_aligned( phaseLanes );
+    ofx_deallocate_aligned( incLanes );
+    ofx_deallocate_aligned( outputLanes );
+}
+
+void pdsp::BLEPSawBank::process (int bufferSize) noexcept {
+
+    bool anyActive = false;
+
+    for( int v=0; v<voices; ++v ){
+        int phaseBufferState;
+        const float* phaseBuffer = processInput(input_phase[v], phaseBufferState);
+        active[v] = ( phaseBufferState == AudioRate );
+
+        if( active[v] ){
+            anyActive = true;
+            interleave( phaseLanes, v, phaseBuffer, phaseBufferState, bufferSize );
+            int incBufferState;
+            const float* incBuffer = processInput(input_inc[v], incBufferState);
+            interleave( incLanes, v, incBuffer, incBufferState, bufferSize );
+        }else{
+            interleaveZero( phaseLanes, v, bufferSize );
+            interleaveZero( incLanes, v, bufferSize );
+        }
+    }
+
+    if( ! anyActive ){
+        for( int v=0; v<voices; ++v ){
+            setOutputToZero(output[v]);
+        }
+        return;
+    }
+
+    const float* table = blepTable->buffer;
+    float points = blepTable->points;
+    int points_i = static_cast<int>(points);
+    float tableFakeLen = blepTable->length_f;
+    float tableCenter = tableFakeLen * 0.5f - 1.0f;
+    float oneSlashPointPerSide = 1.0f / points;
+
+    alignas(16) float phases[4];
+    alignas(16) float incs[4];
+    alignas(16) float saws[4];
+
+    for( int g=0; g<groups; ++g ){
+        const int lane = g*4;
+
+        for( int n=0; n<bufferSize; ++n ){
+            const int index = n*voices + lane;
+
+            ofx::f128 p = ofx::m_load( phaseLanes + index );
+            ofx::f128 i = ofx::m_abs( ofx::m_load( incLanes + index ) );
+
+            // trivial saw
+            ofx::f128 saw = ofx::m_sub1( ofx::m_mul1( p, 2.0f ), 1.0f );
+
+            // BLEP correction, only for the lanes less than points increments away from the edge
+            ofx::f128 distance = ofx::m_mul1( i, points );
+            ofx::f128 edge = ofx::m_or( ofx::m_cmp_gt( p, ofx::m_1sub( 1.0f, distance ) ), ofx::m_cmp_lt( p, distance ) );
+
+            if( ofx::m_any( edge ) ){
+                ofx::m_store( phases, p );
+                ofx::m_store( incs, i );
+                ofx::m_store( saws, saw );
+                for( int l=0; l<4; ++l ){
+                    saws[l] += BLEPn( table, tableFakeLen, phases[l], incs[l], 1.0f, points, points_i, interpolateBLEP, tableCenter, oneSlashPointPerSide );
+                }
+                saw = ofx::m_load( saws );
+            }
+
+            ofx::m_store( outputLanes + index, saw );
+        }
+    }
+
+    for( int v=0; v<voices; ++v ){
+        if( active[v] ){
+            deinterleave( getOutputBufferToFill(output[v]), outputLanes, v, bufferSize );
+        }else{
+            setOutputToZero(output[v]);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+
+// BLEPSawBank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_BLEPSAWBANK_H_INCLUDED
+#define PDSP_BANKS_BLEPSAWBANK_H_INCLUDED
+
+#include "VoiceBank.h"
+#include "../oscillators/antialiased/BLEP/BLEPBased.h"
+
+namespace pdsp{
+    /*!
+    @brief Many voices of the BLEPSaw oscillator, processed together.
+
+    This is the antialiased saw of BLEPSaw running many voices at once, one for each SIMD lane. The trivial saw and the check for the discontinuities are calculated for 4 voices with each operation, the BLEP residual is added only to the voices near a discontinuity. Each voice has the "phase" and "inc" inputs and the "signal" output of BLEPSaw, select them with ch( voice ) or with the methods that take the voice index. A voice with its "phase" input not running at audio rate outputs silence.
+    */
+class BLEPSawBank : public BLEPBased, public Unit, public VoiceBank {
+
+public:
+    /*!
+    @brief constructs the bank, with the same BLEP table arguments of BLEPSaw
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    @param[in] window BLEP window type
+    @param[in] eight if 8 points are used instead of 2
+    @param[in] length BLEP table length
+    @param[in] interpolate if the BLEP values are interpolated
+    */
+    BLEPSawBank( int voices, Window_t window, bool eight, int length, bool interpolate );
+    BLEPSawBank( int voices = 8 );
+    ~BLEPSawBank();
+
+    /*!
+    @brief Sets "phase" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. Patch a phazor out_phase() here.
+    @param[in] voice voice index
+    */
+    Patchable& in_phase( int voice );
+
+    /*!
+    @brief Sets "inc" of the given voice as selected input and returns it ready to be patched. Patch the out_inc() of the same phazor here, it is mandatory for the BLEP algorithm to function.
+    @param[in] voice voice index
+    */
+    Patchable& in_inc( int voice );
+
+    /*!
+    @brief Sets "signal" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice.
+    @param[in] voice voice index
+    */
+    Patchable& out_signal( int voice );
+
+private:
+    void prepareUnit( int expectedBufferSize, double sampleRate) override;
+    void releaseResources () override;
+    void process (int bufferSize) noexcept override ;
+
+    std::vector<InputNode>  input_phase;
+    std::vector<InputNode>  input_inc;
+    std::vector<OutputNode> output;
+
+    std::vector<int> active;
+
+    float* phaseLanes;
+    float* incLanes;
+    float* outputLanes;
+};
+
+}//END NAMESPACE
+
+#endif  // PDSP_BANKS_BLEPSAWBANK_H_INCLUDED
@@ -0,0 +1,334 @@
+
+#include "MultiLadder4Bank.h"
+
+pdsp::MultiLadder4Bank::MultiLadder4Bank( int voices ) : VoiceBank( voices ),
+    input_signal( this->voices ), input_cutoff( this->voices ), input_reso( this->voices ),
+    output_lpf4( this->voices ), output_lpf2( this->voices ), output_bpf4( this->voices ),
+    output_bpf2( this->voices ), output_hpf4( this->voices ), output_hpf2( this->voices ),
+    active( this->voices, 0 ){
+
+        for( int v=0; v<this->voices; ++v ){
+            addInput( voiceTag( "signal", v ), input_signal[v] );
+            addInput( voiceTag( "freq", v ), input_cutoff[v] );
+            addInput( voiceTag( "reso", v ), input_reso[v] );
+            addOutput( voiceTag( "lpf4", v ), output_lpf4[v] );
+            addOutput( voiceTag( "lpf2", v ), output_lpf2[v] );
+            addOutput( voiceTag( "bpf4", v ), output_bpf4[v] );
+            addOutput( voiceTag( "bpf2", v ), output_bpf2[v] );
+            addOutput( voiceTag( "hpf4", v ), output_hpf4[v] );
+            addOutput( voiceTag( "hpf2", v ), output_hpf2[v] );
+
+            voicePatchables[v].addVoiceInput( "signal", input_signal[v] );
+            voicePatchables[v].addVoiceInput( "freq", input_cutoff[v] );
+            voicePatchables[v].addVoiceInput( "reso", input_reso[v] );
+            voicePatchables[v].addVoiceOutput( "lpf4", output_lpf4[v] );
+            voicePatchables[v].addVoiceOutput( "lpf2", output_lpf2[v] );
+            voicePatchables[v].addVoiceOutput( "bpf4", output_bpf4[v] );
+            voicePatchables[v].addVoiceOutput( "bpf2", output_bpf2[v] );
+            voicePatchables[v].addVoiceOutput( "hpf4", output_hpf4[v] );
+            voicePatchables[v].addVoiceOutput( "hpf2", output_hpf2[v] );
+
+            input_cutoff[v].setDefaultValue(8000.0f);
+            input_reso[v].setDefaultValue(0.0f);
+            input_cutoff[v].enableBoundaries( 20.0f, 20000.0f);
+            input_reso[v].enableBoundaries( 0.0f, 1.0f);
+        }
+        updateOutputNodes();
+
+        values = nullptr;
+        ofx_allocate_aligned( values, this->voices * 11 );
+        alpha  = values;
+        alpha0 = values + this->voices;
+        beta1  = values + this->voices * 2;
+        beta2  = values + this->voices * 3;
+        beta3  = values + this->voices * 4;
+        beta4  = values + this->voices * 5;
+        K      = values + this->voices * 6;
+        z1_1   = values + this->voices * 7;
+        z1_2   = values + this->voices * 8;
+        z1_3   = values + this->voices * 9;
+        z1_4   = values + this->voices * 10;
+
+        signalLanes = nullptr;
+        waLanes = nullptr;
+        resoLanes = nullptr;
+        lpf4Lanes = nullptr;
+        lpf2Lanes = nullptr;
+        bpf4Lanes = nullptr;
+        bpf2Lanes = nullptr;
+        hpf4Lanes = nullptr;
+        hpf2Lanes = nullptr;
+        warped = nullptr;
+
+        if(dynamicConstruction){
+                prepareToPlay(globalBufferSize, globalSampleRate);
+        }
+}
+
+pdsp::MultiLadder4Bank::~MultiLadder4Bank(){
+    releaseResources();
+    ofx_deallocate_aligned( values );
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::in_signal( int voice ){
+    return ch( voice ).in("signal");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::in_freq( int voice ){
+    return ch( voice ).in("freq");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::in_reso( int voice ){
+    return ch( voice ).in("reso");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_lpf4( int voice ){
+    return ch( voice ).out("lpf4");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_lpf2( int voice ){
+    return ch( voice ).out("lpf2");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_bpf4( int voice ){
+    return ch( voice ).out("bpf4");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_bpf2( int voice ){
+    return ch( voice ).out("bpf2");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_hpf4( int voice ){
+    return ch( voice ).out("hpf4");
+}
+
+pdsp::Patchable& pdsp::MultiLadder4Bank::out_hpf2( int voice ){
+    return ch( voice ).out("hpf2");
+}
+
+
+void pdsp::MultiLadder4Bank::prepareUnit( int expectedBufferSize, double sampleRate ){
+
+        for( int v=0; v<voices; ++v ){
+            z1_1[v] = 0.0f;
+            z1_2[v] = 0.0f;
+            z1_3[v] = 0.0f;
+            z1_4[v] = 0.0f;
+        }
+
+        halfT = 0.5/ sampleRate;
+        twoSlashT = 1.0 / halfT;
+
+        for( int v=0; v<voices; ++v ){
+            coefficientCalculation( v, 0.0f, 0.0f );
+        }
+
+        allocateLanes( signalLanes, expectedBufferSize );
+        allocateLanes( waLanes, expectedBufferSize );
+        allocateLanes( resoLanes, expectedBufferSize );
+        allocateLanes( lpf4Lanes, expectedBufferSize );
+        allocateLanes( lpf2Lanes, expectedBufferSize );
+        allocateLanes( bpf4Lanes, expectedBufferSize );
+        allocateLanes( bpf2Lanes, expectedBufferSize );
+        allocateLanes( hpf4Lanes, expectedBufferSize );
+        allocateLanes( hpf2Lanes, expectedBufferSize );
+
+        if( warped != nullptr ){
+            ofx_deallocate_aligned( warped );
+        }
+        ofx_allocate_aligned( warped, ( expectedBufferSize * PDSP_BUFFERS_EXTRA_DIM ) / ( PDSP_BUFFERS_EXTRA_DIM-1 ) );
+}
+
+void pdsp::MultiLadder4Bank::releaseResources(){
+        ofx_deallocate_aligned( signalLanes );
+        ofx_deallocate_aligned( waLanes );
+        ofx_deallocate_aligned( resoLanes );
+        ofx_deallocate_aligned( lpf4Lanes );
+        ofx_deallocate_aligned( lpf2Lanes );
+        ofx_deallocate_aligned( bpf4Lanes );
+        ofx_deallocate_aligned( bpf2Lanes );
+        ofx_deallocate_aligned( hpf4Lanes );
+        ofx_deallocate_aligned( hpf2Lanes );
+        ofx_deallocate_aligned( warped );
+}
+
+void pdsp::MultiLadder4Bank::coefficientCalculation( int voice, float wa, float K ){
+        // same as MultiLadder4
+        float g = wa * halfT;
+        alpha[voice] = g / (1.0f + g);
+        beta4[voice] = 1.0f / (1.0f + g);
+        beta3[voice] = beta4[voice] * alpha[voice];
+        beta2[voice] = beta3[voice] * alpha[voice];
+        beta1[voice] = beta2[voice] * alpha[voice];
+        float gamma = alpha[voice] * alpha[voice] * alpha[voice] * alpha[voice];
+        this->K[voice] = K;
+        alpha0[voice] = 1.0f / ( 1.0f  + (gamma*K*4.0f) );
+}
+
+
+void pdsp::MultiLadder4Bank::process( int bufferSize ) noexcept {
+
+        bool anyActive = false;
+        bool coefficientsAR = false;
+
+        for( int v=0; v<voices; ++v ){
+            int signalState;
+            const float* signalBuffer = processInput(input_signal[v], signalState);
+            active[v] = ( signalState == AudioRate );
+
+            if( active[v] ){
+                anyActive = true;
+                interleave( signalLanes, v, signalBuffer, signalState, bufferSize );
+
+                int cutoffState;
+                processInput(input_cutoff[v], cutoffState);
+                int resoState;
+                processInput(input_reso[v], resoState);
+                if( cutoffState==AudioRate || resoState==AudioRate ){
+                    coefficientsAR = true;
+                }
+            }else{
+                interleaveZero( signalLanes, v, bufferSize );
+            }
+        }
+
+        if( ! anyActive ){
+            for( int v=0; v<voices; ++v ){
+                setOutputToZero(output_lpf4[v]);
+                setOutputToZero(output_lpf2[v]);
+                setOutputToZero(output_bpf4[v]);
+                setOutputToZero(output_bpf2[v]);
+                setOutputToZero(output_hpf4[v]);
+                setOutputToZero(output_hpf2[v]);
+            }
+            return;
+        }
+
+        if( coefficientsAR ){
+            // the coefficients are calculated in the lanes for each sample
+            for( int v=0; v<voices; ++v ){
+                if( active[v] ){
+                    const float* cutoffBuffer = input_cutoff[v].getBuffer();
+                    if( input_cutoff[v].getState() == AudioRate ){
+                        vect_warpCutoff(warped, cutoffBuffer, halfT, twoSlashT, bufferSize);
+                        interleave( waLanes, v, warped, AudioRate, bufferSize );
+                    }else{
+                        float wa;
+                        vect_warpCutoff(&wa, cutoffBuffer, halfT, twoSlashT, 1);
+                        interleave( waLanes, v, &wa, Changed, bufferSize );
+                    }
+                    interleave( resoLanes, v, input_reso[v].getBuffer(), input_reso[v].getState(), bufferSize );
+                }else{
+                    interleaveZero( waLanes, v, bufferSize );
+                    interleaveZero( resoLanes, v, bufferSize );
+                }
+            }
+            process_audio<true>( bufferSize );
+        }else{
+            for( int v=0; v<voices; ++v ){
+                if( active[v] ){
+                    float wa;
+                    vect_warpCutoff(&wa, input_cutoff[v].getBuffer(), halfT, twoSlashT, 1);
+                    coefficientCalculation( v, wa, input_reso[v].getBuffer()[0] * 4.0f );
+                }
+            }
+            process_audio<false>( bufferSize );
+        }
+}
+
+
+template<bool coefficientsAR>
+void pdsp::MultiLadder4Bank::process_audio( int bufferSize ) noexcept {
+
+        const ofx::f128 one = ofx::m_set1( 1.0f );
+
+        for( int g=0; g<groups; ++g ){
+                const int lane = g*4;
+
+                ofx::f128 a   = ofx::m_load( alpha + lane );
+                ofx::f128 a0  = ofx::m_load( alpha0 + lane );
+                ofx::f128 b1  = ofx::m_load( beta1 + lane );
+                ofx::f128 b2  = ofx::m_load( beta2 + lane );
+                ofx::f128 b3  = ofx::m_load( beta3 + lane );
+                ofx::f128 b4  = ofx::m_load( beta4 + lane );
+                ofx::f128 k   = ofx::m_load( K + lane );
+
+                ofx::f128 s1  = ofx::m_load( z1_1 + lane );
+                ofx::f128 s2  = ofx::m_load( z1_2 + lane );
+                ofx::f128 s3  = ofx::m_load( z1_3 + lane );
+                ofx::f128 s4  = ofx::m_load( z1_4 + lane );
+
+                for( int n=0; n<bufferSize; ++n ){
+                        const int i = n*voices + lane;
+
+                        if( coefficientsAR ){
+                                ofx::f128 gc = ofx::m_mul1( ofx::m_load( waLanes + i ), halfT );
+                                b4 = ofx::m_div( one, ofx::m_add1( gc, 1.0f ) );
+                                a  = ofx::m_mul( gc, b4 );
+                                b3 = ofx::m_mul( b4, a );
+                                b2 = ofx::m_mul( b3, a );
+                                b1 = ofx::m_mul( b2, a );
+                                ofx::f128 gamma = ofx::m_mul( a, a );
+                                gamma = ofx::m_mul( gamma, gamma );
+                                k  = ofx::m_mul1( ofx::m_load( resoLanes + i ), 4.0f );
+                                a0 = ofx::m_div( one, ofx::m_add1( ofx::m_mul( ofx::m_mul1( gamma, 4.0f ), k ), 1.0f ) );
+                        }
+
+                        //input with feedback
+                        ofx::f128 sigma = ofx::m_add( ofx::m_add( ofx::m_mul( s1, b1 ), ofx::m_mul( s2, b2 ) ),
+                                                      ofx::m_add( ofx::m_mul( s3, b3 ), ofx::m_mul( s4, b4 ) ) );
+                        ofx::f128 u = ofx::m_mul( ofx::m_sub( ofx::m_load( signalLanes + i ), ofx::m_mul( k, sigma ) ), a0 );
+
+                        //first stage
+                        ofx::f128 vn = ofx::m_mul( ofx::m_sub( u, s1 ), a );
+                        ofx::f128 lpf1 = ofx::m_add( vn, s1 );
+                        s1 = ofx::m_add( vn, lpf1 );
+                        //second stage
+                        vn = ofx::m_mul( ofx::m_sub( lpf1, s2 ), a );
+                        ofx::f128 lpf2 = ofx::m_add( vn, s2 );
+                        s2 = ofx::m_add( vn, lpf2 );
+                        //third stage
+                        vn = ofx::m_mul( ofx::m_sub( lpf2, s3 ), a );
+                        ofx::f128 lpf3 = ofx::m_add( vn, s3 );
+                        s3 = ofx::m_add( vn, lpf3 );
+                        //fourth stage
+                        vn = ofx::m_mul( ofx::m_sub( lpf3, s4 ), a );
+                        ofx::f128 lpf4 = ofx::m_add( vn, s4 );
+                        s4 = ofx::m_add( vn, lpf4 );
+
+                        ofx::m_store( lpf2Lanes + i, lpf2 );
+                        ofx::m_store( lpf4Lanes + i, lpf4 );
+                        // lpf1 * 2 - lpf2 * 2
+                        ofx::m_store( bpf2Lanes + i, ofx::m_mul1( ofx::m_sub( lpf1, lpf2 ), 2.0f ) );
+                        // lpf2 * 4 - lpf3 * 8 + lpf4 * 4
+                        ofx::m_store( bpf4Lanes + i, ofx::m_mul1( ofx::m_add( ofx::m_sub( lpf2, ofx::m_add( lpf3, lpf3 ) ), lpf4 ), 4.0f ) );
+                        // u - lpf1 * 2 + lpf2
+                        ofx::m_store( hpf2Lanes + i, ofx::m_add( ofx::m_sub( u, ofx::m_add( lpf1, lpf1 ) ), lpf2 ) );
+                        // u - lpf1 * 4 + lpf2 * 6 - lpf3 * 4 + lpf4
+                        ofx::m_store( hpf4Lanes + i, ofx::m_add( ofx::m_add( u, lpf4 ),
+                                                                 ofx::m_add( ofx::m_mul1( ofx::m_add( lpf1, lpf3 ), -4.0f ), ofx::m_mul1( lpf2, 6.0f ) ) ) );
+                }
+
+                ofx::m_store( z1_1 + lane, s1 );
+                ofx::m_store( z1_2 + lane, s2 );
+                ofx::m_store( z1_3 + lane, s3 );
+                ofx::m_store( z1_4 + lane, s4 );
+        }
+
+        outputLanes( output_lpf4, lpf4Lanes, bufferSize );
+        outputLanes( output_lpf2, lpf2Lanes, bufferSize );
+        outputLanes( output_bpf4, bpf4Lanes, bufferSize );
+        outputLanes( output_bpf2, bpf2Lanes, bufferSize );
+        outputLanes( output_hpf4, hpf4Lanes, bufferSize );
+        outputLanes( output_hpf2, hpf2Lanes, bufferSize );
+}
+
+void pdsp::MultiLadder4Bank::outputLanes( std::vector<OutputNode> & outputs, const float* lanes, int bufferSize ) noexcept {
+        for( int v=0; v<voices; ++v ){
+            if( active[v] && outputs[v].isConnected() ){
+                deinterleave( getOutputBufferToFill(outputs[v]), lanes, v, bufferSize );
+            }else{
+                setOutputToZero(outputs[v]);
+            }
+        }
+}
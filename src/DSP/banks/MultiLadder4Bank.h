@@ -0,0 +1,140 @@
+
+// MultiLadder4Bank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_MULTILADDER4BANK_H_INCLUDED
+#define PDSP_BANKS_MULTILADDER4BANK_H_INCLUDED
+
+#include "VoiceBank.h"
+
+namespace pdsp {
+    /*!
+    @brief Many voices of the MultiLadder4 filter, processed together.
+
+    This is the same 4 pole Multimode Ladder Filter of MultiLadder4, but it runs many voices at once, one for each SIMD lane, so the per-sample feedback of the ladder is calculated for 4 voices with each operation. Each voice has the same inputs and outputs of MultiLadder4, select them with ch( voice ) or with the methods that take the voice index. A voice with its "signal" input not running at audio rate outputs silence.
+    */
+class MultiLadder4Bank :  public Unit, public VoiceBank
+{
+public:
+
+    /*!
+    @brief constructs the bank
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    */
+    MultiLadder4Bank( int voices = 8 );
+    ~MultiLadder4Bank();
+
+    /*!
+    @brief Sets "signal" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. This input is the signal to filter.
+    @param[in] voice voice index
+    */
+    Patchable& in_signal( int voice );
+
+    /*!
+    @brief Sets "freq" of the given voice as selected input and returns it ready to be patched. This is the cutoff frequency in hertz.
+    @param[in] voice voice index
+    */
+    Patchable& in_freq( int voice );
+
+    /*!
+    @brief Sets "reso" of the given voice as selected input and returns it ready to be patched. This is the resonance of the filter.
+    @param[in] voice voice index
+    */
+    Patchable& in_reso( int voice );
+
+    /*!
+    @brief Sets "lpf4" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice. This is the 4 pole low pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_lpf4( int voice );
+
+    /*!
+    @brief Sets "lpf2" of the given voice as selected output and returns it ready to be patched. This is the 2 pole low pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_lpf2( int voice );
+
+    /*!
+    @brief Sets "bpf4" of the given voice as selected output and returns it ready to be patched. This is the 4 pole band pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_bpf4( int voice );
+
+    /*!
+    @brief Sets "bpf2" of the given voice as selected output and returns it ready to be patched. This is the 2 pole band pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_bpf2( int voice );
+
+    /*!
+    @brief Sets "hpf4" of the given voice as selected output and returns it ready to be patched. This is the 4 pole high pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_hpf4( int voice );
+
+    /*!
+    @brief Sets "hpf2" of the given voice as selected output and returns it ready to be patched. This is the 2 pole high pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_hpf2( int voice );
+
+private:
+    void process(int bufferSize) noexcept override ;
+    void prepareUnit( int expectedBufferSize, double sampleRate ) override;
+    void releaseResources() override ;
+
+    template<bool coefficientsAR>
+    void process_audio( int bufferSize ) noexcept;
+
+    void coefficientCalculation( int voice, float wa, float K );
+    void outputLanes( std::vector<OutputNode> & outputs, const float* lanes, int bufferSize ) noexcept;
+
+    std::vector<InputNode> input_signal;
+    std::vector<InputNode> input_cutoff;
+    std::vector<InputNode> input_reso;
+
+    std::vector<OutputNode> output_lpf4;
+    std::vector<OutputNode> output_lpf2;
+    std::vector<OutputNode> output_bpf4;
+    std::vector<OutputNode> output_bpf2;
+    std::vector<OutputNode> output_hpf4;
+    std::vector<OutputNode> output_hpf2;
+
+    std::vector<int> active;
+
+    // one value for each voice, aligned for the vector loads
+    float* values;
+    float* alpha;
+    float* alpha0;
+    float* beta1;
+    float* beta2;
+    float* beta3;
+    float* beta4;
+    float* K;
+    float* z1_1;
+    float* z1_2;
+    float* z1_3;
+    float* z1_4;
+
+    float* signalLanes;
+    float* waLanes;
+    float* resoLanes;
+    float* lpf4Lanes;
+    float* lpf2Lanes;
+    float* bpf4Lanes;
+    float* bpf2Lanes;
+    float* hpf4Lanes;
+    float* hpf2Lanes;
+    float* warped;
+
+    float halfT;
+    float twoSlashT;
+
+};
+
+}//END NAMESPACE
+
+
+#endif  // PDSP_BANKS_MULTILADDER4BANK_H_INCLUDED
@@ -0,0 +1,148 @@
+
+#include "PMPhasorBank.h"
+
+pdsp::PMPhasorBank::PMPhasorBank( int voices ) : VoiceBank( voices ),
+    input_freq( this->voices ), input_phase_mod( this->voices ),
+    output_phase( this->voices ), output_inc( this->voices ){
+
+    for( int v=0; v<this->voices; ++v ){
+        addInput( voiceTag( "freq", v ), input_freq[v] );
+        addInput( voiceTag( "pm", v ), input_phase_mod[v] );
+        addOutput( voiceTag( "phase", v ), output_phase[v] );
+        addOutput( voiceTag( "inc", v ), output_inc[v] );
+
+        voicePatchables[v].addVoiceInput( "freq", input_freq[v] );
+        voicePatchables[v].addVoiceInput( "pm", input_phase_mod[v] );
+        voicePatchables[v].addVoiceOutput( "phase", output_phase[v] );
+        voicePatchables[v].addVoiceOutput( "inc", output_inc[v] );
+
+        input_freq[v].setDefaultValue(440.0f);
+        input_phase_mod[v].setDefaultValue(0.0f);
+    }
+    updateOutputNodes();
+
+    values = nullptr;
+    ofx_allocate_aligned( values, this->voices * 2 );
+    phase = values;
+    inc   = values + this->voices;
+
+    incLanes = nullptr;
+    phaseLanes = nullptr;
+
+    if(dynamicConstruction){
+        prepareToPlay(globalBufferSize, globalSampleRate);
+    }
+}
+
+pdsp::PMPhasorBank::~PMPhasorBank(){
+    releaseResources();
+    ofx_deallocate_aligned( values );
+}
+
+pdsp::Patchable& pdsp::PMPhasorBank::in_freq( int voice ){
+    return ch( voice ).in("freq");
+}
+
+pdsp::Patchable& pdsp::PMPhasorBank::in_pm( int voice ){
+    return ch( voice ).in("pm");
+}
+
+pdsp::Patchable& pdsp::PMPhasorBank::out_phase( int voice ){
+    return ch( voice ).out("phase");
+}
+
+pdsp::Patchable& pdsp::PMPhasorBank::out_inc( int voice ){
+    return ch( voice ).out("inc");
+}
+
+void pdsp::PMPhasorBank::prepareUnit( int expectedBufferSize, double sampleRate) {
+    for( int v=0; v<voices; ++v ){
+        phase[v] = 0.0f;
+        inc[v] = 0.0f;
+    }
+    incCalculationMultiplier = 1.0f / sampleRate;
+
+    allocateLanes( incLanes, expectedBufferSize );
+    allocateLanes( phaseLanes, expectedBufferSize );
+}
+
+void pdsp::PMPhasorBank::releaseResources () {
+    ofx_deallocate_aligned( incLanes );
+    ofx_deallocate_aligned( phaseLanes );
+}
+
+void pdsp::PMPhasorBank::process (int bufferSize) noexcept {
+
+    bool pitchAR = false;
+
+    for( int v=0; v<voices; ++v ){
+        int freqBufferState;
+        const float* freqBuffer = processInput(input_freq[v], freqBufferState);
+        if( freqBufferState == AudioRate ){
+            pitchAR = true;
+        }else{
+            inc[v] = freqBuffer[0] * incCalculationMultiplier;
+            setControlRateOutput(output_inc[v], inc[v]);
+        }
+    }
+
+    if( pitchAR ){
+        for( int v=0; v<voices; ++v ){
+            if( input_freq[v].getState() == AudioRate ){
+                interleave( incLanes, v, input_freq[v].getBuffer(), AudioRate, bufferSize );
+            }else{
+                // the lanes are multiplied by incCalculationMultiplier in process_audio()
+                interleave( incLanes, v, input_freq[v].getBuffer(), Changed, bufferSize );
+            }
+        }
+        process_audio<true>( bufferSize );
+    }else{
+        process_audio<false>( bufferSize );
+    }
+
+    for( int v=0; v<voices; ++v ){
+        float* outputBuffer = getOutputBufferToFill(output_phase[v]);
+        deinterleave( outputBuffer, phaseLanes, v, bufferSize );
+
+        int phaseModState;
+        const float* phaseModBuffer = processInput(input_phase_mod[v], phaseModState);
+        if( phaseModState == AudioRate ){
+            vect_phazorShiftB(outputBuffer, phaseModBuffer, bufferSize);
+        }
+
+        if( input_freq[v].getState() == AudioRate ){
+            deinterleave( getOutputBufferToFill(output_inc[v]), incLanes, v, bufferSize );
+        }
+    }
+}
+
+template<bool pitchAR>
+void pdsp::PMPhasorBank::process_audio( int bufferSize ) noexcept {
+
+    for( int g=0; g<groups; ++g ){
+        const int lane = g*4;
+
+        ofx::f128 p = ofx::m_load( phase + lane );
+        ofx::f128 i = ofx::m_load( inc + lane );
+
+        for( int n=0; n<bufferSize; ++n ){
+            const int index = n*voices + lane;
+
+            if( pitchAR ){
+                i = ofx::m_mul1( ofx::m_load( incLanes + index ), incCalculationMultiplier );
+                ofx::m_store( incLanes + index, i );
+            }
+
+            // as PMPhasor the phase is wrapped only after 1.0f, FM can make really big increments
+            ofx::f128 wrap = ofx::m_cmp1_ge( p, 1.0f );
+            p = ofx::m_sub( p, ofx::m_and( wrap, ofx::m_floor( p ) ) );
+
+            ofx::m_store( phaseLanes + index, p );
+
+            p = ofx::m_add( p, i );
+        }
+
+        ofx::m_store( phase + lane, p );
+        ofx::m_store( inc + lane, i );
+    }
+}
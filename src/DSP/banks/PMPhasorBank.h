@@ -0,0 +1,78 @@
+
+// PMPhasorBank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_PMPHASORBANK_H_INCLUDED
+#define PDSP_BANKS_PMPHASORBANK_H_INCLUDED
+
+#include "VoiceBank.h"
+
+namespace pdsp{
+    /*!
+    @brief Many voices of the PMPhasor phazor, processed together.
+
+    This is the phazor of PMPhasor running many voices at once, one for each SIMD lane. Each voice has the "freq" and "pm" inputs and the "phase" and "inc" outputs of PMPhasor, select them with ch( voice ) or with the methods that take the voice index. The sync input and output are not available in the bank.
+    */
+class PMPhasorBank :  public Unit, public VoiceBank {
+
+public:
+    /*!
+    @brief constructs the bank
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    */
+    PMPhasorBank( int voices = 8 );
+    ~PMPhasorBank();
+
+    /*!
+    @brief Sets "freq" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. This is the frequency of the phazor in hertz.
+    @param[in] voice voice index
+    */
+    Patchable& in_freq( int voice );
+
+    /*!
+    @brief Sets "pm" of the given voice as selected input and returns it ready to be patched. This is the phase modulation input.
+    @param[in] voice voice index
+    */
+    Patchable& in_pm( int voice );
+
+    /*!
+    @brief Sets "phase" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice. This is the phase output to be patched into an oscillator in_phase().
+    @param[in] voice voice index
+    */
+    Patchable& out_phase( int voice );
+
+    /*!
+    @brief Sets "inc" of the given voice as selected output and returns it ready to be patched. This is the phase increment, you patch it to the in_inc() input of the antialiased oscillators.
+    @param[in] voice voice index
+    */
+    Patchable& out_inc( int voice );
+
+private:
+    void prepareUnit( int expectedBufferSize, double sampleRate) override;
+    void releaseResources () override;
+    void process (int bufferSize) noexcept override ;
+
+    template<bool pitchAR>
+    void process_audio( int bufferSize ) noexcept;
+
+    std::vector<InputNode>  input_freq;
+    std::vector<InputNode>  input_phase_mod;
+    std::vector<OutputNode> output_phase;
+    std::vector<OutputNode> output_inc;
+
+    // one value for each voice, aligned for the vector loads
+    float* values;
+    float* phase;
+    float* inc;
+
+    float* incLanes;
+    float* phaseLanes;
+
+    float incCalculationMultiplier;
+};
+
+}//END NAMESPACE
+
+#endif  // PDSP_BANKS_PMPHASORBANK_H_INCLUDED
@@ -0,0 +1,269 @@
+
+#include "SVF2Bank.h"
+
+pdsp::SVF2Bank::SVF2Bank( int voices ) : VoiceBank( voices ),
+    input_signal( this->voices ), input_cutoff( this->voices ), input_reso( this->voices ),
+    output_lpf( this->voices ), output_hpf( this->voices ), output_bpf( this->voices ), output_bsf( this->voices ),
+    active( this->voices, 0 ){
+
+        for( int v=0; v<this->voices; ++v ){
+            addInput( voiceTag( "signal", v ), input_signal[v] );
+            addInput( voiceTag( "freq", v ), input_cutoff[v] );
+            addInput( voiceTag( "reso", v ), input_reso[v] );
+            addOutput( voiceTag( "lpf", v ), output_lpf[v] );
+            addOutput( voiceTag( "hpf", v ), output_hpf[v] );
+            addOutput( voiceTag( "bpf", v ), output_bpf[v] );
+            addOutput( voiceTag( "notch", v ), output_bsf[v] );
+
+            voicePatchables[v].addVoiceInput( "signal", input_signal[v] );
+            voicePatchables[v].addVoiceInput( "freq", input_cutoff[v] );
+            voicePatchables[v].addVoiceInput( "reso", input_reso[v] );
+            voicePatchables[v].addVoiceOutput( "lpf", output_lpf[v] );
+            voicePatchables[v].addVoiceOutput( "hpf", output_hpf[v] );
+            voicePatchables[v].addVoiceOutput( "bpf", output_bpf[v] );
+            voicePatchables[v].addVoiceOutput( "notch", output_bsf[v] );
+
+            input_cutoff[v].enableBoundaries( 20.0f, 20000.0f);
+            input_cutoff[v].setDefaultValue(8000.0f);
+            input_reso[v].setDefaultValue(0.0f);
+            input_reso[v].enableBoundaries( 0.0f, 1.0f);
+        }
+        updateOutputNodes();
+
+        values = nullptr;
+        ofx_allocate_aligned( values, this->voices * 6 );
+        alpha  = values;
+        alpha0 = values + this->voices;
+        rho    = values + this->voices * 2;
+        twoR   = values + this->voices * 3;
+        z1_1   = values + this->voices * 4;
+        z1_2   = values + this->voices * 5;
+
+        signalLanes = nullptr;
+        waLanes = nullptr;
+        resoLanes = nullptr;
+        lpfLanes = nullptr;
+        hpfLanes = nullptr;
+        bpfLanes = nullptr;
+        bsfLanes = nullptr;
+        warped = nullptr;
+
+        if(dynamicConstruction){
+                prepareToPlay(globalBufferSize, globalSampleRate);
+        }
+}
+
+pdsp::SVF2Bank::~SVF2Bank(){
+    releaseResources();
+    ofx_deallocate_aligned( values );
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::in_signal( int voice ){
+    return ch( voice ).in("signal");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::in_freq( int voice ){
+    return ch( voice ).in("freq");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::in_reso( int voice ){
+    return ch( voice ).in("reso");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::out_lpf( int voice ){
+    return ch( voice ).out("lpf");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::out_hpf( int voice ){
+    return ch( voice ).out("hpf");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::out_bpf( int voice ){
+    return ch( voice ).out("bpf");
+}
+
+pdsp::Patchable& pdsp::SVF2Bank::out_notch( int voice ){
+    return ch( voice ).out("notch");
+}
+
+
+void pdsp::SVF2Bank::prepareUnit( int expectedBufferSize, double sampleRate ){
+
+        halfT =  0.5f / sampleRate ;
+        twoSlashT = 1.0f / halfT;
+
+        for( int v=0; v<voices; ++v ){
+            z1_1[v] = 0.0f;
+            z1_2[v] = 0.0f;
+            coefficientCalculation( v, 0.0f, 0.0f );
+        }
+
+        allocateLanes( signalLanes, expectedBufferSize );
+        allocateLanes( waLanes, expectedBufferSize );
+        allocateLanes( resoLanes, expectedBufferSize );
+        allocateLanes( lpfLanes, expectedBufferSize );
+        allocateLanes( hpfLanes, expectedBufferSize );
+        allocateLanes( bpfLanes, expectedBufferSize );
+        allocateLanes( bsfLanes, expectedBufferSize );
+
+        if( warped != nullptr ){
+            ofx_deallocate_aligned( warped );
+        }
+        ofx_allocate_aligned( warped, ( expectedBufferSize * PDSP_BUFFERS_EXTRA_DIM ) / ( PDSP_BUFFERS_EXTRA_DIM-1 ) );
+}
+
+void pdsp::SVF2Bank::releaseResources(){
+        ofx_deallocate_aligned( signalLanes );
+        ofx_deallocate_aligned( waLanes );
+        ofx_deallocate_aligned( resoLanes );
+        ofx_deallocate_aligned( lpfLanes );
+        ofx_deallocate_aligned( hpfLanes );
+        ofx_deallocate_aligned( bpfLanes );
+        ofx_deallocate_aligned( bsfLanes );
+        ofx_deallocate_aligned( warped );
+}
+
+void pdsp::SVF2Bank::coefficientCalculation( int voice, float wa, float reso ){
+        // same as SVF2
+        float g = wa * halfT;
+        float Q = reso*24.5f + 0.5f;
+        float R = 1.0f/(2.0f*Q);
+        alpha0[voice] = 1.0f/(1.0f + 2.0f*R*g + g*g);
+        alpha[voice] = g;
+        rho[voice] = 2.0f*R + g;
+        twoR[voice] = 2.0f*R;
+}
+
+
+void pdsp::SVF2Bank::process( int bufferSize ) noexcept {
+
+        bool anyActive = false;
+        bool coefficientsAR = false;
+
+        for( int v=0; v<voices; ++v ){
+            int signalState;
+            const float* signalBuffer = processInput(input_signal[v], signalState);
+            active[v] = ( signalState == AudioRate );
+
+            if( active[v] ){
+                anyActive = true;
+                interleave( signalLanes, v, signalBuffer, signalState, bufferSize );
+
+                int cutoffState;
+                processInput(input_cutoff[v], cutoffState);
+                int resoState;
+                processInput(input_reso[v], resoState);
+                if( cutoffState==AudioRate || resoState==AudioRate ){
+                    coefficientsAR = true;
+                }
+            }else{
+                interleaveZero( signalLanes, v, bufferSize );
+            }
+        }
+
+        if( ! anyActive ){
+            for( int v=0; v<voices; ++v ){
+                setOutputToZero(output_lpf[v]);
+                setOutputToZero(output_hpf[v]);
+                setOutputToZero(output_bpf[v]);
+                setOutputToZero(output_bsf[v]);
+            }
+            return;
+        }
+
+        if( coefficientsAR ){
+            // the coefficients are calculated in the lanes for each sample
+            for( int v=0; v<voices; ++v ){
+                if( active[v] ){
+                    const float* cutoffBuffer = input_cutoff[v].getBuffer();
+                    if( input_cutoff[v].getState() == AudioRate ){
+                        vect_warpCutoff(warped, cutoffBuffer, halfT, twoSlashT, bufferSize);
+                        interleave( waLanes, v, warped, AudioRate, bufferSize );
+                    }else{
+                        float wa;
+                        vect_warpCutoff(&wa, cutoffBuffer, halfT, twoSlashT, 1);
+                        interleave( waLanes, v, &wa, Changed, bufferSize );
+                    }
+                    interleave( resoLanes, v, input_reso[v].getBuffer(), input_reso[v].getState(), bufferSize );
+                }else{
+                    interleaveZero( waLanes, v, bufferSize );
+                    interleaveZero( resoLanes, v, bufferSize );
+                }
+            }
+            process_audio<true>( bufferSize );
+        }else{
+            for( int v=0; v<voices; ++v ){
+                if( active[v] ){
+                    float wa;
+                    vect_warpCutoff(&wa, input_cutoff[v].getBuffer(), halfT, twoSlashT, 1);
+                    coefficientCalculation( v, wa, input_reso[v].getBuffer()[0] );
+                }
+            }
+            process_audio<false>( bufferSize );
+        }
+}
+
+
+template<bool coefficientsAR>
+void pdsp::SVF2Bank::process_audio( int bufferSize ) noexcept {
+
+        const ofx::f128 one = ofx::m_set1( 1.0f );
+
+        for( int g=0; g<groups; ++g ){
+                const int lane = g*4;
+
+                ofx::f128 a   = ofx::m_load( alpha + lane );
+                ofx::f128 a0  = ofx::m_load( alpha0 + lane );
+                ofx::f128 r   = ofx::m_load( rho + lane );
+                ofx::f128 r2  = ofx::m_load( twoR + lane );
+
+                ofx::f128 s1  = ofx::m_load( z1_1 + lane );
+                ofx::f128 s2  = ofx::m_load( z1_2 + lane );
+
+                for( int n=0; n<bufferSize; ++n ){
+                        const int i = n*voices + lane;
+
+                        if( coefficientsAR ){
+                                a = ofx::m_mul1( ofx::m_load( waLanes + i ), halfT );
+                                ofx::f128 Q = ofx::m_add1( ofx::m_mul1( ofx::m_load( resoLanes + i ), 24.5f ), 0.5f );
+                                r2 = ofx::m_div( one, Q );
+                                // 1 + 2Rg + g^2
+                                a0 = ofx::m_div( one, ofx::m_add1( ofx::m_mul( a, ofx::m_add( r2, a ) ), 1.0f ) );
+                                r = ofx::m_add( r2, a );
+                        }
+
+                        ofx::f128 x = ofx::m_load( signalLanes + i );
+
+                        ofx::f128 hpf = ofx::m_mul( a0, ofx::m_sub( ofx::m_sub( x, ofx::m_mul( r, s1 ) ), s2 ) );
+                        ofx::f128 bpf = ofx::m_add( ofx::m_mul( a, hpf ), s1 );
+                        ofx::f128 lpf = ofx::m_add( ofx::m_mul( a, bpf ), s2 );
+                        ofx::f128 bsf = ofx::m_sub( x, ofx::m_mul( r2, bpf ) );
+
+                        s1 = ofx::m_add( ofx::m_mul( a, hpf ), bpf );
+                        s2 = ofx::m_add( ofx::m_mul( a, bpf ), lpf );
+
+                        ofx::m_store( hpfLanes + i, hpf );
+                        ofx::m_store( bpfLanes + i, bpf );
+                        ofx::m_store( lpfLanes + i, lpf );
+                        ofx::m_store( bsfLanes + i, bsf );
+                }
+
+                ofx::m_store( z1_1 + lane, s1 );
+                ofx::m_store( z1_2 + lane, s2 );
+        }
+
+        outputLanes( output_lpf, lpfLanes, bufferSize );
+        outputLanes( output_hpf, hpfLanes, bufferSize );
+        outputLanes( output_bpf, bpfLanes, bufferSize );
+        outputLanes( output_bsf, bsfLanes, bufferSize );
+}
+
+void pdsp::SVF2Bank::outputLanes( std::vector<OutputNode> & outputs, const float* lanes, int bufferSize ) noexcept {
+        for( int v=0; v<voices; ++v ){
+            if( active[v] && outputs[v].isConnected() ){
+                deinterleave( getOutputBufferToFill(outputs[v]), lanes, v, bufferSize );
+            }else{
+                setOutputToZero(outputs[v]);
+            }
+        }
+}
@@ -0,0 +1,119 @@
+
+// SVF2Bank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+
+#ifndef PDSP_BANKS_SVF2BANK_H_INCLUDED
+#define PDSP_BANKS_SVF2BANK_H_INCLUDED
+
+#include "VoiceBank.h"
+
+namespace pdsp {
+    /*!
+    @brief Many voices of the SVF2 filter, processed together.
+
+    This is the same 2 pole State Variable Filter of SVF2, but it runs many voices at once, one for each SIMD lane, so the per-sample feedback of the filter is calculated for 4 voices with each operation. Each voice has the same inputs and outputs of SVF2, select them with ch( voice ) or with the methods that take the voice index. A voice with its "signal" input not running at audio rate outputs silence.
+    */
+class SVF2Bank :  public Unit, public VoiceBank
+{
+public:
+
+    /*!
+    @brief constructs the bank
+    @param[in] voices number of voices, rounded up to a multiple of 4
+    */
+    SVF2Bank( int voices = 8 );
+    ~SVF2Bank();
+
+    /*!
+    @brief Sets "signal" of the given voice as selected input and returns it ready to be patched. This is the default input of each voice. This input is the signal to filter.
+    @param[in] voice voice index
+    */
+    Patchable& in_signal( int voice );
+
+    /*!
+    @brief Sets "freq" of the given voice as selected input and returns it ready to be patched. This is the cutoff frequency in hertz.
+    @param[in] voice voice index
+    */
+    Patchable& in_freq( int voice );
+
+    /*!
+    @brief Sets "reso" of the given voice as selected input and returns it ready to be patched. This is the resonance of the filter.
+    @param[in] voice voice index
+    */
+    Patchable& in_reso( int voice );
+
+    /*!
+    @brief Sets "lpf" of the given voice as selected output and returns it ready to be patched. This is the default output of each voice. This is the low pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_lpf( int voice );
+
+    /*!
+    @brief Sets "hpf" of the given voice as selected output and returns it ready to be patched. This is the high pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_hpf( int voice );
+
+    /*!
+    @brief Sets "bpf" of the given voice as selected output and returns it ready to be patched. This is the band pass output.
+    @param[in] voice voice index
+    */
+    Patchable& out_bpf( int voice );
+
+    /*!
+    @brief Sets "notch" of the given voice as selected output and returns it ready to be patched. This is the band reject output.
+    @param[in] voice voice index
+    */
+    Patchable& out_notch( int voice );
+
+private:
+    void process(int bufferSize) noexcept override ;
+    void prepareUnit( int expectedBufferSize, double sampleRate ) override;
+    void releaseResources() override ;
+
+    template<bool coefficientsAR>
+    void process_audio( int bufferSize ) noexcept;
+
+    void coefficientCalculation( int voice, float wa, float reso );
+    void outputLanes( std::vector<OutputNode> & outputs, const float* lanes, int bufferSize ) noexcept;
+
+    std::vector<InputNode> input_signal;
+    std::vector<InputNode> input_cutoff;
+    std::vector<InputNode> input_reso;
+
+    std::vector<OutputNode> output_lpf;
+    std::vector<OutputNode> output_hpf;
+    std::vector<OutputNode> output_bpf;
+    std::vector<OutputNode> output_bsf;
+
+    std::vector<int> active;
+
+    // one value for each voice, aligned for the vector loads
+    float* values;
+    float* alpha;
+    float* alpha0;
+    float* rho;
+    float* twoR;
+    float* z1_1;
+    float* z1_2;
+
+    float* signalLanes;
+    float* waLanes;
+    float* resoLanes;
+    float* lpfLanes;
+    float* hpfLanes;
+    float* bpfLanes;
+    float* bsfLanes;
+    float* warped;
+
+    float halfT;
+    float twoSlashT;
+
+};
+
+}//END NAMESPACE
+
+
+#endif  // PDSP_BANKS_SVF2BANK_H_INCLUDED
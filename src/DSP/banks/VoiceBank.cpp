@@ -0,0 +1,78 @@
+
+#include "VoiceBank.h"
+#include <set>
+#include <string>
+
+pdsp::VoiceBank::VoiceBank( int voices ){
+    if( voices < 4 ){ voices = 4; }
+    this->voices = ( ( voices + 3 ) / 4 ) * 4;
+    groups = this->voices / 4;
+    voicePatchables.resize( this->voices );
+}
+
+pdsp::VoiceBank::~VoiceBank(){}
+
+void pdsp::VoiceBank::Voice::addVoiceInput( const char* tag, InputNode & input ){
+    addInput( tag, input );
+}
+
+void pdsp::VoiceBank::Voice::addVoiceOutput( const char* tag, OutputNode & output ){
+    addOutput( tag, output );
+}
+
+pdsp::Patchable& pdsp::VoiceBank::ch( size_t index ){
+    if( index >= voicePatchables.size() ){
+        std::cout<<"[pdsp] warning! voice "<<index<<" selected, this bank has only "<<voices<<" voices\n";
+        pdsp_trace();
+        index = voicePatchables.size() - 1;
+    }
+    return voicePatchables[index];
+}
+
+int pdsp::VoiceBank::getVoicesNumber() const {
+    return voices;
+}
+
+const char* pdsp::VoiceBank::voiceTag( const char* tag, int voice ){
+    // Patchable stores only the tag pointers, so the generated tags are never freed
+    static std::set<std::string> tags;
+    std::string name = std::string( tag ) + "_" + std::to_string( voice );
+    return tags.insert( name ).first->c_str();
+}
+
+void pdsp::VoiceBank::allocateLanes( float* & lanes, int bufferSize ){
+    if( lanes != nullptr ){
+        ofx_deallocate_aligned( lanes );
+    }
+    // same extra space of the OutputNode buffers
+    int size = ( bufferSize * PDSP_BUFFERS_EXTRA_DIM ) / ( PDSP_BUFFERS_EXTRA_DIM-1 );
+    ofx_allocate_aligned( lanes, size * voices );
+}
+
+void pdsp::VoiceBank::interleave( float* lanes, int voice, const float* buffer, int bufferState, int bufferSize ) noexcept {
+    lanes += voice;
+    if( bufferState == AudioRate ){
+        for( int n=0; n<bufferSize; ++n ){
+            lanes[n*voices] = buffer[n];
+        }
+    }else{
+        float value = buffer[0];
+        for( int n=0; n<bufferSize; ++n ){
+            lanes[n*voices] = value;
+        }
+    }
+}
+
+void pdsp::VoiceBank::interleaveZero( float* lanes, int voice, int bufferSize ) noexcept {
+    lanes += voice;
+    for( int n=0; n<bufferSize; ++n ){
+        lanes[n*voices] = 0.0f;
+    }
+}
+
+void pdsp::VoiceBank::deinterleave( float* buffer, const float* lanes, int voice, int bufferSize ) noexcept {
+    lanes += voice;
+    for( int n=0; n<bufferSize; ++n ){
+        buffer[n] = lanes[n*voices];
+    }
+}
@@ -0,0 +1,71 @@
+
+// VoiceBank.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_BANKS_VOICEBANK_H_INCLUDED
+#define PDSP_BANKS_VOICEBANK_H_INCLUDED
+
+#include "../pdspCore.h"
+#include <vector>
+
+namespace pdsp{
+
+    /*!
+    @brief Voice-batched processing.
+
+    Classes that inherits from VoiceBank are Units that process many polyphonic voices at once, each voice running in a lane of the SIMD vectors. Each voice has its own inputs and outputs, you access them with the ch() method or with the in_ and out_ methods that take the voice index, for example keys.out_trig(i) >> envelopes.ch(i) . The number of voices is set on construction and it is rounded up to a multiple of 4.
+    */
+
+class VoiceBank {
+
+public:
+
+    /*!
+    @brief Uses the selected voice as input/output for the patching operation.
+    @param[in] index voice index
+    */
+    Patchable& ch( size_t index );
+
+    /*!
+    @brief returns the number of voices of this bank.
+    */
+    int getVoicesNumber() const;
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    class Voice : public Patchable {
+    public:
+        void addVoiceInput( const char* tag, InputNode & input );
+        void addVoiceOutput( const char* tag, OutputNode & output );
+    };
+
+protected:
+
+    VoiceBank( int voices );
+    virtual ~VoiceBank();
+
+    // the voices inputs and outputs are added to the Unit with tags like "freq_3"
+    static const char* voiceTag( const char* tag, int voice );
+
+    // lanes buffers have the samples of all the voices interleaved, lanes[ n*voices + voice ]
+    void allocateLanes( float* & lanes, int bufferSize );
+    void interleave( float* lanes, int voice, const float* buffer, int bufferState, int bufferSize ) noexcept;
+    void interleaveZero( float* lanes, int voice, int bufferSize ) noexcept;
+    void deinterleave( float* buffer, const float* lanes, int voice, int bufferSize ) noexcept;
+
+    int voices;
+    int groups; // number of 4 lanes vectors
+
+    std::vector<Voice> voicePatchables;
+/*!
+    @endcond
+*/
+
+};
+
+
+}//END NAMESPACE
+
+#endif //PDSP_BANKS_VOICEBANK_H_INCLUDED
@@ -53,7 +53,8 @@ void pdsp::TriggerGeiger::process (int bufferSize) noexcept {
         for(int n=0; n<bufferSize; ++n){
             if(counter==0){
                 outputBuffer[n] = 1.0f; //set trigger pulse
-                counter = distanceSamples + dice(jitterSamples);
+                counter = distanceSamples + ( (jitterSamples > 0) ? dice(jitterSamples) : 0 );
+                if( counter < 1 ) counter = 1; // at least one sample between the triggers
             }
             counter--;
         }
@@ -0,0 +1,292 @@
+
+#include "ConvolutionTail.h"
+#include <chrono>
+
+pdsp::ConvolutionTail::Stage::Stage(){
+    partition   = 0;
+    complexSize = 0;
+    numBlocks   = 0;
+    blockIndex  = 0;
+
+    paddedInput = nullptr;
+    overlapAdd  = nullptr;
+    addR        = nullptr;
+    addI        = nullptr;
+    inputs[0]   = nullptr;
+    inputs[1]   = nullptr;
+    outputs[0]  = nullptr;
+    outputs[1]  = nullptr;
+
+    position    = 0;
+    block       = 0;
+    requested   = 0;
+    completed   = 0;
+}
+
+
+pdsp::ConvolutionTail::ConvolutionTail(){
+    length = 0;
+    quit = false;
+}
+
+pdsp::ConvolutionTail::ConvolutionTail(const ConvolutionTail & other) : ConvolutionTail() {}
+
+pdsp::ConvolutionTail& pdsp::ConvolutionTail::operator=(const ConvolutionTail & other){ return *this; }
+
+pdsp::ConvolutionTail::~ConvolutionTail(){
+    release();
+}
+
+
+bool pdsp::ConvolutionTail::init( const float* ir, int irLength, int firstPartition, int maxPartition ){
+
+    release();
+
+    int partition = firstPartition * PDSP_CONVOLVER_TAIL_GROWTH;
+    if( maxPartition < partition ){ maxPartition = partition; }
+
+    int offset = partition * 2;
+
+    while( offset < irLength ){
+
+        int next = partition * PDSP_CONVOLVER_TAIL_GROWTH;
+
+        // the last stage takes everything that remains
+        int end = next * 2;
+        if( next > maxPartition || end > irLength ){
+            end = irLength;
+        }
+
+        Stage* stage = new Stage();
+        stage->partition = partition;
+        stage->numBlocks = ( end - offset + partition - 1 ) / partition;
+        stages.push_back( stage );
+
+        if( ! allocateStage( *stage ) ){
+            release();
+            return false;
+        }
+
+        // fft every partition of the segment
+        for( int i=0; i<stage->numBlocks; ++i ){
+            int start = offset + i*partition;
+            for( int n=0; n<partition; ++n ){
+                stage->paddedInput[n] = ( start + n < end ) ? ir[start + n] : 0.0f;
+            }
+            for( int n=partition; n<partition*2; ++n ){
+                stage->paddedInput[n] = 0.0f;
+            }
+            stage->fftWorker.FFT( stage->paddedInput, stage->impulseR[i], stage->impulseI[i] );
+        }
+
+        length = end + partition * 2;
+        offset = end;
+        partition = next;
+    }
+
+    if( ! stages.empty() ){
+        quit = false;
+        worker = std::thread( &ConvolutionTail::threadFunction, this );
+    }
+
+    return true;
+}
+
+
+void pdsp::ConvolutionTail::release(){
+
+    quit = true;
+    condition.notify_one();
+    if( worker.joinable() ){
+        worker.join();
+    }
+
+    for( Stage* stage : stages ){
+        deallocateStage( *stage );
+        delete stage;
+    }
+    stages.clear();
+    length = 0;
+}
+
+
+bool pdsp::ConvolutionTail::isActive() const {
+    return ! stages.empty();
+}
+
+int pdsp::ConvolutionTail::getLength() const {
+    return length;
+}
+
+
+bool pdsp::ConvolutionTail::allocateStage( Stage & stage ){
+
+    stage.fftWorker.initFFT( stage.partition );
+    stage.complexSize = stage.fftWorker.getFFTComplexSize();
+    int signalBlock = stage.fftWorker.getFFTBlockSize();
+
+    ofx_allocate_aligned( stage.paddedInput, signalBlock );
+    ofx_allocate_aligned( stage.overlapAdd, stage.partition );
+    ofx_allocate_aligned( stage.addR, stage.complexSize );
+    ofx_allocate_aligned( stage.addI, stage.complexSize );
+
+    bool allocated = ( stage.paddedInput!=nullptr && stage.overlapAdd!=nullptr && stage.addR!=nullptr && stage.addI!=nullptr );
+
+    for( int i=0; i<2; ++i ){
+        ofx_allocate_aligned( stage.inputs[i], stage.partition );
+        ofx_allocate_aligned( stage.outputs[i], stage.partition );
+        allocated = allocated && stage.inputs[i]!=nullptr && stage.outputs[i]!=nullptr;
+    }
+
+    stage.impulseR.resize( stage.numBlocks, nullptr );
+    stage.impulseI.resize( stage.numBlocks, nullptr );
+    stage.circularR.resize( stage.numBlocks, nullptr );
+    stage.circularI.resize( stage.numBlocks, nullptr );
+
+    for( int i=0; i<stage.numBlocks && allocated; ++i ){
+        ofx_allocate_aligned( stage.impulseR[i], stage.complexSize );
+        ofx_allocate_aligned( stage.impulseI[i], stage.complexSize );
+        ofx_allocate_aligned( stage.circularR[i], stage.complexSize );
+        ofx_allocate_aligned( stage.circularI[i], stage.complexSize );
+        allocated = ( stage.impulseR[i]!=nullptr && stage.impulseI[i]!=nullptr && stage.circularR[i]!=nullptr && stage.circularI[i]!=nullptr );
+    }
+
+    return allocated;
+}
+
+
+void pdsp::ConvolutionTail::deallocateStage( Stage & stage ){
+
+    ofx_deallocate_aligned( stage.paddedInput );
+    ofx_deallocate_aligned( stage.overlapAdd );
+    ofx_deallocate_aligned( stage.addR );
+    ofx_deallocate_aligned( stage.addI );
+
+    for( int i=0; i<2; ++i ){
+        ofx_deallocate_aligned( stage.inputs[i] );
+        ofx_deallocate_aligned( stage.outputs[i] );
+    }
+
+    for( size_t i=0; i<stage.impulseR.size(); ++i ){
+        ofx_deallocate_aligned( stage.impulseR[i] );
+        ofx_deallocate_aligned( stage.impulseI[i] );
+        ofx_deallocate_aligned( stage.circularR[i] );
+        ofx_deallocate_aligned( stage.circularI[i] );
+    }
+}
+
+
+void pdsp::ConvolutionTail::process( const float* input, float* output, int bufferSize ) noexcept {
+
+    for( Stage* stage : stages ){
+
+        int n = 0;
+        while( n < bufferSize ){
+
+            int chunk = stage->partition - stage->position;
+            if( chunk > bufferSize - n ){ chunk = bufferSize - n; }
+
+            // the block b is accumulated in inputs[b&1] while the output of the job b-2 is played from outputs[b&1]
+            float* toFill = stage->inputs[ stage->block & 1 ] + stage->position;
+            if( input != nullptr ){
+                std::memcpy( toFill, input + n, sizeof(float) * chunk );
+            }else{
+                ofx_Aeq_Zero( toFill, chunk );
+            }
+
+            const float* toAdd = stage->outputs[ stage->block & 1 ] + stage->position;
+            for( int i=0; i<chunk; ++i ){
+                output[n+i] += toAdd[i];
+            }
+
+            stage->position += chunk;
+            n += chunk;
+
+            if( stage->position == stage->partition ){
+                stage->position = 0;
+                stage->block++;
+                stage->requested.store( stage->block );
+                condition.notify_one();
+
+                // the next block needs the output of the job before the one just requested
+                // this waits only if the background thread is starved of cpu
+                int spin = 0;
+                while( stage->completed.load() < stage->block - 1 ){
+                    if( spin < PDSP_CONVOLVER_TAIL_SPIN_CYCLES ){
+                        spin++;
+                        std::this_thread::yield();
+                    }else{
+                        std::this_thread::sleep_for( std::chrono::microseconds( PDSP_CONVOLVER_TAIL_WAIT_US ) );
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+void pdsp::ConvolutionTail::processStage( Stage & stage, int job ) noexcept {
+
+    const float* input = stage.inputs[ job & 1 ];
+    int n=0;
+    for( ; n<stage.partition; ++n ){
+        stage.paddedInput[n] = input[n];
+    }
+    for( ; n<stage.partition*2; ++n ){
+        stage.paddedInput[n] = 0.0f;
+    }
+
+    stage.blockIndex--;
+    if( stage.blockIndex<0 ){ stage.blockIndex = stage.numBlocks-1; }
+
+    stage.fftWorker.FFT( stage.paddedInput, stage.circularR[stage.blockIndex], stage.circularI[stage.blockIndex] );
+
+    ofx_Aeq_Zero( stage.addR, stage.complexSize );
+    ofx_Aeq_Zero( stage.addI, stage.complexSize );
+
+    int k = stage.blockIndex;
+    for( int i=0; i<stage.numBlocks; ++i ){
+        vect_cmadd( stage.addR, stage.addI,
+                    stage.impulseR[i], stage.impulseI[i],
+                    stage.circularR[k], stage.circularI[k],
+                    stage.complexSize );
+        k++;
+        if( k>=stage.numBlocks ){ k = 0; }
+    }
+
+    stage.fftWorker.iFFT( stage.paddedInput, stage.addR, stage.addI );
+
+    float* output = stage.outputs[ job & 1 ];
+    for( n=0; n<stage.partition; ++n ){
+        output[n] = stage.paddedInput[n] + stage.overlapAdd[n];
+        stage.overlapAdd[n] = stage.paddedInput[ stage.partition + n ];
+    }
+}
+
+
+void pdsp::ConvolutionTail::threadFunction(){
+
+    // denormals flushing is set per thread
+    ofx_activate_denormal_flush();
+
+    while( ! quit.load() ){
+
+        bool processed = false;
+
+        // stages are sorted by partition size, smaller partitions have closer deadlines
+        for( Stage* stage : stages ){
+            int job = stage->completed.load();
+            if( job < stage->requested.load() ){
+                processStage( *stage, job );
+                stage->completed.store( job+1 );
+                processed = true;
+                break;
+            }
+        }
+
+        if( ! processed ){
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait_for( lock, std::chrono::microseconds( PDSP_CONVOLVER_TAIL_WAIT_US ) );
+        }
+    }
+}
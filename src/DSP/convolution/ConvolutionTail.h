@@ -0,0 +1,98 @@
+
+// ConvolutionTail.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_CONVOLUTIONTAIL_H_INCLUDED
+#define PDSP_CONVOLUTIONTAIL_H_INCLUDED
+
+#include "../pdspCore.h"
+#include "../helpers/FFTWorker.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+namespace pdsp{
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// processes the tail of an impulse response with geometrically growing partitions on a background thread
+// a stage with partition size P starts 2P samples after the beginning of the IR, so the background thread
+// has a whole partition of time to compute each block before the audio thread needs it
+class ConvolutionTail {
+
+public:
+    ConvolutionTail();
+    ConvolutionTail(const ConvolutionTail & other);
+    ConvolutionTail& operator=(const ConvolutionTail & other);
+    ~ConvolutionTail();
+
+    // ir is the whole resampled impulse response, the tail starts from 2*firstPartition
+    // returns false if the memory can't be allocated
+    bool init( const float* ir, int irLength, int firstPartition, int maxPartition );
+    void release();
+
+    // the audio thread pushes the input (nullptr for silence) and adds the tail to the output
+    void process( const float* input, float* output, int bufferSize ) noexcept;
+
+    bool isActive() const;
+
+    // samples after the last non silent input before the tail output is silent
+    int getLength() const;
+
+private:
+    struct Stage {
+        Stage();
+
+        FFTWorker           fftWorker;
+        int                 partition;
+        int                 complexSize;
+        int                 numBlocks;
+        int                 blockIndex;
+
+        std::vector<float*> impulseR;
+        std::vector<float*> impulseI;
+        std::vector<float*> circularR;
+        std::vector<float*> circularI;
+
+        float*  paddedInput;
+        float*  overlapAdd;
+        float*  addR;
+        float*  addI;
+
+        float*  inputs[2];
+        float*  outputs[2];
+
+        // audio thread
+        int     position;
+        int     block;
+
+        std::atomic<int>    requested;
+        std::atomic<int>    completed;
+    };
+
+    bool allocateStage( Stage & stage );
+    void deallocateStage( Stage & stage );
+    void processStage( Stage & stage, int job ) noexcept;
+    void threadFunction();
+
+    std::vector<Stage*>     stages;
+    int                     length;
+
+    std::thread             worker;
+    std::atomic<bool>       quit;
+    std::mutex              mutex;
+    std::condition_variable condition;
+};
+
+/*!
+    @endcond
+*/
+
+}//END NAMESPACE
+
+#endif  // PDSP_CONVOLUTIONTAIL_H_INCLUDED
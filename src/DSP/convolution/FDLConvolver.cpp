@@ -1,9 +1,6 @@
 
 #include "FDLConvolver.h"
 
-pdsp::FFTWorker pdsp::FDLConvolver::fftWorker = FFTWorker();
-
-
 pdsp::FDLConvolver::FDLConvolver(){
         
         addInput("signal", input);
@@ -13,13 +10,18 @@ pdsp::FDLConvolver::FDLConvolver(){
         signalBlock    = 0;
         complexSize    = 0;
         silenceCount   = 30000;
+        silenceBlocks  = 0;
         processingSize = 0;
-        processingOffset = 0;
+        blockPosition  = 0;
+        blockSilent    = true;
                 
         impulseResponse = nullptr;
         IRLoaded = false;
         IRChannel = 0;
         
+        nonUniform = false;
+        maxPartition = PDSP_CONVOLVER_MAX_PARTITION;
+        
         impulseR    = nullptr;
         impulseI    = nullptr;
         circularR   = nullptr;
@@ -29,6 +31,7 @@ pdsp::FDLConvolver::FDLConvolver(){
         addI        = nullptr;           
         paddedInput = nullptr;
         overlapAdd  = nullptr;
+        blockInput  = nullptr;
         
         if(dynamicConstruction){
                 prepareUnit(globalBufferSize, globalSampleRate);
@@ -58,11 +61,11 @@ void pdsp::FDLConvolver::releaseResources () {
 }       
 
 
-void pdsp::FDLConvolver::loadIR ( SampleBuffer* impulseResponse, int channel){
+void pdsp::FDLConvolver::loadIR ( const SampleBuffer* impulseResponse, int channel){
     loadIR( *impulseResponse, channel);
 }
 
-void pdsp::FDLConvolver::loadIR ( SampleBuffer & impulseResponse, int channel){
+void pdsp::FDLConvolver::loadIR ( const SampleBuffer & impulseResponse, int channel){
     this->IRChannel = channel;
     this->impulseResponse = &impulseResponse;
     
@@ -72,6 +75,16 @@ void pdsp::FDLConvolver::loadIR ( SampleBuffer & impulseResponse, int channel){
 }
 
 
+void pdsp::FDLConvolver::setNonUniformPartitioning( bool active, int maxPartition ){
+    this->nonUniform = active;
+    this->maxPartition = maxPartition;
+    
+    if(dynamicConstruction){
+        prepareIR();
+    }
+}
+
+
 void pdsp::FDLConvolver::prepareIR ( ){
     
         IRLoaded = false;
@@ -99,15 +112,55 @@ void pdsp::FDLConvolver::prepareIR ( ){
                 signalBlock = fftWorker.getFFTBlockSize();
                 processingSize = signalBlock/2;
                 complexSize = fftWorker.getFFTComplexSize();               
-                numBlocks = (convertedLen / processingSize) + 1;
                 
-                if( allocateBlocksBuffers() && loadImpulseResponseSegments(inc, convertedLen) ){
+                //resample the whole IR, it is segmented for the head and for the tail
+                std::vector<float> ir;
+                try
+                {
+                    ir.resize(convertedLen);
+                }
+                catch (std::bad_alloc& ba)
+                {
+                    return;
+                }
+                
+                float index = 0.0f;
+                for(int n=0; n<convertedLen; ++n){
+                        if(sampleRate!=impulseResponse->fileSampleRate){
+                                int index_int = static_cast<int> (index);
+                                float mu = index - index_int;
+                                float x1 = (index_int   < impulseResponse->length) ? impulseResponse->buffer[IRChannel][index_int]   : 0.0f;
+                                float x2 = (index_int+1 < impulseResponse->length) ? impulseResponse->buffer[IRChannel][index_int+1] : 0.0f;
+                                ir[n] = interpolate_smooth( x1, x2, mu );
+                                index = (index + inc);
+                        }else{
+                                ir[n] = impulseResponse->buffer[IRChannel][n];
+                        }
+                }
+                
+                //with the non-uniform partitioning the audio thread processes only the head of the IR
+                int headLength = processingSize * 2 * PDSP_CONVOLVER_TAIL_GROWTH;
+                if( nonUniform && convertedLen > headLength ){
+                        numBlocks = headLength / processingSize;
+                }else{
+                        headLength = convertedLen;
+                        numBlocks = (convertedLen / processingSize) + 1;
+                }
+                
+                if( allocateBlocksBuffers() && loadImpulseResponseSegments(ir.data(), headLength) ){
                         IRLoaded = true;
                 }else{
                         IRLoaded = false;
                 }
                 
+                if( IRLoaded && headLength < convertedLen ){
+                        IRLoaded = tail.init( ir.data(), convertedLen, processingSize, maxPartition );
+                }
+                
+                silenceBlocks = numBlocks + 4 + tail.getLength() / processingSize;
                 blockIndex = 0;
+                blockPosition = 0;
+                blockSilent = true;
                 
         }
 }
@@ -132,6 +185,15 @@ bool pdsp::FDLConvolver::allocateBlocksBuffers(){
         deallocateBlocksBuffers();
         return false;
     }
+
+    if(blockInput != nullptr){
+        ofx_deallocate_aligned(blockInput);
+    }
+    ofx_allocate_aligned(blockInput, signalBlock/2);
+    if(blockInput == nullptr){
+        deallocateBlocksBuffers();
+        return false;
+    }
     
     if(addR != nullptr){
         ofx_deallocate_aligned(addR);
@@ -210,12 +272,17 @@ bool pdsp::FDLConvolver::allocateBlocksBuffers(){
 
 void pdsp::FDLConvolver::deallocateBlocksBuffers(){
       
+        tail.release();
+        
         if(paddedInput != nullptr){
                 ofx_deallocate_aligned(paddedInput);
         }
         if(overlapAdd != nullptr){
                 ofx_deallocate_aligned(overlapAdd);
         }
+        if(blockInput != nullptr){
+                ofx_deallocate_aligned(blockInput);
+        }
         
         if(addR != nullptr){
                 ofx_deallocate_aligned(addR);
@@ -258,9 +325,7 @@ void pdsp::FDLConvolver::deallocateBlocksBuffers(){
 }
 
 
-bool pdsp::FDLConvolver::loadImpulseResponseSegments(const float &inc, const int &convertedLen){
-                        
-        float index = 0.0f;
+bool pdsp::FDLConvolver::loadImpulseResponseSegments(const float* ir, int headLength){
         
         float* tempBuffer;
         
@@ -277,29 +342,13 @@ bool pdsp::FDLConvolver::loadImpulseResponseSegments(const float &inc, const int
         
         for(int i=0; i<numBlocks; ++i){ 
 
-                //load the segment from the wave buffer (a bit ugly but works, and we don't need speed here)
-                if(sampleRate!=impulseResponse->fileSampleRate){
-                        for(int n=0; n<processingSize; ++n){
-                                
-                                if(index < static_cast<float>(convertedLen)){ //check if we are after the IR length
-                                        int index_int = static_cast<int> (index);
-                                        float mu = index - index_int;
-                                        float x1 = impulseResponse->buffer[IRChannel][index_int];
-                                        float x2 = impulseResponse->buffer[IRChannel][index_int+1];
-                                        tempBuffer[n] = interpolate_smooth( x1, x2, mu );
-                                }else{
-                                        tempBuffer[n] = 0.0f;
-                                }
-                                index = (index + inc);
-                        }
-                }else{
-                        for(int n=0; n<processingSize; ++n){
-                                
-                                if( ( i*processingSize + n )< convertedLen){ //check if we are after the IR length
-                                        tempBuffer[n] = impulseResponse->buffer[IRChannel][i*processingSize + n];
-                                }else{
-                                        tempBuffer[n] = 0.0f;
-                                }
+                //load the segment from the resampled IR
+                for(int n=0; n<processingSize; ++n){
+                        
+                        if( ( i*processingSize + n )< headLength){ //check if we are after the head length
+                                tempBuffer[n] = ir[i*processingSize + n];
+                        }else{
+                                tempBuffer[n] = 0.0f;
                         }
                 }
                 
@@ -322,55 +371,45 @@ void pdsp::FDLConvolver::process (int bufferSize) noexcept {
         int inputState;
         const float* inputBuffer = processInput(input, inputState);
 
-        if( IRLoaded && (inputState==AudioRate || silenceCount <= (numBlocks+4) ) ){
+        if( IRLoaded && (inputState==AudioRate || silenceCount <= silenceBlocks ) ){
 
-                int stillToProcess = bufferSize;
+                float* outputBuffer = getOutputBufferToFill(output);
                 
-                while(stillToProcess>0){
-                        //processing padding for non-power-of-two bufferSizes
-                        int maxPadded;
-                        int minPadded;
+                // the buffer can start and end in the middle of a partition when its size is not a power of two
+                // each piece is played right away from the partition received until now, zero padded,
+                // and the partition moves into the delay line only when it is complete
+                int n = 0;
+                while( n<bufferSize ){
                         
-                        if(stillToProcess <= processingSize ) { 
-                                minPadded = 0;
-                                maxPadded = stillToProcess;
-                                processingOffset = processingSize - stillToProcess;
-                                stillToProcess -= processingSize;
-                                
+                        if(blockPosition==0){
                                 blockIndex--;
                                 if(blockIndex<0){ blockIndex = numBlocks-1; } 
-                        }else{
-                                minPadded = processingOffset;
-                                maxPadded = processingSize;
-                                stillToProcess -= (processingSize-processingOffset);
+                        }
+                        
+                        int chunk = processingSize - blockPosition;
+                        if( chunk > bufferSize-n ){ chunk = bufferSize-n; }
+                        
+                        if(inputState==AudioRate){
+                                for(int i=0; i<chunk; ++i){
+                                        blockInput[blockPosition+i] = inputBuffer[n+i];
+                                }
+                                blockSilent = false;
                         }
                         
                         //ACTUAL IR PARTITIONED CONVOLUTION
                         //FFT input
-                        switch (inputState){
-                        case AudioRate: //we have input signal for forward FFT
-                        {
-                                int n=0;
-                                for(; n<minPadded; ++n){
-                                        paddedInput[n] = 0.0f;
-                                }
-                                for(; n<maxPadded; ++n){
-                                        paddedInput[n] = inputBuffer[n];
+                        if(blockSilent){ //silence, we simply set the complex buffer to zero
+                                ofx_Aeq_Zero(circularR[blockIndex], complexSize);
+                                ofx_Aeq_Zero(circularI[blockIndex], complexSize);
+                        }else{
+                                int i=0;
+                                for(; i<processingSize; ++i){
+                                        paddedInput[i] = blockInput[i];
                                 }
-                                for(; n<signalBlock; ++n){
-                                        paddedInput[n] = 0.0f;
+                                for(; i<signalBlock; ++i){
+                                        paddedInput[i] = 0.0f;
                                 }
                                 fftWorker.FFT(paddedInput, circularR[blockIndex], circularI[blockIndex]);
-                                silenceCount=0;
-                        }
-                                break;
-                        default: //silence, we simply set the complex buffer to zero
-                        {
-                                ofx_Aeq_Zero(circularR[blockIndex], complexSize);
-                                ofx_Aeq_Zero(circularI[blockIndex], complexSize);
-                                silenceCount++;
-                        }
-                                break;
                         }
                         
                         //set add buffer to zero 
@@ -389,19 +428,32 @@ void pdsp::FDLConvolver::process (int bufferSize) noexcept {
                         }
 
                         //inverse FFT
-                        float* outputBuffer = getOutputBufferToFill(output);
-                        
                         fftWorker.iFFT(paddedInput, addR, addI);  
                         
-                        
-                        for(int n=0; n<processingSize; ++n){
-                                outputBuffer[n] = paddedInput[n];
-                                outputBuffer[n]+= overlapAdd[n];
+                        for(int i=0; i<chunk; ++i){
+                                outputBuffer[n+i] = paddedInput[blockPosition+i] + overlapAdd[blockPosition+i];
                         }
                         
-                        for(int n=0; n<processingSize; ++n){
-                                overlapAdd[n] = paddedInput[ processingSize +n ];
-                        }           
+                        blockPosition += chunk;
+                        n += chunk;
+                        
+                        if(blockPosition==processingSize){
+                                for(int i=0; i<processingSize; ++i){
+                                        overlapAdd[i] = paddedInput[ processingSize +i ];
+                                }
+                                if(blockSilent){
+                                        silenceCount++;
+                                }else{
+                                        silenceCount = 0;
+                                }
+                                ofx_Aeq_Zero(blockInput, processingSize);
+                                blockSilent = true;
+                                blockPosition = 0;
+                        }
+                }
+                
+                if( tail.isActive() ){
+                        tail.process( (inputState==AudioRate) ? inputBuffer : nullptr, getOutputBufferToFill(output), bufferSize );
                 }
         }else{
                 setOutputToZero(output);  
@@ -10,13 +10,14 @@
 #include "../pdspCore.h"
 #include "../helpers/FFTWorker.h"
 #include "../samplers/SampleBuffer.h"
+#include "ConvolutionTail.h"
 
 namespace pdsp{
 /*!
 
 @brief Process the input using FFT convolution with a given impulse response.
 
-This Units implement partitioned convolution using a Frequency-Domain Delay Line. Expecially useful if you have some real space impulse response to be used to make a IR Reverb.
+This Units implement partitioned convolution using a Frequency-Domain Delay Line. Expecially useful if you have some real space impulse response to be used to make a IR Reverb. For long impulse responses activate the non-uniform partitioning with setNonUniformPartitioning(), so most of the work is moved away from the audio thread.
 */
 
 class FDLConvolver : public Unit {
@@ -39,13 +40,20 @@ public:
         @param[in] impulseResponse SampleBuffer to load as Impulse Response for the convolution.
         @param[in] channel select the channel to be if the SampleBuffer has more than one. If omitted the first channel is selected.
         */
-        void loadIR ( SampleBuffer & impulseResponse, int channel=0);
+        void loadIR ( const SampleBuffer & impulseResponse, int channel=0);
+
+        /*!
+        @brief Activates or deactivates the non-uniform partitioning. When active only the head of the impulse response is processed on the audio thread with small partitions, the tail is processed with geometrically growing partitions on a background thread and mixed back in time, without adding latency. Set it before loadIR() or before starting the audio. Deactivated by default.
+        @param[in] active true to activate the non-uniform partitioning
+        @param[in] maxPartition the max size of the tail partitions in samples. If omitted 16384 is used.
+        */
+        void setNonUniformPartitioning( bool active, int maxPartition=PDSP_CONVOLVER_MAX_PARTITION );
        
 /*!
     @cond HIDDEN_SYMBOLS
 */
         [[deprecated("deprecated, now direclty pass your SampleBuffer")]]
-        void loadIR ( SampleBuffer* impulseResponse, int channel=0);
+        void loadIR ( const SampleBuffer* impulseResponse, int channel=0);
 /*!
     @endcond
 */
@@ -60,7 +68,7 @@ private:
         void deallocateBlocksBuffers();
         bool allocateBlocksBuffers();
 
-        bool loadImpulseResponseSegments(const float &inc, const int &convertedLen);
+        bool loadImpulseResponseSegments(const float* ir, int headLength);
         
         OutputNode output;
         InputNode input;
@@ -70,13 +78,16 @@ private:
         int complexSize;
         int signalBlock;
         int processingSize;
-        int processingOffset;
+        int blockPosition;      // samples of the current partition already received
+        bool blockSilent;
         int silenceCount;
+        int silenceBlocks;
         
         float* addR;
         float* addI;
         float*  paddedInput;
         float*  overlapAdd;
+        float*  blockInput;
         
         float** impulseR;
         float** impulseI;
@@ -84,11 +95,15 @@ private:
         float** circularI;      
         
         int             IRChannel;
-        SampleBuffer*   impulseResponse;
+        const SampleBuffer*   impulseResponse;
         bool            IRLoaded; 
         double          sampleRate;
         
-        static FFTWorker    fftWorker;
+        bool            nonUniform;
+        int             maxPartition;
+        ConvolutionTail tail;
+        
+        FFTWorker       fftWorker;
            
 };    
 
@@ -17,10 +17,11 @@ namespace pdsp{
     /*!
     @brief Multiply in("signal") for in("mod").
     
-    Multiply the in_signal() input for the in_mod() input. If the in_mod() input is running ad control rate and it is equal to 0, the in_signal() branch is not even calculated, saving cpu cycles.
+    Multiply the in_signal() input for the in_mod() input. If the in_mod() input is running ad control rate and it is equal to 0, the in_signal() branch is not even calculated, saving cpu cycles. This happens also in the compiled graph mode of Processor, where the Units that are patched only to the in_signal() sleep while the in_mod() is 0.0f, for example the oscillators and filters of a voice with its envelope in the off stage.
 
     */
 class Amp : public Unit{
+    friend class Processor;
     
 public:
     
@@ -0,0 +1,374 @@
+
+#include "AudioWorkerPool.h"
+#include "RealtimeChecker.h"
+#include <chrono>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <sched.h>
+#elif defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#endif
+
+//-------------------------------SLEEP GATE--------------------------------
+
+bool pdsp::SleepGate::sleeping( const std::vector<SleepGate> & gates ) const noexcept {
+    const SleepGate* gate = this;
+    while( true ){
+        if( gate->mod->isZeroAtControlRate() ){
+            return true;
+        }
+        if( gate->outer < 0 ){
+            return false;
+        }
+        gate = &gates[ gate->outer ];
+    }
+}
+
+//-------------------------------WORK STEALING DEQUE--------------------------------
+
+pdsp::WorkStealingDeque::WorkStealingDeque(){
+    top = 0;
+    bottom = 0;
+}
+
+void pdsp::WorkStealingDeque::resize( int capacity ){
+    tasks.resize( capacity );
+    reset();
+}
+
+void pdsp::WorkStealingDeque::reset() noexcept {
+    top = 0;
+    bottom = 0;
+}
+
+void pdsp::WorkStealingDeque::push( int task ) noexcept {
+    int b = bottom.load();
+    tasks[b] = task;
+    bottom.store( b+1 );
+}
+
+bool pdsp::WorkStealingDeque::pop( int & task ) noexcept {
+    int b = bottom.load() - 1;
+    bottom.store( b );
+    int t = top.load();
+
+    if( t <= b ){
+        task = tasks[b];
+        if( t == b ){
+            // last task, race against the thieves
+            bool won = top.compare_exchange_strong( t, t+1 );
+            bottom.store( b+1 );
+            return won;
+        }
+        return true;
+    }else{
+        bottom.store( b+1 );
+        return false;
+    }
+}
+
+bool pdsp::WorkStealingDeque::steal( int & task ) noexcept {
+    int t = top.load();
+    int b = bottom.load();
+    if( t < b ){
+        task = tasks[t];
+        return top.compare_exchange_strong( t, t+1 );
+    }
+    return false;
+}
+
+
+//-------------------------------TASK GRAPH--------------------------------
+
+pdsp::TaskGraph::TaskGraph(){
+    threads = 1;
+    gates = nullptr;
+}
+
+int pdsp::TaskGraph::getThreads() const {
+    return threads;
+}
+
+void pdsp::TaskGraph::compile( const std::vector<Unit*> & schedule, const std::vector<std::vector<int>> & producers,
+                               const std::vector<int> & unitGates, const std::vector<SleepGate> & gates, int threads ){
+
+    int size = schedule.size();
+
+    std::vector<int> consumers( size, 0 );
+    for( int i=0; i<size; ++i ){
+        for( int p : producers[i] ){
+            consumers[p]++;
+        }
+    }
+
+    // Units are grouped in chains: a Unit goes in the same task of its producer
+    // if it has only that producer and it is the only consumer of that producer
+    std::vector<int> taskOf( size );
+    std::vector<std::vector<int>> taskUnits;
+    for( int i=0; i<size; ++i ){
+        if( producers[i].size()==1 && consumers[ producers[i][0] ]==1
+            && taskUnits[ taskOf[producers[i][0]] ].back() == producers[i][0] ){
+            taskOf[i] = taskOf[ producers[i][0] ];
+            taskUnits[ taskOf[i] ].push_back( i );
+        }else{
+            taskOf[i] = taskUnits.size();
+            taskUnits.push_back( std::vector<int>( 1, i ) );
+        }
+    }
+
+    int numTasks = taskUnits.size();
+    std::vector<std::vector<int>> taskSuccessors( numTasks );
+    std::vector<int> lastProducerOf( numTasks, -1 );
+
+    this->threads = threads < 1 ? 1 : threads;
+    units.clear();
+    this->unitGates.clear();
+    this->gates = &gates;
+    tasks.clear();
+    successors.clear();
+    roots.clear();
+
+    for( int t=0; t<numTasks; ++t ){
+        Task task;
+        task.firstUnit = units.size();
+        task.numUnits = taskUnits[t].size();
+        task.dependencies = 0;
+
+        for( int u : taskUnits[t] ){
+            units.push_back( schedule[u] );
+            this->unitGates.push_back( unitGates[u] );
+            for( int p : producers[u] ){
+                int pt = taskOf[p];
+                if( pt != t && lastProducerOf[pt] != t ){
+                    lastProducerOf[pt] = t;
+                    taskSuccessors[pt].push_back( t );
+                    task.dependencies++;
+                }
+            }
+        }
+        if( task.dependencies == 0 ){
+            roots.push_back( t );
+        }
+        tasks.push_back( task );
+    }
+
+    for( int t=0; t<numTasks; ++t ){
+        tasks[t].firstSuccessor = successors.size();
+        tasks[t].numSuccessors = taskSuccessors[t].size();
+        for( int s : taskSuccessors[t] ){
+            successors.push_back( s );
+        }
+    }
+
+    pending.reset( new std::atomic<int>[ numTasks > 0 ? numTasks : 1 ] );
+
+    deques.reset( new WorkStealingDeque[ this->threads ] );
+    for( int i=0; i<this->threads; ++i ){
+        deques[i].resize( numTasks );
+    }
+}
+
+
+//-------------------------------AUDIO WORKER POOL--------------------------------
+
+pdsp::AudioWorkerPool::AudioWorkerPool(){
+    threads = 1;
+    graph = nullptr;
+    bufferSize = 0;
+    remaining = 0;
+    running = false;
+    active = 0;
+    generation = 0;
+    quit = false;
+    priorityReady = false;
+    audioPolicy = 0;
+    audioPriority = 0;
+}
+
+pdsp::AudioWorkerPool::~AudioWorkerPool(){
+    stop();
+}
+
+void pdsp::AudioWorkerPool::start( int threads ){
+    stop();
+
+    if( threads < 1 ) threads = 1;
+    this->threads = threads;
+
+    quit = false;
+    priorityReady = false;
+    workers.reserve( threads-1 );
+    for( int i=0; i<threads-1; ++i ){
+        workers.push_back( std::thread( &AudioWorkerPool::workerFunction, this, i ) );
+    }
+}
+
+void pdsp::AudioWorkerPool::stop(){
+    quit = true;
+    for( std::thread & worker : workers ){
+        if( worker.joinable() ){
+            worker.join();
+        }
+    }
+    workers.clear();
+    threads = 1;
+}
+
+int pdsp::AudioWorkerPool::getThreads() const {
+    return threads;
+}
+
+void pdsp::AudioWorkerPool::run( TaskGraph & graph, int bufferSize ) noexcept {
+
+    if( graph.tasks.empty() || graph.threads != threads ) return;
+
+    if( ! priorityReady.load() ){
+        getThreadPriority( audioPolicy, audioPriority );
+        priorityReady = true;
+    }
+
+    this->graph = &graph;
+    this->bufferSize = bufferSize;
+
+    for( size_t t=0; t<graph.tasks.size(); ++t ){
+        graph.pending[t].store( graph.tasks[t].dependencies );
+    }
+    for( int i=0; i<threads; ++i ){
+        graph.deques[i].reset();
+    }
+    for( size_t r=0; r<graph.roots.size(); ++r ){
+        graph.deques[ r % threads ].push( graph.roots[r] );
+    }
+    remaining = graph.tasks.size();
+
+    generation++;
+    running = true;
+
+    // the audio thread is the last worker
+    work( threads-1 );
+
+    // wait that no worker is still touching the deques
+    running = false;
+    while( active.load() != 0 ) { std::this_thread::yield(); }
+}
+
+void pdsp::AudioWorkerPool::work( int index ) noexcept {
+    int task;
+    while( remaining.load() > 0 ){
+        if( findTask( index, task ) ){
+            execute( task, index );
+        }else{
+            // a task we depend on is still running on another thread
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool pdsp::AudioWorkerPool::findTask( int index, int & task ) noexcept {
+    if( graph->deques[index].pop( task ) ){
+        return true;
+    }
+    for( int i=1; i<threads; ++i ){
+        if( graph->deques[ (index+i) % threads ].steal( task ) ){
+            return true;
+        }
+    }
+    return false;
+}
+
+void pdsp::AudioWorkerPool::execute( int task, int index ) noexcept {
+    const TaskGraph::Task & t = graph->tasks[task];
+    const std::vector<SleepGate> & gates = *graph->gates;
+#ifdef PDSP_REALTIME_CHECKS
+    RealtimeChecker::Scope check;
+#endif
+
+    int end = t.firstUnit + t.numUnits;
+    for( int i=t.firstUnit; i<end; ++i ){
+        Unit* unit = graph->units[i];
+        if( graph->unitGates[i] >= 0 && gates[ graph->unitGates[i] ].sleeping( gates ) ){
+            continue;
+        }
+#ifdef PDSP_REALTIME_CHECKS
+        RealtimeChecker::UnitScope checkUnit( unit );
+#endif
+#ifdef PDSP_PROFILING
+        Profiler::Scope profileUnit( unit );
+#endif
+        unit->process( bufferSize * unit->getOversampleLevel() );
+    }
+
+    end = t.firstSuccessor + t.numSuccessors;
+    for( int i=t.firstSuccessor; i<end; ++i ){
+        int successor = graph->successors[i];
+        if( graph->pending[successor].fetch_sub( 1 ) == 1 ){
+            graph->deques[index].push( successor );
+        }
+    }
+
+    remaining--;
+}
+
+void pdsp::AudioWorkerPool::getThreadPriority( int & policy, int & priority ) noexcept {
+#if defined(__linux__) || defined(__APPLE__)
+    sched_param param;
+    pthread_getschedparam( pthread_self(), &policy, &param );
+    priority = param.sched_priority;
+#elif defined(_WIN32)
+    policy = 0;
+    priority = GetThreadPriority( GetCurrentThread() );
+#else
+    policy = 0;
+    priority = 0;
+#endif
+}
+
+void pdsp::AudioWorkerPool::setThreadPriority( int policy, int priority ) noexcept {
+    // best effort, without the right privileges this just fails and the thread keeps its priority
+#if defined(__linux__) || defined(__APPLE__)
+    sched_param param;
+    param.sched_priority = priority;
+    pthread_setschedparam( pthread_self(), policy, &param );
+#elif defined(_WIN32)
+    SetThreadPriority( GetCurrentThread(), priority );
+#endif
+}
+
+void pdsp::AudioWorkerPool::workerFunction( int index ){
+
+    // denormals flushing is set per thread, it has to be the same of the audio thread
+    ofx_activate_denormal_flush();
+
+    // the workers only process compiled schedules, the inputs never pull their Units
+    InputNode::recursivePull = false;
+
+    int idle = 0;
+    int lastGeneration = generation.load();
+    bool priorityApplied = false;
+
+    while( ! quit.load() ){
+        if( !priorityApplied && priorityReady.load() ){
+            // workers run with the same priority of the audio thread
+            setThreadPriority( audioPolicy, audioPriority );
+            priorityApplied = true;
+        }
+        
+        if( running.load() && generation.load() != lastGeneration ){
+            lastGeneration = generation.load();
+            active++;
+            if( running.load() ){
+                work( index );
+            }
+            active--;
+            idle = 0;
+        }else if( idle < PDSP_WORKERS_SPIN_CYCLES ){
+            idle++;
+            std::this_thread::yield();
+        }else{
+            std::this_thread::sleep_for( std::chrono::microseconds( PDSP_WORKERS_SLEEP_US ) );
+        }
+    }
+}
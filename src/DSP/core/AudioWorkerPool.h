@@ -0,0 +1,140 @@
+
+// AudioWorkerPool.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_CORE_AUDIOWORKERPOOL_H_INCLUDED
+#define PDSP_CORE_AUDIOWORKERPOOL_H_INCLUDED
+
+#include "BasicNodes.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+namespace pdsp{
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// fixed capacity Chase-Lev deque, the owner pushes and pops from the bottom, the others steal from the top
+// it is reset at each run so it never wraps around and never reallocates while processing
+class WorkStealingDeque {
+public:
+    WorkStealingDeque();
+
+    void resize( int capacity );
+    void reset() noexcept;
+    void push( int task ) noexcept;
+    bool pop( int & task ) noexcept;
+    bool steal( int & task ) noexcept;
+
+private:
+    std::vector<int>    tasks;
+    std::atomic<int>    top;
+    std::atomic<int>    bottom;
+};
+
+
+// a compiled schedule Unit that feeds only the "signal" input of an Amp sleeps when the Amp
+// "mod" input is 0.0f at control rate, gates are nested when an Amp sleeps inside another one
+// the gates are compiled with the schedule on the control thread, the audio thread only checks them
+class SleepGate {
+public:
+    SleepGate( const InputNode* mod, int outer ) : mod( mod ), outer( outer ) {};
+
+    // the producers of mod have to be already processed in this turn
+    bool sleeping( const std::vector<SleepGate> & gates ) const noexcept;
+
+    const InputNode*    mod;
+    int                 outer;
+};
+
+
+// the tasks compiled from a schedule, built on the control thread and only read while processing
+class TaskGraph {
+    friend class AudioWorkerPool;
+
+public:
+    TaskGraph();
+
+    // builds the task graph for a pool of the given threads, schedule has to be sorted by dependencies,
+    // producers[i] are the schedule indices of the Units that the Unit at schedule[i] depends on,
+    // unitGates[i] is the index of the SleepGate of the Unit at schedule[i] or -1
+    void compile( const std::vector<Unit*> & schedule, const std::vector<std::vector<int>> & producers,
+                  const std::vector<int> & unitGates, const std::vector<SleepGate> & gates, int threads );
+
+    int getThreads() const;
+
+private:
+    struct Task {
+        int firstUnit;
+        int numUnits;
+        int dependencies;
+        int firstSuccessor;
+        int numSuccessors;
+    };
+
+    int threads;
+    std::vector<Unit*>  units;
+    std::vector<int>    unitGates;
+    const std::vector<SleepGate>* gates;
+    std::vector<Task>   tasks;
+    std::vector<int>    successors;
+    std::vector<int>    roots;
+    std::unique_ptr<std::atomic<int>[]>     pending;
+    std::unique_ptr<WorkStealingDeque[]>    deques;
+};
+
+
+class AudioWorkerPool {
+
+public:
+    AudioWorkerPool();
+    ~AudioWorkerPool();
+
+    // spawns threads-1 worker threads, the audio thread is the last worker
+    // this should be called before starting the audio processing
+    void start( int threads );
+    void stop();
+
+    int getThreads() const;
+
+    // processes all the tasks using the audio thread and the workers, returns when everything is done
+    // the graph has to be compiled for the same number of threads of the pool
+    void run( TaskGraph & graph, int bufferSize ) noexcept;
+
+private:
+    void workerFunction( int index );
+    void work( int index ) noexcept;
+    void execute( int task, int index ) noexcept;
+    bool findTask( int index, int & task ) noexcept;
+
+    static void getThreadPriority( int & policy, int & priority ) noexcept;
+    static void setThreadPriority( int policy, int priority ) noexcept;
+
+    int threads;
+    std::vector<std::thread>    workers;
+
+    TaskGraph*  graph;
+    int         bufferSize;
+
+    std::atomic<int>    remaining;
+    std::atomic<bool>   running;
+    std::atomic<int>    active;
+    std::atomic<int>    generation;
+    std::atomic<bool>   quit;
+
+    std::atomic<bool>   priorityReady;
+    int                 audioPolicy;
+    int                 audioPriority;
+};
+
+/*!
+    @endcond
+*/
+
+}//END NAMESPACE
+
+#endif  // PDSP_CORE_AUDIOWORKERPOOL_H_INCLUDED
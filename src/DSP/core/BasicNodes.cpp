@@ -1,6 +1,8 @@
 
 
 #include "BasicNodes.h"
+#include "RealtimeChecker.h"
+#include <chrono>
 
 
 pdsp::NullOutput pdsp::Patchable::invalidOutput = NullOutput();
@@ -9,6 +11,190 @@ pdsp::NullInput pdsp::Patchable::invalidInput = pdsp::NullInput();
 
 std::atomic<int> pdsp::OutputNode::globalProcessingTurnId(42); // is the answer
 
+std::atomic<int> pdsp::InputNode::globalPatchingVersion(0);
+thread_local bool pdsp::InputNode::recursivePull = true;
+
+int pdsp::InputNode::repatchDepth = 0;
+int pdsp::InputNode::processingDepth = 0;
+std::atomic<int> pdsp::InputNode::patchingState(0);
+std::atomic<pdsp::PatchBatch*> pdsp::InputNode::pendingBatch(nullptr);
+std::atomic<std::thread::id> pdsp::InputNode::processingThread;
+
+//------------------------REPATCHING--------------------------------
+
+namespace pdsp{
+
+// the lists staged by one commit, after being applied it holds the old lists to reclaim
+class PatchBatch {
+public:
+    std::vector<InputNode*> nodes;
+    std::vector<std::vector<OutputData>*> lists;
+    std::vector<PatchCompiler*> compilers;
+    std::atomic<bool> applied;
+
+    void apply() noexcept {
+        for( size_t i=0; i<nodes.size(); ++i ){
+            std::vector<OutputData>* old = nodes[i]->processedInputs;
+            nodes[i]->processedInputs = lists[i];
+            lists[i] = old;
+        }
+        for( PatchCompiler* compiler : compilers ){
+            compiler->applyPatch();
+        }
+        InputNode::globalPatchingVersion++;
+        applied = true;
+    }
+};
+
+}//END NAMESPACE
+
+// patchingState values
+#define PDSP_PATCHING_IDLE 0
+#define PDSP_PATCHING_PROCESSING 1
+#define PDSP_PATCHING_APPLYING 2
+
+void pdsp::beginRepatch(){
+    InputNode::repatchDepth++;
+}
+
+void pdsp::commitRepatch(){
+    if( InputNode::repatchDepth > 0 ){
+        InputNode::repatchDepth--;
+    }
+    if( InputNode::repatchDepth == 0 ){
+        InputNode::publishStaged();
+    }
+}
+
+std::vector<pdsp::OutputData> & pdsp::InputNode::emptyInputs(){
+    // never deleted, static InputNodes can still use it when they are destroyed
+    static std::vector<OutputData>* empty = new std::vector<OutputData>();
+    return *empty;
+}
+
+std::vector<pdsp::InputNode*> & pdsp::InputNode::stagedNodes(){
+    static std::vector<InputNode*>* nodes = new std::vector<InputNode*>();
+    return *nodes;
+}
+
+std::vector<pdsp::PatchCompiler*> & pdsp::InputNode::patchCompilers(){
+    static std::vector<PatchCompiler*>* compilers = new std::vector<PatchCompiler*>();
+    return *compilers;
+}
+
+void pdsp::InputNode::stageChange(){
+    if( ! staged ){
+        staged = true;
+        stagedNodes().push_back( this );
+    }
+    if( repatchDepth == 0 ){
+        publishStaged();
+    }
+}
+
+void pdsp::InputNode::publishStaged(){
+
+    std::vector<InputNode*> & nodes = stagedNodes();
+    if( nodes.empty() ) return;
+
+    // all the allocations are made here on the control thread
+    PatchBatch* batch = new PatchBatch();
+    batch->applied = false;
+    batch->nodes.reserve( nodes.size() );
+    batch->lists.reserve( nodes.size() );
+    for( InputNode* node : nodes ){
+        node->staged = false;
+        batch->nodes.push_back( node );
+        if( node->inputs.empty() ){
+            batch->lists.push_back( &emptyInputs() );
+        }else{
+            batch->lists.push_back( new std::vector<OutputData>( node->inputs ) );
+        }
+    }
+    nodes.clear();
+
+    // the inputs are already updated, so what is compiled from the patch graph is also built here
+    batch->compilers = patchCompilers();
+    for( PatchCompiler* compiler : batch->compilers ){
+        compiler->compilePatch();
+    }
+
+    if( processingThread.load() == std::this_thread::get_id() ){
+        // repatching from inside the audio processing, there is no one to wait
+        batch->apply();
+    }else{
+        PatchBatch* expected = nullptr;
+        while( ! pendingBatch.compare_exchange_weak( expected, batch ) ){
+            expected = nullptr;
+            std::this_thread::yield();
+        }
+
+        // the audio thread applies the batch at the start of the next buffer,
+        // if it is not processing the batch is applied here
+        while( ! batch->applied.load() ){
+            int idle = PDSP_PATCHING_IDLE;
+            if( patchingState.compare_exchange_strong( idle, PDSP_PATCHING_APPLYING ) ){
+                PatchBatch* pending = pendingBatch.exchange( nullptr );
+                if( pending != nullptr ){
+                    pending->apply();
+                }
+                patchingState = PDSP_PATCHING_IDLE;
+            }else{
+                std::this_thread::sleep_for( std::chrono::microseconds( PDSP_REPATCH_WAIT_US ) );
+            }
+        }
+    }
+
+    // the audio thread has already moved to the new lists, the retired ones can be reclaimed
+    for( std::vector<OutputData>* old : batch->lists ){
+        if( old != &emptyInputs() ){
+            delete old;
+        }
+    }
+    for( PatchCompiler* compiler : batch->compilers ){
+        compiler->releasePatch();
+    }
+    delete batch;
+}
+
+void pdsp::InputNode::enterProcessing() noexcept {
+    if( processingDepth++ > 0 ) return;
+
+    // this waits only if the control thread is swapping the lists while the audio is stopped
+    int idle = PDSP_PATCHING_IDLE;
+    while( ! patchingState.compare_exchange_weak( idle, PDSP_PATCHING_PROCESSING ) ){
+        idle = PDSP_PATCHING_IDLE;
+    }
+    processingThread = std::this_thread::get_id();
+
+    PatchBatch* batch = pendingBatch.exchange( nullptr );
+    if( batch != nullptr ){
+        batch->apply();
+    }
+}
+
+void pdsp::InputNode::whileNotProcessing( const std::function<void()> & code ){
+    if( processingThread.load() == std::this_thread::get_id() ){
+        code();
+        return;
+    }
+
+    int idle = PDSP_PATCHING_IDLE;
+    while( ! patchingState.compare_exchange_strong( idle, PDSP_PATCHING_APPLYING ) ){
+        idle = PDSP_PATCHING_IDLE;
+        std::this_thread::sleep_for( std::chrono::microseconds( PDSP_REPATCH_WAIT_US ) );
+    }
+    code();
+    patchingState = PDSP_PATCHING_IDLE;
+}
+
+void pdsp::InputNode::exitProcessing() noexcept {
+    if( --processingDepth > 0 ) return;
+
+    processingThread = std::thread::id();
+    patchingState = PDSP_PATCHING_IDLE;
+}
+
 //------------------------INPUT NODE--------------------------------
 
 pdsp::InputNode::InputNode( int oversample ) {
@@ -24,6 +210,8 @@ pdsp::InputNode::InputNode( int oversample ) {
     state = Changed;
     inputs.clear();
     inputs.reserve( PDSP_NODE_POINTERS_RESERVE );
+    processedInputs = &emptyInputs();
+    staged = false;
 
     clampToBoundaries = false;
     lowBoundary = 0.0f;
@@ -45,14 +233,7 @@ pdsp::InputNode::InputNode( const InputNode& other ) : InputNode() { //forbid co
     lowBoundary = other.lowBoundary;
     highBoundary = other.highBoundary;
 
-    if( other.internalScalarIsConnected ) {
-        internalScalarIsConnected = true;
-        internalScalar.buffer[0] = other.internalScalar.buffer[0];
-    }
-
-    for( OutputData odata : other.inputs ) {
-        inputs.push_back( odata );
-    }
+    copyInputs( other );
 }
 
 
@@ -66,23 +247,37 @@ pdsp::InputNode& pdsp::InputNode::operator= ( const InputNode& other ) {
     lowBoundary = other.lowBoundary;
     highBoundary = other.highBoundary;
 
-    if( other.internalScalarIsConnected ) {
-        internalScalarIsConnected = true;
-        internalScalar.buffer[0] = other.internalScalar.buffer[0];
-    } else {
-        internalScalarIsConnected = false;
-    }
+    copyInputs( other );
+
+    return *this;
+}
 
-    for( OutputData odata : other.inputs ) {
-        inputs.push_back( odata );
+void pdsp::InputNode::copyInputs( const InputNode& other ) {
+    // the copied connections are registered to their outputs and staged like the ones made with connect()
+    // the internal float of the other input is replaced by this one
+    for( const OutputData & odata : other.inputs ) {
+        OutputNode* node = odata.node;
+        if( node == &other.internalScalar ) {
+            internalScalar = other.internalScalar;
+            internalScalarIsConnected = other.internalScalarIsConnected;
+            node = &internalScalar;
+        }
+        inputs.push_back( OutputData( node, odata.multiply, odata.multiplier ) );
+        connections++;
+        node->addInputToList( this );
     }
+    globalPatchingVersion++;
 
-    return *this;
+    if( ! inputs.empty() ) {
+        stageChange();
+    }
 }
 
 
 pdsp::InputNode::~InputNode() {
     disconnectAll();
+    // even inside a transaction the audio thread has to stop using this node now
+    publishStaged();
     buffer = nullptr;
     state = Changed;
 
@@ -126,19 +321,28 @@ void pdsp::InputNode::setRequiredOversampleLevel( int newOversample ) {
 void pdsp::InputNode::process() noexcept {
 
     int bufferSize = Preparable::turnBufferSize;
-
-    //process input buffers first
-    for( OutputData &odata : inputs ) {
-        if( odata.node->lastProcessedTurnId != OutputNode::getGlobalProcessingTurnId() && odata.node->parent != nullptr ) {
-            for( NamedOutput &outnode : odata.node->parent->outputs ) {
-                outnode.output->updateTurnId();
+    std::vector<OutputData> & processed = *processedInputs;
+
+    //process input buffers first, not needed if a Processor has already run its compiled schedule
+    if( recursivePull ) {
+        for( OutputData &odata : processed ) {
+            if( odata.node->lastProcessedTurnId != OutputNode::getGlobalProcessingTurnId() && odata.node->parent != nullptr ) {
+                for( NamedOutput &outnode : odata.node->parent->outputs ) {
+                    outnode.output->updateTurnId();
+                }
+                //process with the right buffer lenght according to oversample
+#ifdef PDSP_REALTIME_CHECKS
+                RealtimeChecker::UnitScope checkUnit( odata.node->parent );
+#endif
+#ifdef PDSP_PROFILING
+                Profiler::Scope profileUnit( odata.node->parent );
+#endif
+                odata.node->parent->process( bufferSize * odata.node->parent->getOversampleLevel() );
             }
-            //process with the right buffer lenght according to oversample
-            odata.node->parent->process( bufferSize * odata.node->parent->getOversampleLevel() );
         }
     }
 
-    switch( connections ) {
+    switch( processed.size() ) {
         bool multiplyNow;
 
     case 0: //NO INPUTS---------------------------------------
@@ -155,8 +359,8 @@ void pdsp::InputNode::process() noexcept {
 
     case 1: { //JUST ONE INPUT----------------------------------
         //starting extra scope
-        state = inputs.front().node->state;
-        multiplyNow = inputs.front().multiply;
+        state = processed.front().node->state;
+        multiplyNow = processed.front().multiply;
 
         int switcher = multiplyNow ? 1 : 0 ;
         if( clampToBoundaries ) {
@@ -170,10 +374,10 @@ void pdsp::InputNode::process() noexcept {
             case Unchanged:
             case Changed:
                 buffer = sumBuffer;
-                sumBuffer[0] = inputs.front().node->getCRValue();   //this is necessary for a thread safe ValueNode class
+                sumBuffer[0] = processed.front().node->getCRValue();   //this is necessary for a thread safe ValueNode class
                 break;
             case AudioRate:
-                buffer = inputs.front().node->buffer;
+                buffer = processed.front().node->buffer;
                 break;
             default: break;
             }
@@ -185,10 +389,10 @@ void pdsp::InputNode::process() noexcept {
             switch(state){
             case Unchanged:
             case Changed:
-                sumBuffer[0] = inputs.front().node->getCRValue() * inputs.front().multiplier;
+                sumBuffer[0] = processed.front().node->getCRValue() * processed.front().multiplier;
                 break;
             case AudioRate:
-                ofx_Aeq_BmulS( sumBuffer, inputs.front().node->buffer, inputs.front().multiplier, bufferSize * requiredOversampleLevel );
+                ofx_Aeq_BmulS( sumBuffer, processed.front().node->buffer, processed.front().multiplier, bufferSize * requiredOversampleLevel );
                 break;
             default: break;
             }
@@ -200,7 +404,7 @@ void pdsp::InputNode::process() noexcept {
             switch(state){
             case Unchanged:
             case Changed:
-                sumBuffer[0] = inputs.front().node->getCRValue();
+                sumBuffer[0] = processed.front().node->getCRValue();
                 if( sumBuffer[0]<lowBoundary ) {
                     sumBuffer[0] = lowBoundary;
                 } else if( sumBuffer[0] > highBoundary ) {
@@ -208,7 +412,7 @@ void pdsp::InputNode::process() noexcept {
                 }
                 break;
             case AudioRate:
-                ofx_Aeq_clipB( sumBuffer, inputs.front().node->buffer, lowBoundary, highBoundary, bufferSize * requiredOversampleLevel );
+                ofx_Aeq_clipB( sumBuffer, processed.front().node->buffer, lowBoundary, highBoundary, bufferSize * requiredOversampleLevel );
                 break;
             default: break;
             }
@@ -220,7 +424,7 @@ void pdsp::InputNode::process() noexcept {
             switch(state){
             case Unchanged:
             case Changed:
-                sumBuffer[0] = inputs.front().node->getCRValue() * inputs.front().multiplier;
+                sumBuffer[0] = processed.front().node->getCRValue() * processed.front().multiplier;
                 if( sumBuffer[0]<lowBoundary ) {
                     sumBuffer[0] = lowBoundary;
                 } else if( sumBuffer[0] > highBoundary ) {
@@ -228,7 +432,7 @@ void pdsp::InputNode::process() noexcept {
                 }
                 break;
             case AudioRate:
-                ofx_Aeq_BmulS( sumBuffer, inputs.front().node->buffer, inputs.front().multiplier, bufferSize * requiredOversampleLevel );
+                ofx_Aeq_BmulS( sumBuffer, processed.front().node->buffer, processed.front().multiplier, bufferSize * requiredOversampleLevel );
                 ofx_Aeq_clipB( sumBuffer, sumBuffer, lowBoundary, highBoundary, bufferSize * requiredOversampleLevel );
                 break;
             default: break;
@@ -268,8 +472,8 @@ void pdsp::InputNode::process() noexcept {
 
 
         //for( const OutputData &odata : inputs ) {
-        for(int i=0; i<connections; ++i ) {
-            OutputData& odata = inputs[i];
+        for(size_t i=0; i<processed.size(); ++i ) {
+            OutputData& odata = processed[i];
             OutputNode* nodei = odata.node;
             //combined switch
             int tripleSwitch = nodei->state + state*4; 
@@ -426,6 +630,7 @@ void pdsp::InputNode::connect( OutputNode& output ) {
         }
     }
 
+    stageChange();
 }
 
 
@@ -437,12 +642,8 @@ void pdsp::InputNode::disconnect( OutputNode& output ) {
             output.removeOutputFromList( this );
             inputs.erase( it );
             connections--;
-            if( connections==1 ) {
-                buffer = inputs.front().node->buffer;
-            } else if( connections==0 ) {
-                buffer = nullptr;
-                state = Changed;
-            }
+            // buffer and state are updated by the audio thread when it processes the new list
+            stageChange();
             break;
         }
         it++;
@@ -452,14 +653,16 @@ void pdsp::InputNode::disconnect( OutputNode& output ) {
 
 void pdsp::InputNode::disconnectAll() {
 
+    bool wasConnected = ! inputs.empty();
     for( const OutputData &odata : inputs ) {
         odata.node->removeOutputFromList( this );
     }
     inputs.clear();
-    buffer = nullptr;
     connections = 0;
-    state = Changed;
     internalScalarIsConnected = false;
+    if( wasConnected ) {
+        stageChange();
+    }
 
 }
 
@@ -471,11 +674,7 @@ void pdsp::InputNode::removeInputUnilateral( const OutputNode& outputNode ) {
         if( ( *it ).node == &outputNode ) {
             inputs.erase( it );
             connections--;
-            if( connections==1 ) {
-                buffer = inputs.front().node->buffer;
-            } else if( connections==0 ) {
-                buffer = nullptr;
-            }
+            stageChange();
             break;
         }
         it++;
@@ -526,6 +725,41 @@ bool pdsp::InputNode::exists() {
     return true;
 }
 
+int pdsp::InputNode::getGlobalPatchingVersion() {
+    return globalPatchingVersion;
+}
+
+bool pdsp::InputNode::isZeroAtControlRate() const noexcept {
+    const std::vector<OutputData> & processed = *processedInputs;
+
+    if( processed.empty() ) {
+        return false;
+    }
+
+    // the same sum of process()
+    float scalarSum = 0.0f;
+    for( const OutputData &odata : processed ) {
+        if( odata.node->parent == nullptr || odata.node->state == AudioRate ) {
+            return false;
+        }
+        if( odata.multiply ) {
+            scalarSum += odata.node->getCRValue() * odata.multiplier;
+        } else {
+            scalarSum += odata.node->getCRValue();
+        }
+    }
+
+    if( clampToBoundaries ) {
+        if( scalarSum<lowBoundary ) {
+            scalarSum = lowBoundary;
+        } else if( scalarSum > highBoundary ) {
+            scalarSum = highBoundary;
+        }
+    }
+
+    return ( scalarSum == 0.0f );
+}
+
 //------------------------OUTPUT NODE--------------------------------
 
 pdsp::OutputNode::OutputNode( int oversample ) {
@@ -575,6 +809,8 @@ pdsp::OutputNode& pdsp::OutputNode::operator= ( const OutputNode& other ) { //ru
 
 pdsp::OutputNode::~OutputNode() {
     disconnectAll();
+    // no input of the audio thread can still point to this node
+    InputNode::publishStaged();
     if( buffer!=nullptr ) {
         ofx_deallocate_aligned( buffer );
     }
@@ -782,9 +1018,25 @@ void pdsp::ValueNode::releaseResources() {  }
 
 pdsp::Unit::Unit() {
     oversample = initOversampleLevel;
+    compileStamp = 0;
+    compileIndex = -1;
+#ifdef PDSP_PROFILING
+    profile = Profiler::add( this );
+#endif
+}
+
+pdsp::Unit::~Unit() {
+#ifdef PDSP_PROFILING
+    Profiler::remove( profile );
+#endif
 }
 
 pdsp::Unit::Unit(const Unit & other){
+    compileStamp = 0;
+    compileIndex = -1;
+#ifdef PDSP_PROFILING
+    profile = Profiler::add( this );
+#endif
     std::cout<<"[pdsp] warning, Unit copy constructed, undefined behavior\n";
     pdsp_trace();
 }
@@ -795,6 +1047,11 @@ pdsp::Unit& pdsp::Unit::operator= (const Unit & other){
 }
 
 pdsp::Unit::Unit (Unit&& other){
+    compileStamp = 0;
+    compileIndex = -1;
+#ifdef PDSP_PROFILING
+    profile = Profiler::add( this );
+#endif
     std::cout<<"[pdsp] warning, Unit move constructed, undefined behavior\n";
     pdsp_trace();
 }
@@ -1037,6 +1294,7 @@ void pdsp::Unit::updateOutputNodes() {
     for( NamedOutput &item : outputs ) {
         item.output->setParent( this );
     }
+    InputNode::globalPatchingVersion++;
     resetInputToDefault();
     resetOutputToDefault();
 }
@@ -18,8 +18,11 @@
 #include "../pdspConstants.h"
 #include "../../math/header.h"
 #include "Preparable.h"
+#include "Profiler.h"
 #include <cstring>
 #include <atomic>
+#include <thread>
+#include <functional>
 #include <iostream>
 #include "../../flags.h"
 
@@ -32,10 +35,36 @@ class ValueNode;
 class NullInput;
 class NullOutput;
 
+/*!
+@brief starts a repatching transaction, all the connections and disconnections made until the matching commitRepatch() will be applied together.
+
+Outside of a transaction every connection is applied on its own. Inside a transaction the changes are staged on the control thread and the audio thread sees all of them at the same time, at the start of a buffer, so a new patch can't be heard half-made. Transactions can be nested, only the outer commit publishes. Destroying a Unit inside a transaction publishes the changes staged until then.
+*/
+void beginRepatch();
+
+/*!
+@brief ends a repatching transaction, publishes all the staged changes to the audio thread and returns when they are applied.
+*/
+void commitRepatch();
+
 /*!
     @cond HIDDEN_SYMBOLS
 */
 
+class PatchBatch;
+
+// something compiled from the patch graph, for example the schedule of a Processor in compiled graph mode
+// it is compiled again each time some changes are published, the inputs are already updated when it is called
+class PatchCompiler {
+public:
+    // called before the changes are applied, all the allocations are made here on the control thread
+    virtual void compilePatch() = 0;
+    // called when the changes are applied, by the audio thread or while it is not processing
+    virtual void applyPatch() noexcept = 0;
+    // called after the changes are applied, the compiled data retired by applyPatch() is released here
+    virtual void releasePatch() = 0;
+};
+
 //-------------------------------------OUTPUT DATA------------------------------------------------
 class OutputData {
 public:
@@ -83,6 +112,8 @@ class Patchable {
     friend class Unit;
     friend class InputNode;
     friend class Switch;
+    friend class Processor;
+    friend class Profiler;
     
 public:
     Patchable();
@@ -222,6 +253,9 @@ Unit is the base class for implementing all the DSPs. It has inputs and outputs
 
 class Unit :  public Preparable, public Patchable {
     friend class InputNode;
+    friend class Processor;
+    friend class AudioWorkerPool;
+    friend class Profiler;
 
 public:
     Unit();
@@ -332,13 +366,20 @@ protected:
     */  
     void            updateOutputNodes();
     
-    virtual ~Unit() {};    
+    virtual ~Unit();    
     
 
     
 private:
 
     int oversample;
+#ifdef PDSP_PROFILING
+    UnitProfile* profile;
+#endif
+
+    // used by the Processor to mark the visited Units while compiling its schedule
+    int compileStamp;
+    int compileIndex;
 
 };
 
@@ -362,6 +403,7 @@ class OutputNode : public Preparable {
     friend class UpSampler;
     friend class DownSampler;
     friend class Patchable;
+    friend class Profiler;
     
 public:
 
@@ -543,6 +585,12 @@ class InputNode : public Preparable
     friend class UpSampler;
     friend class DownSampler;
     friend class Patchable;
+    friend class Processor;
+    friend class AudioWorkerPool;
+    friend class Profiler;
+    friend class PatchBatch;
+    friend void beginRepatch();
+    friend void commitRepatch();
 
 public:
     InputNode( int oversample );
@@ -624,6 +672,22 @@ public:
     @brief returns the oversample level required by this InputNode
     */  
     int getRequiredOversampleLevel() const;
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    static int getGlobalPatchingVersion();
+
+    // true if processing this input now would give 0.0f at control rate, checked without processing
+    // only the outputs of Units count, the internal float and the ValueNodes can be set by other threads
+    bool isZeroAtControlRate() const noexcept;
+
+    // runs the code on the calling thread between two audio buffers, waiting for the end of the current one
+    // the audio thread waits for the code if the next buffer starts, so it should only swap some pointers
+    static void whileNotProcessing( const std::function<void()> & code );
+/*!
+    @endcond
+*/
     
     //void connectExclusive( OutputNode& outputNode );    
     //virtual void connectFloatExclusive( float value );
@@ -652,6 +716,20 @@ private:
     int connections;
     std::vector<OutputData> inputs;
 
+    // inputs is only touched by the control thread, the audio thread reads this copy
+    // that is swapped at the start of a buffer when the staged changes are published
+    std::vector<OutputData>* processedInputs;
+    bool staged;
+
+    void stageChange();
+    void copyInputs( const InputNode & other );
+    static void publishStaged();
+    static void enterProcessing() noexcept;
+    static void exitProcessing() noexcept;
+    static std::vector<OutputData> & emptyInputs();
+    static std::vector<InputNode*> & stagedNodes();
+    static std::vector<PatchCompiler*> & patchCompilers();
+
     bool internalScalarIsConnected;
     ValueNode internalScalar;
 
@@ -661,6 +739,16 @@ private:
     float defaultValue;
     
     int requiredOversampleLevel;   
+
+    static std::atomic<int> globalPatchingVersion;
+    // each thread running a compiled schedule turns it off for itself
+    static thread_local bool recursivePull;
+
+    static int repatchDepth;
+    static int processingDepth;
+    static std::atomic<int> patchingState;
+    static std::atomic<PatchBatch*> pendingBatch;
+    static std::atomic<std::thread::id> processingThread;
 };
 
 /*!
@@ -68,6 +68,7 @@ void pdsp::PatchNode::process(int bufferSize) noexcept {
 
 void pdsp::PatchNode::disableAutomaticProcessing(){
         output.parent = nullptr;
+        InputNode::globalPatchingVersion++;
 }
 
 int pdsp::PatchNode::getState(){
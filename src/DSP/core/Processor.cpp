@@ -1,23 +1,48 @@
 
 #include "Processor.h"
+#include "Switch.h"
+#include "Amp.h"
+#include "RealtimeChecker.h"
 #include <iostream>
+#include <algorithm>
 
 pdsp::Processor::Processor(int channels){
         this->channels.resize(channels);
         for(int i=0; i<channels; ++i){
                 this->channels[i].disableAutomaticProcessing();
         }
+        
+        compiledGraph = false;
+        compiled = nullptr;
+        staged = nullptr;
+        retired = nullptr;
 }
 
 pdsp::Processor::Processor() : Processor(PDSP_MAX_OUTPUT_CHANNELS) {} 
 
+pdsp::Processor::~Processor(){
+        setCompiledGraph( false );
+        pool.stop();
+}
+
+int pdsp::Processor::compileStamp = 0;
+
 void pdsp::Processor::process(const int &bufferSize) noexcept{
+#ifdef PDSP_REALTIME_CHECKS
+        RealtimeChecker::Scope check;
+#endif
+        InputNode::enterProcessing();
         OutputNode::nextTurn();
         Preparable::setTurnBufferSize(bufferSize);
 
+        runSchedule( bufferSize );
+
         for (size_t i=0; i<channels.size(); ++i){
                 channels[i].process(bufferSize);
         }
+        
+        InputNode::recursivePull = true;
+        InputNode::exitProcessing();
 }
 
 void pdsp::Processor::resize( int channelsNum ){
@@ -25,13 +50,22 @@ void pdsp::Processor::resize( int channelsNum ){
         for(int i=0; i<channelsNum; ++i){
                 this->channels[i].disableAutomaticProcessing();
     }    
+        if( compiledGraph ){
+                publishSchedule();
+        }
 }
 
 void pdsp::Processor::processAndCopyOutput(float** bufferToFill, const int &channelsNum, const int &bufferSize) noexcept{
      
+#ifdef PDSP_REALTIME_CHECKS
+        RealtimeChecker::Scope check;
+#endif
+        InputNode::enterProcessing();
         OutputNode::nextTurn();
         Preparable::setTurnBufferSize(bufferSize);
         
+        runSchedule( bufferSize );
+        
         for( int i=0; i< int(channels.size()); ++i ){
                 
                 channels[i].process(bufferSize);
@@ -52,11 +86,18 @@ void pdsp::Processor::processAndCopyOutput(float** bufferToFill, const int &chan
         }
         
         blackhole.process(bufferSize);
+        
+        InputNode::recursivePull = true;
+        InputNode::exitProcessing();
 }
 
 
 void pdsp::Processor::processAndCopyInterleaved(float* bufferToFill, const int &channelsNum, const int &bufferSize) noexcept{
       
+#ifdef PDSP_REALTIME_CHECKS
+        RealtimeChecker::Scope check;
+#endif
+        InputNode::enterProcessing();
         OutputNode::nextTurn();
         Preparable::setTurnBufferSize(bufferSize);
         
@@ -67,6 +108,8 @@ void pdsp::Processor::processAndCopyInterleaved(float* bufferToFill, const int &
             min = channelsNum;
         }
         
+        runSchedule( bufferSize );
+        
         for(int i=0; i<min; ++i){
                 
                 channels[i].process(bufferSize);
@@ -86,6 +129,381 @@ void pdsp::Processor::processAndCopyInterleaved(float* bufferToFill, const int &
         }
  
         blackhole.process(bufferSize);
+        
+        InputNode::recursivePull = true;
+        InputNode::exitProcessing();
+
+}
+
+void pdsp::Processor::setCompiledGraph( bool active ){
+        if( active == compiledGraph ) return;
+        compiledGraph = active;
+        
+        // the registered Processors are compiled again by the control thread each time the patch changes
+        std::vector<PatchCompiler*> & compilers = InputNode::patchCompilers();
+        InputNode::whileNotProcessing( [&](){
+                if( active ){
+                        compilers.push_back( this );
+                }else{
+                        compilers.erase( std::remove( compilers.begin(), compilers.end(), this ), compilers.end() );
+                }
+        });
+        
+        publishSchedule();
+}
+
+void pdsp::Processor::setParallelThreads( int threads ){
+        pool.start( threads );
+        if( threads > 1 && ! compiledGraph ){
+                setCompiledGraph( true );
+        }else if( compiledGraph ){
+                publishSchedule();
+        }
+}
+
+int pdsp::Processor::getParallelThreads() const {
+        return pool.getThreads();
+}
+
+void pdsp::Processor::runSchedule( int bufferSize ) noexcept {
+        
+        // the schedule is only swapped between two buffers, it is compiled on the control thread
+        Schedule* s = compiled.load();
+        if( s == nullptr || s->channels != int(channels.size()) ){
+                return;
+        }
+        
+        // the schedule is already sorted, so the inputs don't have to pull the Units they depend on
+        InputNode::recursivePull = false;
+        
+        if( s->tasks.getThreads() > 1 && s->tasks.getThreads() == pool.getThreads() ){
+                pool.run( s->tasks, bufferSize );
+        }else{
+                const std::vector<SleepGate> & gates = s->gates;
+                for( size_t i=0; i<s->units.size(); ++i ){
+                        if( s->unitGates[i] >= 0 && gates[ s->unitGates[i] ].sleeping( gates ) ){
+                                continue;
+                        }
+                        Unit* unit = s->units[i];
+#ifdef PDSP_REALTIME_CHECKS
+                        RealtimeChecker::UnitScope checkUnit( unit );
+#endif
+#ifdef PDSP_PROFILING
+                        Profiler::Scope profileUnit( unit );
+#endif
+                        unit->process( bufferSize * unit->getOversampleLevel() );
+                }
+        }
+}
 
+void pdsp::Processor::compilePatch(){
+        delete staged;
+        staged = compiledGraph ? compileSchedule() : nullptr;
+}
+
+void pdsp::Processor::applyPatch() noexcept {
+        if( staged != nullptr ){
+                retire( compiled.exchange( staged ) );
+                staged = nullptr;
+        }
+}
+
+void pdsp::Processor::releasePatch(){
+        releaseRetired();
+}
+
+void pdsp::Processor::publishSchedule(){
+        Schedule* next = compiledGraph ? compileSchedule() : nullptr;
+        InputNode::whileNotProcessing( [&](){ retire( compiled.exchange( next ) ); } );
+        releaseRetired();
+}
+
+void pdsp::Processor::retire( Schedule* old ) noexcept {
+        if( old != nullptr ){
+                old->nextRetired = retired;
+                retired = old;
+        }
+}
+
+void pdsp::Processor::releaseRetired(){
+        // when the patch is changed from inside the audio processing the old schedule 
+        // could still be running, it is released by the next change on the control thread 
+        if( InputNode::processingThread.load() == std::this_thread::get_id() ){
+                return;
+        }
+        while( retired != nullptr ){
+                Schedule* next = retired->nextRetired;
+                delete retired;
+                retired = next;
+        }
+}
+
+pdsp::Processor::Schedule* pdsp::Processor::compileSchedule(){
+        // this runs on the control thread and reads the inputs that are going to be published
+        Schedule* s = new Schedule();
+        s->channels = channels.size();
+        s->nextRetired = nullptr;
+        
+        // a new stamp marks all the Units as not visited, without clearing anything
+        compileStamp++;
+        
+        for( size_t i=0; i<channels.size(); ++i ){
+                scheduleInput( *s, channels[i].input );
+        }
+        scheduleInput( *s, blackhole.input );
+        
+        compileGates( *s );
+        
+        if( pool.getThreads() > 1 ){
+                compileTasks( *s );
+        }
+        
+        return s;
+}
+
+void pdsp::Processor::scheduleInput( Schedule & s, InputNode & input ){
+        for( OutputData &odata : input.inputs ) {
+                if( odata.node->parent != nullptr ){
+                        scheduleUnit( s, odata.node->parent );
+                }
+        }
+}
+
+void pdsp::Processor::scheduleUnit( Schedule & s, Unit* unit ){
+        // units already visited are skipped, this also breaks feedback loops 
+        // in the same way of the recursive processing
+        if( unit->compileStamp == compileStamp ){
+                return;
+        }
+        unit->compileStamp = compileStamp;
+        unit->compileIndex = -1;
+        
+        std::vector<InputNode*> unitInputs;
+        getUnitInputs( unit, unitInputs );
+        for( InputNode* input : unitInputs ) {
+                scheduleInput( s, *input );
+        }
+        
+        // post-order: a Unit is scheduled after all the Units it depends on
+        unit->compileIndex = s.units.size();
+        s.units.push_back( unit );
 }
 
+void pdsp::Processor::getUnitInputs( Unit* unit, std::vector<InputNode*> & list ){
+        // the Units patched to the Amp mod are scheduled before the ones patched to its signal,
+        // so when those are processed it is already known if they sleep
+        Amp* amp = dynamic_cast<Amp*>( unit );
+        if( amp != nullptr ){
+                list.push_back( &amp->input_mod );
+        }
+        
+        for( NamedInput &item : unit->inputs ) {
+                if( amp != nullptr && item.input == &amp->input_mod ) continue;
+                list.push_back( item.input );
+        }
+        
+        // Switch has a vector of inputs not added to the Patchable ones
+        Switch* switcher = dynamic_cast<Switch*>( unit );
+        if( switcher != nullptr ){
+                for( InputNode &input : switcher->inputs ) {
+                        list.push_back( &input );
+                }
+        }
+}
+
+void pdsp::Processor::compileTasks( Schedule & s ){
+        
+        const std::vector<Unit*> & schedule = s.units;
+        
+        // the index of a scheduled Unit, or -1 if the Unit is not in the schedule
+        auto indexOf = []( Unit* unit ){
+                return ( unit != nullptr && unit->compileStamp == compileStamp ) ? unit->compileIndex : -1;
+        };
+        
+        // producers that comes later in the schedule are feedback connections, 
+        // they are already processed after this Unit as they depend on it
+        std::vector<std::vector<int>> producers( schedule.size() );
+        std::vector<InputNode*> unitInputs;
+        
+        auto addProducers = [&]( const InputNode* input, int i ){
+                for( const OutputData &odata : input->inputs ) {
+                        int p = indexOf( odata.node->parent );
+                        if( p < 0 || p >= i ) continue;
+                        std::vector<int> & list = producers[i];
+                        if( std::find( list.begin(), list.end(), p ) == list.end() ){
+                                list.push_back( p );
+                        }
+                }
+        };
+        
+        for( size_t i=0; i<schedule.size(); ++i ){
+                unitInputs.clear();
+                getUnitInputs( schedule[i], unitInputs );
+                for( InputNode* input : unitInputs ){
+                        addProducers( input, i );
+                }
+                
+                // a sleeping Unit has to wait the Units that decide if it sleeps
+                for( int g = s.unitGates[i]; g >= 0; g = s.gates[g].outer ){
+                        addProducers( s.gates[g].mod, i );
+                }
+        }
+        
+        s.tasks.compile( schedule, producers, s.unitGates, s.gates, pool.getThreads() );
+}
+
+void pdsp::Processor::compileGates( Schedule & s ){
+        
+        const std::vector<Unit*> & schedule = s.units;
+        int size = schedule.size();
+        
+        s.gates.clear();
+        s.unitGates.assign( size, -1 );
+        
+        auto indexOf = []( Unit* unit ){
+                return ( unit != nullptr && unit->compileStamp == compileStamp ) ? unit->compileIndex : -1;
+        };
+        
+        // the Amps, numbered in schedule order
+        std::vector<Amp*> amps;
+        std::vector<int> ampUnits;
+        std::vector<int> ampNumbers( size, -1 );
+        for( int u=0; u<size; ++u ){
+                Amp* amp = dynamic_cast<Amp*>( schedule[u] );
+                if( amp != nullptr ){
+                        ampNumbers[u] = amps.size();
+                        amps.push_back( amp );
+                        ampUnits.push_back( u );
+                }
+        }
+        int ampCount = amps.size();
+        if( ampCount == 0 ) return;
+        
+        // the inputs patched to the outputs of each Unit, as the Unit owning the input and if it is the signal of an Amp
+        // the channels and the blackhole inputs have no owner, so what is patched to them never sleeps
+        struct Consumer {
+                int     unit;
+                bool    signal;
+        };
+        std::vector<std::vector<Consumer>> consumers( size );
+        std::vector<InputNode*> unitInputs;
+        bool feedback = false;
+        
+        auto addConsumer = [&]( InputNode* input, int owner, bool signal ){
+                for( OutputData &odata : input->inputs ) {
+                        int u = indexOf( odata.node->parent );
+                        if( u >= 0 ){
+                                consumers[u].push_back( Consumer{ owner, signal } );
+                                if( owner >= 0 && owner <= u ){
+                                        feedback = true;
+                                }
+                        }
+                }
+        };
+        
+        for( int i=0; i<size; ++i ){
+                unitInputs.clear();
+                getUnitInputs( schedule[i], unitInputs );
+                for( InputNode* input : unitInputs ){
+                        bool signal = ampNumbers[i] >= 0 && input == &amps[ ampNumbers[i] ]->input_signal;
+                        addConsumer( input, i, signal );
+                }
+        }
+        for( size_t i=0; i<channels.size(); ++i ){
+                addConsumer( &channels[i].input, -1, false );
+        }
+        addConsumer( &blackhole.input, -1, false );
+        
+        // a Unit is in the region of an Amp if all its outputs go to the Amp signal, directly or through other Units of the region
+        // the regions containing each Unit are a bit set of the Amp numbers, taken from the ones of its consumers
+        // the schedule is sorted by dependencies, so going backward the consumers come first and one pass is enough,
+        // with feedback loops the sets start full and the passes are repeated until they don't change anymore
+        int words = ( ampCount + 63 ) / 64;
+        std::vector<uint64_t> regionsOf( size * words, ~uint64_t(0) );
+        std::vector<uint64_t> regions( words );
+        
+        bool changed = true;
+        while( changed ){
+                changed = false;
+                for( int u=size-1; u>=0; --u ){
+                        std::fill( regions.begin(), regions.end(), consumers[u].empty() ? 0 : ~uint64_t(0) );
+                        for( const Consumer & consumer : consumers[u] ){
+                                if( consumer.unit < 0 ){
+                                        std::fill( regions.begin(), regions.end(), 0 );
+                                        break;
+                                }
+                                const uint64_t* other = &regionsOf[ consumer.unit * words ];
+                                for( int w=0; w<words; ++w ){
+                                        uint64_t bits = other[w];
+                                        if( consumer.signal && ampNumbers[consumer.unit] / 64 == w ){
+                                                bits |= uint64_t(1) << ( ampNumbers[consumer.unit] % 64 );
+                                        }
+                                        regions[w] &= bits;
+                                }
+                        }
+                        // an Amp is never in its own region
+                        if( ampNumbers[u] >= 0 ){
+                                regions[ ampNumbers[u] / 64 ] &= ~( uint64_t(1) << ( ampNumbers[u] % 64 ) );
+                        }
+                        
+                        uint64_t* current = &regionsOf[ u * words ];
+                        for( int w=0; w<words; ++w ){
+                                if( current[w] != regions[w] ){
+                                        current[w] = regions[w];
+                                        changed = true;
+                                }
+                        }
+                }
+                if( ! feedback ) break;
+        }
+        
+        auto inRegion = [&]( int u, int a ){
+                return ( regionsOf[ u * words + a / 64 ] >> ( a % 64 ) ) & 1;
+        };
+        
+        std::vector<int> regionSize( ampCount, 0 );
+        std::vector<int> regionStart( ampCount, -1 );
+        for( int u=0; u<size; ++u ){
+                for( int a=0; a<ampCount; ++a ){
+                        if( inRegion( u, a ) ){
+                                regionSize[a]++;
+                                if( regionStart[a] < 0 ) regionStart[a] = u;
+                        }
+                }
+        }
+        
+        std::vector<int> gateIndex( ampCount, -1 );
+        std::vector<int> gateUnits;
+        for( int a=0; a<ampCount; ++a ){
+                if( regionSize[a] == 0 || amps[a]->input_mod.inputs.empty() ) continue;
+                
+                // the Units patched to the mod input have to be processed before the region
+                bool modFirst = true;
+                for( OutputData &odata : amps[a]->input_mod.inputs ) {
+                        int p = indexOf( odata.node->parent );
+                        if( p < 0 || p > regionStart[a] ){
+                                modFirst = false;
+                        }
+                }
+                if( ! modFirst ) continue;
+                
+                gateIndex[a] = gateUnits.size();
+                gateUnits.push_back( ampUnits[a] );
+        }
+        
+        // the nested regions are smaller, each Unit takes its innermost gate
+        for( int u=0; u<size; ++u ){
+                int innermost = -1;
+                for( int a=0; a<ampCount; ++a ){
+                        if( gateIndex[a] >= 0 && inRegion( u, a ) && ( innermost < 0 || regionSize[a] < regionSize[innermost] ) ){
+                                innermost = a;
+                        }
+                }
+                s.unitGates[u] = ( innermost >= 0 ) ? gateIndex[innermost] : -1;
+        }
+        
+        for( size_t g=0; g<gateUnits.size(); ++g ){
+                Amp* amp = static_cast<Amp*>( schedule[ gateUnits[g] ] );
+                s.gates.push_back( SleepGate( &amp->input_mod, s.unitGates[ gateUnits[g] ] ) );
+        }
+}
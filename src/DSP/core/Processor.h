@@ -8,6 +8,7 @@
 
 #include "BasicNodes.h"
 #include "PatchNode.h"
+#include "AudioWorkerPool.h"
 #include <vector>
 
 namespace pdsp{
@@ -16,13 +17,18 @@ namespace pdsp{
     @brief The bridge between pdsp and the audio callback
     
     One of the processAndCopy... method of this class has to be called inside the audio callback, it will recursively process all the Units and modules patched to the input channels and copy the results to the audio callback. The standard constructor has 2 channels, but you can change the number of channels simply using resize() on the channels vector.
+    
+    Optionally the Processor can compile the patch graph into a flat schedule of Units sorted by their dependencies, see setCompiledGraph(), and process the independent parts of it on multiple threads, see setParallelThreads().
     */   
 
-class Processor {
+class Processor : public PatchCompiler {
+    friend class Profiler;
+
 public:
 
     Processor( int channels );
     Processor();
+    ~Processor();
         
     /*!
     @brief simply process the channes without copying them, useful if you want just to split the processing in multiple calls.
@@ -62,6 +68,62 @@ public:
     @brief all the connectio patched to this will be processed but not outputted. Patch your Units and modules to this channels if you need them to be always active for some reason;
     */  
     PatchNode blackhole;
+    
+    /*!
+    @brief activates or deactivates the compiled graph mode, deactivated by default.
+    @param[in] active true to activate, false to go back to recursive processing
+
+    When the compiled graph mode is active all the Units reachable from the channels and from the blackhole are sorted by their dependencies and then processed as a flat list, without recursively pulling the inputs, also when process() is used or when processAndCopyInterleaved() outputs less channels. The schedule is compiled again on the control thread each time some connections are published and the audio thread just swaps it in at the start of the next buffer, so it never allocates for it. If the channels vector is resized without resize() the Processor goes back to recursive processing until the next change. The Units that are patched only to the signal input of an Amp sleep while the Amp mod input is 0.0f at control rate, as in the recursive processing, so the oscillators and filters of a voice are skipped while its envelope is in the off stage. They are woken up in the same buffer of the trigger and they restart from the state they had before sleeping. A Unit sleeps only if all the Units patched to its outputs also sleep, and only if the mod input is patched to the outputs of other Units, a value patched or set to the mod input never makes the voice sleep. Remember that the other Units reachable from the channels are processed at each buffer, also the ones that would be skipped by the recursive processing, for example the unselected inputs of a Switch.
+    */  
+    void setCompiledGraph( bool active );
+    
+    /*!
+    @brief sets the number of threads used for processing, 1 by default. Call it only when the audio processing is not running.
+    @param[in] threads number of threads, the audio thread included
+
+    With more than one thread the compiled graph mode is activated, the Units of the schedule are grouped in tasks following their dependencies and the independent tasks (for example the voices of a synth patched to the channels) are processed by a pool of worker threads started by this method, stealing work from each other. The audio thread is also one of the workers and it waits for all the tasks before copying the channels to the output. The output is the same of the serial processing, as long as your Units don't share some state outside of the patching (for example the same FFT worker or random generator). Passing 1 stops the worker threads.
+    */  
+    void setParallelThreads( int threads );
+    
+    /*!
+    @brief returns the number of threads used for processing.
+    */  
+    int getParallelThreads() const;
+    
+private:
+
+    // all the compiled data used by the audio thread, it is never changed after being published
+    struct Schedule {
+        std::vector<Unit*>      units;
+        std::vector<SleepGate>  gates;
+        std::vector<int>        unitGates;
+        TaskGraph               tasks;
+        int                     channels;
+        Schedule*               nextRetired;
+    };
+
+    void compilePatch() override;
+    void applyPatch() noexcept override;
+    void releasePatch() override;
+
+    void runSchedule( int bufferSize ) noexcept;
+    void publishSchedule();
+    void retire( Schedule* old ) noexcept;
+    void releaseRetired();
+    Schedule* compileSchedule();
+    void scheduleInput( Schedule & s, InputNode & input );
+    void scheduleUnit( Schedule & s, Unit* unit );
+    void compileGates( Schedule & s );
+    void compileTasks( Schedule & s );
+    static void getUnitInputs( Unit* unit, std::vector<InputNode*> & list );
+    
+    bool                        compiledGraph;
+    std::atomic<Schedule*>      compiled;
+    Schedule*                   staged;
+    Schedule*                   retired;
+    AudioWorkerPool             pool;
+    
+    static int                  compileStamp;
 };
         
         
@@ -0,0 +1,433 @@
+
+#include "Profiler.h"
+#include "Processor.h"
+#include <chrono>
+#include <algorithm>
+#include <typeinfo>
+#include <cstdlib>
+#include <cstdio>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+#ifdef PDSP_PROFILING
+static thread_local pdsp::Profiler::Scope* profilerScope = nullptr;
+#endif
+
+std::atomic<bool> pdsp::Profiler::active( true );
+
+pdsp::UnitProfile::UnitProfile( const Unit* unit ) : unit( unit ) {
+    turn = -1;
+    nanoseconds = 0;
+    calls = 0;
+    for( int i=0; i<PDSP_PROFILER_HISTORY; ++i ){
+        turns[i] = 0;
+        times[i] = 0;
+    }
+    written = 0;
+    totalCalls = 0;
+    writtenAtReset = 0;
+    callsAtReset = 0;
+}
+
+pdsp::Profiler::Scope::Scope( Unit* unit ) noexcept {
+#ifdef PDSP_PROFILING
+    profile = active.load( std::memory_order_relaxed ) ? unit->profile : nullptr;
+    parent = profilerScope;
+    profilerScope = this;
+    children = 0;
+    start = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+#endif
+}
+
+pdsp::Profiler::Scope::~Scope() noexcept {
+#ifdef PDSP_PROFILING
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() - start;
+
+    // the time spent into the pulled Units is not counted for the parent Unit
+    profilerScope = parent;
+    if( parent != nullptr ){
+        parent->children += elapsed;
+    }
+
+    if( profile != nullptr ){
+        int turn = OutputNode::getGlobalProcessingTurnId();
+        if( turn != profile->turn ){
+            if( profile->calls > 0 ){
+                uint32_t index = profile->written.load( std::memory_order_relaxed );
+                int64_t ns = ( profile->nanoseconds < int64_t(UINT32_MAX) ) ? profile->nanoseconds : int64_t(UINT32_MAX);
+                profile->turns[ index % PDSP_PROFILER_HISTORY ].store( profile->turn, std::memory_order_relaxed );
+                profile->times[ index % PDSP_PROFILER_HISTORY ].store( uint32_t(ns), std::memory_order_relaxed );
+                profile->totalCalls.fetch_add( profile->calls, std::memory_order_relaxed );
+                profile->written.store( index + 1, std::memory_order_release );
+            }
+            profile->turn = turn;
+            profile->nanoseconds = 0;
+            profile->calls = 0;
+        }
+        profile->nanoseconds += elapsed - children;
+        profile->calls++;
+    }
+#endif
+}
+
+pdsp::Profiler & pdsp::Profiler::get(){
+    // never destroyed, so Units with static storage can be removed at exit
+    static Profiler* profiler = new Profiler();
+    return *profiler;
+}
+
+pdsp::UnitProfile* pdsp::Profiler::add( const Unit* unit ){
+    UnitProfile* profile = new UnitProfile( unit );
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+    profiler.profiles.push_back( profile );
+    return profile;
+}
+
+void pdsp::Profiler::remove( UnitProfile* profile ){
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+    profiler.profiles.erase( std::remove( profiler.profiles.begin(), profiler.profiles.end(), profile ), profiler.profiles.end() );
+    delete profile;
+}
+
+void pdsp::Profiler::setActive( bool active ){
+    Profiler::active = active;
+}
+
+void pdsp::Profiler::reset(){
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+    for( UnitProfile* profile : profiler.profiles ){
+        profile->writtenAtReset = profile->written.load();
+        profile->callsAtReset = profile->totalCalls.load();
+    }
+}
+
+void pdsp::Profiler::addModule( Patchable & module, std::string name ){
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+    for( size_t i=0; i<profiler.modules.size(); ++i ){
+        if( profiler.modules[i] == &module ){
+            profiler.moduleNames[i] = name;
+            return;
+        }
+    }
+    profiler.modules.push_back( &module );
+    profiler.moduleNames.push_back( name );
+}
+
+void pdsp::Profiler::removeModule( Patchable & module ){
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+    for( size_t i=0; i<profiler.modules.size(); ++i ){
+        if( profiler.modules[i] == &module ){
+            profiler.modules.erase( profiler.modules.begin() + i );
+            profiler.moduleNames.erase( profiler.moduleNames.begin() + i );
+            return;
+        }
+    }
+}
+
+std::string pdsp::Profiler::getName( const Unit* unit ){
+    const char* name = typeid( *unit ).name();
+#if defined(__GNUC__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle( name, nullptr, nullptr, &status );
+    std::string result = ( status == 0 && demangled != nullptr ) ? demangled : name;
+    std::free( demangled );
+    return result;
+#else
+    return name;
+#endif
+}
+
+void pdsp::Profiler::collect( const UnitProfile* profile, std::vector<int> & turns, std::vector<double> & times, double & calls ){
+    uint32_t written = profile->written.load( std::memory_order_acquire );
+    uint32_t from = profile->writtenAtReset.load();
+    // the oldest entry could be overwritten while reading it
+    if( written - from > uint32_t(PDSP_PROFILER_HISTORY - 1) ){
+        from = written - (PDSP_PROFILER_HISTORY - 1);
+    }
+
+    for( uint32_t i=from; i<written; ++i ){
+        turns.push_back( profile->turns[ i % PDSP_PROFILER_HISTORY ].load( std::memory_order_relaxed ) );
+        times.push_back( double( profile->times[ i % PDSP_PROFILER_HISTORY ].load( std::memory_order_relaxed ) ) * 0.001 );
+    }
+
+    uint32_t buffers = written - profile->writtenAtReset.load();
+    uint64_t total = profile->totalCalls.load() - profile->callsAtReset.load();
+    calls = ( buffers > 0 ) ? double(total) / double(buffers) : 0.0;
+}
+
+pdsp::Profiler::Stats pdsp::Profiler::calculate( std::string name, int units, std::vector<double> & times, double calls ){
+    Stats stats;
+    stats.name = name;
+    stats.units = units;
+    stats.buffers = (int) times.size();
+    stats.calls = calls;
+    stats.min = stats.mean = stats.p99 = stats.max = 0.0;
+
+    if( ! times.empty() ){
+        std::sort( times.begin(), times.end() );
+        double sum = 0.0;
+        for( double t : times ){ sum += t; }
+        stats.min = times.front();
+        stats.max = times.back();
+        stats.mean = sum / double( times.size() );
+        size_t index = size_t( double( times.size() ) * 0.99 );
+        if( index >= times.size() ){ index = times.size() - 1; }
+        stats.p99 = times[index];
+    }
+    return stats;
+}
+
+std::vector<pdsp::Profiler::Stats> pdsp::Profiler::snapshot(){
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+
+    std::vector<Stats> result;
+    std::vector<int> turns;
+    std::vector<double> times;
+    for( UnitProfile* profile : profiler.profiles ){
+        turns.clear();
+        times.clear();
+        double calls;
+        collect( profile, turns, times, calls );
+        if( ! times.empty() ){
+            result.push_back( calculate( getName( profile->unit ), 1, times, calls ) );
+        }
+    }
+
+    std::sort( result.begin(), result.end(), []( const Stats & a, const Stats & b ){ return a.mean > b.mean; } );
+    return result;
+}
+
+void pdsp::Profiler::getUnitSources( Unit* unit, std::vector<Unit*> & sources ){
+    std::vector<InputNode*> inputs;
+    Processor::getUnitInputs( unit, inputs );
+    for( InputNode* input : inputs ){
+        for( OutputData & odata : input->inputs ){
+            Unit* source = odata.node->parent;
+            if( source != nullptr && std::find( sources.begin(), sources.end(), source ) == sources.end() ){
+                sources.push_back( source );
+            }
+        }
+    }
+}
+
+void pdsp::Profiler::getModuleUnits( Patchable & module, std::vector<const Unit*> & units ){
+    std::vector<Unit*> stack;
+    for( NamedOutput & output : module.outputs ){
+        if( output.output->parent != nullptr ){
+            stack.push_back( output.output->parent );
+        }
+    }
+
+    std::unordered_set<Unit*> visited;
+    while( ! stack.empty() ){
+        Unit* unit = stack.back();
+        stack.pop_back();
+        if( ! visited.insert( unit ).second ){ continue; }
+        units.push_back( unit );
+
+        // the Units patched to the module inputs are outside of the module
+        std::vector<InputNode*> inputs;
+        Processor::getUnitInputs( unit, inputs );
+        for( InputNode* input : inputs ){
+            bool moduleInput = false;
+            for( NamedInput & named : module.inputs ){
+                if( named.input == input ){ moduleInput = true; }
+            }
+            if( moduleInput ){ continue; }
+            for( OutputData & odata : input->inputs ){
+                if( odata.node->parent != nullptr ){
+                    stack.push_back( odata.node->parent );
+                }
+            }
+        }
+    }
+}
+
+pdsp::Profiler::Stats pdsp::Profiler::snapshot( Patchable & module, std::string name ){
+    std::vector<const Unit*> units;
+    getModuleUnits( module, units );
+
+    Profiler & profiler = get();
+    std::lock_guard<std::mutex> lock( profiler.mutex );
+
+    // the times of the Units are summed for each buffer
+    std::map<int, double> buffers;
+    double calls = 0.0;
+    std::vector<int> turns;
+    std::vector<double> times;
+    for( UnitProfile* profile : profiler.profiles ){
+        if( std::find( units.begin(), units.end(), profile->unit ) == units.end() ){ continue; }
+        turns.clear();
+        times.clear();
+        double unitCalls;
+        collect( profile, turns, times, unitCalls );
+        calls += unitCalls;
+        for( size_t i=0; i<times.size(); ++i ){
+            buffers[ turns[i] ] += times[i];
+        }
+    }
+
+    times.clear();
+    for( auto & buffer : buffers ){
+        times.push_back( buffer.second );
+    }
+    return calculate( name, (int) units.size(), times, calls );
+}
+
+void pdsp::Profiler::gather( std::vector<Stats> & units, std::vector<Stats> & mods ){
+    units = snapshot();
+
+    Profiler & profiler = get();
+    std::vector<Patchable*> modules;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock( profiler.mutex );
+        modules = profiler.modules;
+        names = profiler.moduleNames;
+    }
+    for( size_t i=0; i<modules.size(); ++i ){
+        mods.push_back( snapshot( *modules[i], names[i] ) );
+    }
+}
+
+std::string pdsp::Profiler::escape( const std::string & name, bool json ){
+    std::string result;
+    for( char c : name ){
+        if( c == '"' ){ result += json ? "\\\"" : "\"\""; }
+        else if( c == '\\' && json ){ result += "\\\\"; }
+        else { result += c; }
+    }
+    return result;
+}
+
+std::string pdsp::Profiler::toCSV(){
+    std::vector<Stats> units;
+    std::vector<Stats> mods;
+    gather( units, mods );
+
+    std::string text = "type,name,units,buffers,calls,min_us,mean_us,p99_us,max_us\n";
+    char line[256];
+    for( int pass=0; pass<2; ++pass ){
+        for( const Stats & s : ( pass==0 ) ? mods : units ){
+            text += ( pass==0 ) ? "module,\"" : "unit,\"";
+            text += escape( s.name, false );
+            snprintf( line, sizeof(line), "\",%d,%d,%.2f,%.3f,%.3f,%.3f,%.3f\n", s.units, s.buffers, s.calls, s.min, s.mean, s.p99, s.max );
+            text += line;
+        }
+    }
+    return text;
+}
+
+std::string pdsp::Profiler::toJSON(){
+    std::vector<Stats> units;
+    std::vector<Stats> mods;
+    gather( units, mods );
+
+    std::string text = "{\n";
+    char line[256];
+    for( int pass=0; pass<2; ++pass ){
+        const std::vector<Stats> & list = ( pass==0 ) ? mods : units;
+        text += ( pass==0 ) ? "  \"modules\": [" : "  \"units\": [";
+        for( size_t i=0; i<list.size(); ++i ){
+            const Stats & s = list[i];
+            text += ( i==0 ) ? "\n    {\"name\":\"" : ",\n    {\"name\":\"";
+            text += escape( s.name, true );
+            snprintf( line, sizeof(line), "\",\"units\":%d,\"buffers\":%d,\"calls\":%.2f,\"min_us\":%.3f,\"mean_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}",
+                      s.units, s.buffers, s.calls, s.min, s.mean, s.p99, s.max );
+            text += line;
+        }
+        text += ( pass==0 ) ? "\n  ],\n" : "\n  ]\n";
+    }
+    text += "}\n";
+    return text;
+}
+
+double pdsp::Profiler::inclusiveTime( Unit* unit, std::unordered_map<Unit*, double> & means, std::unordered_set<Unit*> & visited ){
+    if( ! visited.insert( unit ).second ){ return 0.0; }
+    double time = means[unit];
+    std::vector<Unit*> sources;
+    getUnitSources( unit, sources );
+    for( Unit* source : sources ){
+        time += inclusiveTime( source, means, visited );
+    }
+    return time;
+}
+
+void pdsp::Profiler::printUnit( Unit* unit, int depth, double total, std::unordered_map<Unit*, double> & means, std::unordered_set<Unit*> & printed, std::string & text ){
+    std::unordered_set<Unit*> visited = printed;
+    double inclusive = inclusiveTime( unit, means, visited );
+    double percent = ( total > 0.0 ) ? inclusive * 100.0 / total : 0.0;
+
+    char line[128];
+    snprintf( line, sizeof(line), "%10.3f us %6.2f%% %10.3f us  ", inclusive, percent, means[unit] );
+    text += line;
+    text += std::string( depth * 2, ' ' );
+    text += getName( unit );
+
+    // a Unit pulled by more Units is processed only once, it is shown under the first one
+    if( ! printed.insert( unit ).second ){
+        text += " (shown above)\n";
+        return;
+    }
+    text += "\n";
+
+    std::vector<Unit*> sources;
+    getUnitSources( unit, sources );
+    for( Unit* source : sources ){
+        printUnit( source, depth + 1, total, means, printed, text );
+    }
+}
+
+std::string pdsp::Profiler::tree( Processor & processor ){
+    Profiler & profiler = get();
+
+    std::unordered_map<Unit*, double> means;
+    {
+        std::lock_guard<std::mutex> lock( profiler.mutex );
+        std::vector<int> turns;
+        std::vector<double> times;
+        for( UnitProfile* profile : profiler.profiles ){
+            turns.clear();
+            times.clear();
+            double calls;
+            collect( profile, turns, times, calls );
+            means[ const_cast<Unit*>( profile->unit ) ] = calculate( "", 1, times, calls ).mean;
+        }
+    }
+
+    // the channels without connections are not shown
+    std::vector<Unit*> roots;
+    std::vector<Unit*> sources;
+    for( PatchNode & channel : processor.channels ){
+        sources.clear();
+        getUnitSources( &channel, sources );
+        if( ! sources.empty() ){ roots.push_back( &channel ); }
+    }
+    sources.clear();
+    getUnitSources( &processor.blackhole, sources );
+    if( ! sources.empty() ){ roots.push_back( &processor.blackhole ); }
+
+    std::unordered_set<Unit*> visited;
+    double total = 0.0;
+    for( Unit* root : roots ){
+        total += inclusiveTime( root, means, visited );
+    }
+
+    std::string text = "     total      %       self    unit\n";
+    std::unordered_set<Unit*> printed;
+    for( Unit* root : roots ){
+        printUnit( root, 0, total, means, printed, text );
+    }
+    return text;
+}
@@ -0,0 +1,174 @@
+
+// Profiler.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_CORE_PROFILER_H_INCLUDED
+#define PDSP_CORE_PROFILER_H_INCLUDED
+
+#include "../../flags.h"
+#include <atomic>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace pdsp{
+
+class Unit;
+class Patchable;
+class Processor;
+class InputNode;
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// processing time of a single Unit, written only by the thread processing the Unit
+class UnitProfile {
+public:
+    UnitProfile( const Unit* unit );
+
+    const Unit*             unit;
+
+    // current buffer
+    int                     turn;
+    int64_t                 nanoseconds;
+    int                     calls;
+
+    // last buffers, the snapshots read them while they are written
+    std::atomic<int>        turns[PDSP_PROFILER_HISTORY];
+    std::atomic<uint32_t>   times[PDSP_PROFILER_HISTORY];
+    std::atomic<uint32_t>   written;
+    std::atomic<uint64_t>   totalCalls;
+
+    // set by Profiler::reset()
+    std::atomic<uint32_t>   writtenAtReset;
+    std::atomic<uint64_t>   callsAtReset;
+};
+
+/*!
+    @endcond
+*/
+
+/*!
+@brief collects the processing time of each Unit, active only if PDSP_PROFILING is defined in flags.h
+
+The time is measured each time a Unit is processed and summed for each buffer, only the time spent into the Unit is counted, without the Units it pulls. The time of the last PDSP_PROFILER_HISTORY buffers of each Unit is kept in memory allocated with the Unit, so the audio thread doesn't lock or allocate. The statistics are calculated on the thread that requests them.
+*/
+class Profiler {
+public:
+
+    /*!
+    @brief statistics of a Unit or module, times are in microseconds for buffer
+    */
+    struct Stats {
+        std::string name;
+        int         units;      // 1 for a Unit, the number of Units for a module
+        int         buffers;    // buffers recorded
+        double      calls;      // mean number of calls for buffer
+        double      min;
+        double      mean;
+        double      p99;
+        double      max;
+    };
+
+    /*!
+    @brief activates or deactivates the profiling, active by default when PDSP_PROFILING is defined. Thread-safe.
+    */
+    static void setActive( bool active );
+
+    /*!
+    @brief discards the collected data. Thread-safe.
+    */
+    static void reset();
+
+    /*!
+    @brief adds a module to the modules reported by toCSV() and toJSON(), its Units are the ones found going back from its outputs to its inputs.
+    @param[in] module the module to add
+    @param[in] name name for the reports
+    */
+    static void addModule( Patchable & module, std::string name );
+
+    /*!
+    @brief removes a module added with addModule().
+    @param[in] module the module to remove
+    */
+    static void removeModule( Patchable & module );
+
+    /*!
+    @brief returns the statistics of all the Units that have been processed, sorted from the most expensive.
+    */
+    static std::vector<Stats> snapshot();
+
+    /*!
+    @brief returns the summed statistics of the Units of a module, found going back from its outputs to its inputs.
+    @param[in] module the module to measure
+    @param[in] name name of the returned Stats
+    */
+    static Stats snapshot( Patchable & module, std::string name );
+
+    /*!
+    @brief returns the statistics of the Units and of the added modules as CSV text.
+    */
+    static std::string toCSV();
+
+    /*!
+    @brief returns the statistics of the Units and of the added modules as JSON text.
+    */
+    static std::string toJSON();
+
+    /*!
+    @brief returns a text tree of the patch graph of a Processor, starting from its channels, with the mean time of each Unit and the Units it pulls.
+    @param[in] processor the processor to report
+    */
+    static std::string tree( Processor & processor );
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    // measures the Unit processed in the lifetime of the object
+    class Scope {
+    public:
+        Scope( Unit* unit ) noexcept;
+        ~Scope() noexcept;
+    private:
+        UnitProfile*    profile;
+        Scope*          parent;
+        int64_t         start;
+        int64_t         children;
+    };
+
+    static UnitProfile* add( const Unit* unit );
+    static void remove( UnitProfile* profile );
+
+    static std::string getName( const Unit* unit );
+/*!
+    @endcond
+*/
+
+private:
+    static Profiler & get();
+
+    static void collect( const UnitProfile* profile, std::vector<int> & turns, std::vector<double> & times, double & calls );
+    static Stats calculate( std::string name, int units, std::vector<double> & times, double calls );
+    static void getModuleUnits( Patchable & module, std::vector<const Unit*> & units );
+    static void getUnitSources( Unit* unit, std::vector<Unit*> & sources );
+    static void gather( std::vector<Stats> & units, std::vector<Stats> & modules );
+    static std::string escape( const std::string & name, bool json );
+    static void printUnit( Unit* unit, int depth, double total, std::unordered_map<Unit*, double> & means, std::unordered_set<Unit*> & printed, std::string & text );
+    static double inclusiveTime( Unit* unit, std::unordered_map<Unit*, double> & means, std::unordered_set<Unit*> & visited );
+
+    std::mutex                  mutex;
+    std::vector<UnitProfile*>   profiles;
+    std::vector<Patchable*>     modules;
+    std::vector<std::string>    moduleNames;
+
+    static std::atomic<bool>    active;
+};
+
+}
+
+#endif // PDSP_CORE_PROFILER_H_INCLUDED
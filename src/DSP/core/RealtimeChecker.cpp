@@ -0,0 +1,235 @@
+
+#include "RealtimeChecker.h"
+#include "BasicNodes.h"
+#include "Profiler.h"
+#include <iostream>
+#include <cstdlib>
+
+#ifdef PDSP_REALTIME_CHECKS
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#endif
+
+// only the first violations are printed with the stack trace, the others are just counted
+#define PDSP_REALTIME_CHECKS_MAX_REPORTS 32
+#define PDSP_REALTIME_CHECKS_MAX_FRAMES 32
+
+// plain thread local values, accessing them doesn't allocate
+static thread_local bool rtProcessing = false;
+static thread_local bool rtReporting = false;
+static thread_local const pdsp::Unit* rtUnit = nullptr;
+
+#endif
+
+std::atomic<int> pdsp::RealtimeChecker::violations( 0 );
+
+pdsp::RealtimeChecker::Scope::Scope() noexcept {
+#ifdef PDSP_REALTIME_CHECKS
+    previous = rtProcessing;
+    rtProcessing = true;
+#endif
+}
+
+pdsp::RealtimeChecker::Scope::~Scope() noexcept {
+#ifdef PDSP_REALTIME_CHECKS
+    rtProcessing = previous;
+#endif
+}
+
+pdsp::RealtimeChecker::UnitScope::UnitScope( const Unit* unit ) noexcept {
+#ifdef PDSP_REALTIME_CHECKS
+    previous = rtUnit;
+    rtUnit = unit;
+#endif
+}
+
+pdsp::RealtimeChecker::UnitScope::~UnitScope() noexcept {
+#ifdef PDSP_REALTIME_CHECKS
+    rtUnit = previous;
+#endif
+}
+
+void pdsp::RealtimeChecker::check( const char* what ) noexcept {
+#ifdef PDSP_REALTIME_CHECKS
+    if( rtProcessing && ! rtReporting ){
+        // the report allocates and locks, so the checks are suspended while printing
+        rtReporting = true;
+        int count = violations.fetch_add( 1 ) + 1;
+        if( count <= PDSP_REALTIME_CHECKS_MAX_REPORTS ){
+            report( what );
+        }
+        rtReporting = false;
+    }
+#endif
+}
+
+int pdsp::RealtimeChecker::getViolations() noexcept {
+    return violations.load();
+}
+
+void pdsp::RealtimeChecker::resetViolations() noexcept {
+    violations.store( 0 );
+}
+
+void pdsp::RealtimeChecker::report( const char* what ){
+#ifdef PDSP_REALTIME_CHECKS
+    std::cout<<"[pdsp] real-time violation! "<<what<<" called into the audio processing";
+
+    if( rtUnit != nullptr ){
+        std::cout<<" by "<<Profiler::getName( rtUnit );
+    }else{
+        std::cout<<" outside of the Units";
+    }
+    std::cout<<"\n";
+
+#if defined(__linux__) || defined(__APPLE__)
+    void* frames[PDSP_REALTIME_CHECKS_MAX_FRAMES];
+    int size = backtrace( frames, PDSP_REALTIME_CHECKS_MAX_FRAMES );
+    std::cout.flush();
+    backtrace_symbols_fd( frames, size, STDOUT_FILENO );
+#endif
+
+    if( violations.load() == PDSP_REALTIME_CHECKS_MAX_REPORTS ){
+        std::cout<<"[pdsp] other real-time violations will be only counted\n";
+    }
+#endif
+}
+
+
+// --------------------------- INTERCEPTED FUNCTIONS ---------------------------
+#ifdef PDSP_REALTIME_CHECKS
+
+#if defined(__GLIBC__)
+
+// glibc exports the real allocator with these names, so the whole program allocation goes through here
+extern "C" {
+    void* __libc_malloc( size_t size );
+    void* __libc_calloc( size_t num, size_t size );
+    void* __libc_realloc( void* ptr, size_t size );
+    void  __libc_free( void* ptr );
+    void* __libc_memalign( size_t alignment, size_t size );
+
+    void* malloc( size_t size ){
+        pdsp::RealtimeChecker::check( "malloc" );
+        return __libc_malloc( size );
+    }
+
+    void* calloc( size_t num, size_t size ){
+        pdsp::RealtimeChecker::check( "calloc" );
+        return __libc_calloc( num, size );
+    }
+
+    void* realloc( void* ptr, size_t size ){
+        pdsp::RealtimeChecker::check( "realloc" );
+        return __libc_realloc( ptr, size );
+    }
+
+    void free( void* ptr ){
+        if( ptr != nullptr ){ pdsp::RealtimeChecker::check( "free" ); }
+        __libc_free( ptr );
+    }
+
+    int posix_memalign( void** ptr, size_t alignment, size_t size ){
+        pdsp::RealtimeChecker::check( "posix_memalign" );
+        *ptr = __libc_memalign( alignment, size );
+        return ( *ptr == nullptr ) ? 12 : 0; // ENOMEM
+    }
+}
+
+#else
+
+// without glibc only the C++ allocations are intercepted
+#include <new>
+
+void* operator new( std::size_t size ){
+    pdsp::RealtimeChecker::check( "operator new" );
+    void* p = std::malloc( size == 0 ? 1 : size );
+    if( p == nullptr ){ throw std::bad_alloc(); }
+    return p;
+}
+
+void* operator new[]( std::size_t size ){
+    pdsp::RealtimeChecker::check( "operator new[]" );
+    void* p = std::malloc( size == 0 ? 1 : size );
+    if( p == nullptr ){ throw std::bad_alloc(); }
+    return p;
+}
+
+void operator delete( void* ptr ) noexcept {
+    if( ptr != nullptr ){ pdsp::RealtimeChecker::check( "operator delete" ); }
+    std::free( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept {
+    if( ptr != nullptr ){ pdsp::RealtimeChecker::check( "operator delete[]" ); }
+    std::free( ptr );
+}
+
+#endif // __GLIBC__
+
+#if defined(__linux__)
+
+// locks and blocking calls are forwarded to the next definition found by the dynamic linker
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+
+#define PDSP_REALTIME_NEXT( type, name ) static type real = reinterpret_cast<type>( dlsym( RTLD_NEXT, name ) )
+
+extern "C" {
+
+    int pthread_mutex_lock( pthread_mutex_t* mutex ){
+        typedef int (*Function)( pthread_mutex_t* );
+        PDSP_REALTIME_NEXT( Function, "pthread_mutex_lock" );
+        pdsp::RealtimeChecker::check( "pthread_mutex_lock" );
+        return real( mutex );
+    }
+
+    int pthread_cond_wait( pthread_cond_t* cond, pthread_mutex_t* mutex ){
+        typedef int (*Function)( pthread_cond_t*, pthread_mutex_t* );
+        PDSP_REALTIME_NEXT( Function, "pthread_cond_wait" );
+        pdsp::RealtimeChecker::check( "pthread_cond_wait" );
+        return real( cond, mutex );
+    }
+
+    int pthread_cond_timedwait( pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* time ){
+        typedef int (*Function)( pthread_cond_t*, pthread_mutex_t*, const struct timespec* );
+        PDSP_REALTIME_NEXT( Function, "pthread_cond_timedwait" );
+        pdsp::RealtimeChecker::check( "pthread_cond_timedwait" );
+        return real( cond, mutex, time );
+    }
+
+    int nanosleep( const struct timespec* request, struct timespec* remain ){
+        typedef int (*Function)( const struct timespec*, struct timespec* );
+        PDSP_REALTIME_NEXT( Function, "nanosleep" );
+        pdsp::RealtimeChecker::check( "nanosleep" );
+        return real( request, remain );
+    }
+
+    int usleep( useconds_t usec ){
+        typedef int (*Function)( useconds_t );
+        PDSP_REALTIME_NEXT( Function, "usleep" );
+        pdsp::RealtimeChecker::check( "usleep" );
+        return real( usec );
+    }
+
+    ssize_t read( int fd, void* buf, size_t count ){
+        typedef ssize_t (*Function)( int, void*, size_t );
+        PDSP_REALTIME_NEXT( Function, "read" );
+        pdsp::RealtimeChecker::check( "read" );
+        return real( fd, buf, count );
+    }
+
+    ssize_t write( int fd, const void* buf, size_t count ){
+        typedef ssize_t (*Function)( int, const void*, size_t );
+        PDSP_REALTIME_NEXT( Function, "write" );
+        pdsp::RealtimeChecker::check( "write" );
+        return real( fd, buf, count );
+    }
+}
+
+#endif // __linux__
+
+#endif // PDSP_REALTIME_CHECKS
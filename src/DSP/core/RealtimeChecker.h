@@ -0,0 +1,63 @@
+
+// RealtimeChecker.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_CORE_REALTIMECHECKER_H_INCLUDED
+#define PDSP_CORE_REALTIMECHECKER_H_INCLUDED
+
+#include "../../flags.h"
+#include <atomic>
+
+namespace pdsp{
+
+class Unit;
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// debug tool active only when PDSP_REALTIME_CHECKS is defined in flags.h
+// while the Processor or the SequencerProcessor are processing, memory allocations, mutex locks and blocking calls
+// made by the processing threads are reported with the class of the Unit being processed and a stack trace
+class RealtimeChecker {
+public:
+
+    // marks the calling thread as processing audio for the lifetime of the object
+    class Scope {
+    public:
+        Scope() noexcept;
+        ~Scope() noexcept;
+    private:
+        bool previous;
+    };
+
+    // marks the unit as the one processed by the calling thread for the lifetime of the object
+    class UnitScope {
+    public:
+        UnitScope( const Unit* unit ) noexcept;
+        ~UnitScope() noexcept;
+    private:
+        const Unit* previous;
+    };
+
+    // called by the intercepted functions, what is the name of the function
+    static void check( const char* what ) noexcept;
+
+    // number of violations found since the start or the last reset
+    static int getViolations() noexcept;
+    static void resetViolations() noexcept;
+
+private:
+    static void report( const char* what );
+
+    static std::atomic<int> violations;
+};
+
+/*!
+    @endcond
+*/
+
+}
+
+#endif // PDSP_CORE_REALTIMECHECKER_H_INCLUDED
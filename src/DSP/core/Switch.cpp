@@ -41,6 +41,7 @@ void pdsp::Switch::resize(int size){
         }
 
         inputs.resize(size);      
+        InputNode::globalPatchingVersion++;
         
 }
 
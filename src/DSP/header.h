@@ -13,6 +13,7 @@
 #include "core/BasicNodes.h"
 #include "core/PatchNode.h"
 #include "core/Processor.h"
+#include "core/RealtimeChecker.h"
 #include "core/leftSum.h"
 #include "core/operators.h"
 #include "core/Formula.h"
@@ -75,6 +76,7 @@
 #include "filters/biquads/BiquadPeakEQ.h"
 
 #include "samplers/SampleBuffer.h"
+#include "samplers/SampleCache.h"
 #include "samplers/Sampler.h"
 #include "samplers/GrainWindow.h"
 
@@ -101,6 +103,13 @@
 
 #include "resamplers/resamplers.h"
 
+#include "banks/PMPhasorBank.h"
+#include "banks/BLEPSawBank.h"
+#include "banks/MultiLadder4Bank.h"
+#include "banks/SVF2Bank.h"
+#include "banks/ADSRBank.h"
+#include "banks/AmpBank.h"
+
 namespace pdsp{
 
         typedef DPWTri AATri;
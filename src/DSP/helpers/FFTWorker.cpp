@@ -7,19 +7,31 @@ pdsp::FFTWorker::FFTWorker(){
     lastBufferSize = -1;
     complexSize = 0;
     blockSize = 0;
-    fftImplementation = new audiofft::AudioFFT();
+    fftImplementation = nullptr;
+}
+
+pdsp::FFTWorker::FFTWorker(const FFTWorker & other) : FFTWorker() {
+    lastBufferSize = other.lastBufferSize;
+    setBlockSize(other.blockSize);
+}
+
+pdsp::FFTWorker& pdsp::FFTWorker::operator=(const FFTWorker & other){
+    if(this != &other){
+        lastBufferSize = other.lastBufferSize;
+        setBlockSize(other.blockSize);
+    }
+    return *this;
 }
 
 pdsp::FFTWorker::~FFTWorker(){
 
-    delete fftImplementation;     
-    fftImplementation = nullptr;   
+    setBlockSize(0);
 
 }
 
 void pdsp::FFTWorker::initFFT(int bufferSize){
     
-    if(fftImplementation != nullptr && bufferSize!=lastBufferSize){
+    if(bufferSize!=lastBufferSize){
         
         lastBufferSize = bufferSize;
 
@@ -28,13 +40,31 @@ void pdsp::FFTWorker::initFFT(int bufferSize){
             signalBlockSize *=2;
         }
 
-        fftImplementation->init(signalBlockSize);
-        complexSize = audiofft::AudioFFT::ComplexSize(signalBlockSize);
-        blockSize = signalBlockSize;
+        setBlockSize(signalBlockSize);
     }
 
 }
 
+void pdsp::FFTWorker::setBlockSize(int signalBlockSize){
+    
+    if(signalBlockSize!=blockSize){
+        
+        if(fftImplementation != nullptr){
+            FFTPlanCache::release(blockSize, fftImplementation);
+            fftImplementation = nullptr;
+        }
+        
+        if(signalBlockSize>0){
+            fftImplementation = FFTPlanCache::acquire(signalBlockSize);
+            complexSize = audiofft::AudioFFT::ComplexSize(signalBlockSize);
+        }else{
+            complexSize = 0;
+        }
+        blockSize = signalBlockSize;
+    }
+    
+}
+
 int pdsp::FFTWorker::getFFTComplexSize() const{
         return complexSize;
 }
@@ -51,3 +81,39 @@ void pdsp::FFTWorker::FFT (const float* inSignal, float* re, float* im){
 void pdsp::FFTWorker::iFFT (float* outSignal, const float* re, const float* im){
         fftImplementation->ifft(outSignal, re, im);
 }
+
+
+//-------------------------------FFT PLAN CACHE--------------------------------
+
+std::mutex & pdsp::FFTPlanCache::getMutex(){
+    // never destroyed, so FFTWorkers with static storage can give back their implementation at exit
+    static std::mutex* mutex = new std::mutex();
+    return *mutex;
+}
+
+std::map<int, std::vector<audiofft::AudioFFTBase*>> & pdsp::FFTPlanCache::getPlans(){
+    static std::map<int, std::vector<audiofft::AudioFFTBase*>>* plans = new std::map<int, std::vector<audiofft::AudioFFTBase*>>();
+    return *plans;
+}
+
+audiofft::AudioFFTBase* pdsp::FFTPlanCache::acquire( int blockSize ){
+    {
+        std::lock_guard<std::mutex> lock( getMutex() );
+        std::vector<audiofft::AudioFFTBase*> & idle = getPlans()[blockSize];
+        if( ! idle.empty() ){
+            audiofft::AudioFFTBase* implementation = idle.back();
+            idle.pop_back();
+            return implementation;
+        }
+    }
+    
+    // init() builds the twiddle tables, it is done outside of the lock
+    audiofft::AudioFFTBase* implementation = new audiofft::AudioFFT();
+    implementation->init(blockSize);
+    return implementation;
+}
+
+void pdsp::FFTPlanCache::release( int blockSize, audiofft::AudioFFTBase* implementation ){
+    std::lock_guard<std::mutex> lock( getMutex() );
+    getPlans()[blockSize].push_back( implementation );
+}
@@ -8,18 +8,23 @@
 
 #include "../pdspConstants.h"
 #include "../../math/header.h"
+#include <map>
+#include <vector>
+#include <mutex>
 
 namespace pdsp{
         
     /*!
     @brief Class to use an FFT Implementation 
     
-    This manage the instantiation and initialization of an FFT algorithm to be used into subclasses. It use the AudioFFT library so the implementation is chosen at compile time setting the right flag. 
+    This manage the instantiation and initialization of an FFT algorithm to be used into subclasses. It use the AudioFFT library so the implementation is chosen at compile time setting the right flag. The initialized implementations are taken from a process-wide cache keyed by block size, each FFTWorker has its own one so different FFTWorkers can be used from different threads at the same time.
     */        
 
 class FFTWorker {
 public:       
     FFTWorker();
+    FFTWorker(const FFTWorker & other);
+    FFTWorker& operator=(const FFTWorker & other);
     ~FFTWorker();
     
     /*!
@@ -54,12 +59,38 @@ public:
     void    iFFT (float* outSignal, const float* re, const float* im);
 
 private:
+    void setBlockSize(int signalBlockSize);
+
     int blockSize;
     int complexSize;
     audiofft::AudioFFTBase* fftImplementation;
     int lastBufferSize;
 
 };
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// process-wide cache of initialized FFT implementations, keyed by block size
+// AudioFFT keeps its work buffers inside the implementation, so an implementation is lent to one FFTWorker at time
+// and given back when the FFTWorker changes block size or is destroyed, the next FFTWorker of the same size reuses it without init()
+// the cache only saves the init() of the implementations given back: FFTWorkers alive at the same time have one each,
+// each with its own twiddle tables, because the Ooura backend also writes its bit reversal work area into the ip table
+// and the FFTW and Accelerate plans are owned by the AudioFFT objects, so they can't be shared without changing the library
+class FFTPlanCache {
+public:
+    static audiofft::AudioFFTBase* acquire( int blockSize );
+    static void release( int blockSize, audiofft::AudioFFTBase* implementation );
+
+private:
+    static std::mutex & getMutex();
+    static std::map<int, std::vector<audiofft::AudioFFTBase*>> & getPlans();
+};
+
+/*!
+    @endcond
+*/
     
 
         
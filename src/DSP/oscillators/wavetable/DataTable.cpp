@@ -1,23 +1,38 @@
 
 #include "DataTable.h"
 
+#define PDSP_DATATABLE_FRESH 4
+
 pdsp::DataTable::DataTable() {
     length = -1;
     buffer = nullptr;
     bSetting = false;
     bAdditive = false;
-	bLoaded  = false;
+	bPending  = false;
 	bHarmonic = true;
     lastIndex = 0;
     lastTurn = -42;
     smooth = 0.0f;
+
+    for( int i=0; i<3; ++i ){
+        tables[i] = nullptr;
+    }
+    writeIndex = 0;
+    middle = 1;
+    readIndex = 2;
+    quit = false;
 }
 
 pdsp::DataTable::~DataTable() {
+	stopBuilder();
+
     if(buffer!=nullptr){
 		ofx_deallocate_aligned(buffer);
         buffer = nullptr;
-    }    
+    }
+    for( int i=0; i<3; ++i ){
+		ofx_deallocate_aligned(tables[i]);
+    }
 }
 
 void pdsp::DataTable::harmonicAdditiveMode( bool active ) {
@@ -39,42 +54,41 @@ int pdsp::DataTable::getMaxPartials() const  {
 }
 
 void pdsp::DataTable::setup( int len, int maxPartials, bool harmonicAdditive ) {
+	stopBuilder();
+
 	length = len;
 	this->maxPartials = maxPartials;
 	bHarmonic = harmonicAdditive;
 	
-	// init partials table
-	double divider = 1.0 / (double) length;
-	
-	partialsTable = new float*[maxPartials];
-	 
-	for( int i=0; i<maxPartials; ++i){
-		ofx_allocate_aligned(partialsTable[i], length+1);     // guard point   
-
-		for( int n=0; n<length; ++n){
-			double theta = static_cast<double>(n) * (double)(i+1) * M_TAU_DOUBLE * divider ;
-			partialsTable[i][n] = sin( theta );
-		}
-	}
-
-	ofx_allocate_aligned(buffer,    length+1);     // guard point 
-	ofx_allocate_aligned(bufferNew, length+1);     // guard point 
+	renderer.setup( length, maxPartials );
+
+	ofx_deallocate_aligned(buffer);
+	ofx_allocate_aligned(buffer,    length+1);     // guard point
+    for( int i=0; i<3; ++i ){
+		ofx_deallocate_aligned(tables[i]);
+		ofx_allocate_aligned(tables[i], length+1);     // guard point
+    }
+    writeIndex = 0;
+    middle = 1;
+    readIndex = 2;
 
 	int max = (len > maxPartials) ? len : maxPartials;
 	vData.resize( max );
+	vBuild.resize( max );
 	for (size_t i=0; i<vData.size(); ++i){
 		vData[i] = 0.0f;
 	}
+
+	startBuilder();
 }
 
 bool pdsp::DataTable::ready() {
-	return (!bSetting && !bLoaded ); 
+	return (!bSetting && !bPending ); 
 }
 
 void pdsp::DataTable::begin() {
 	if( ready() ) {
 		bSetting = true;
-		bLoaded = false;
 		for (size_t i=0; i<vData.size(); ++i){
 			vData[i] = 0.0f;
 		}
@@ -90,62 +104,110 @@ void pdsp::DataTable::data( int i, float value ) {
 void pdsp::DataTable::end( bool additive ) {
 	bAdditive = additive;
 	bSetting = false;
-	bLoaded  = true;
+	{
+		// called from the main thread, so it's safe to lock
+		std::lock_guard<std::mutex> lock( mutex );
+		bPending = true;
+	}
+	condition.notify_one();
 }
  
 void pdsp::DataTable::update( ) {
-	if( lastTurn!=OutputNode::getGlobalProcessingTurnId() && bLoaded ) {	
-		// uploads the wave to bufferNew
-		if( bAdditive ) {
-			additive();
-		} else {
-			for( int n=0; n<length; ++n ){
-				bufferNew[n] = vData[n];
-			}
-		}
-		bufferNew[length] = bufferNew[0]; // guard point
+	if( lastTurn!=OutputNode::getGlobalProcessingTurnId() && (middle.load() & PDSP_DATATABLE_FRESH) ) {
+		// takes the last table built, giving back the old one to the builder
+		readIndex = middle.exchange( readIndex ) & ~PDSP_DATATABLE_FRESH;
+		const float* bufferNew = tables[readIndex];
 		
 		// now interpolate the wave to the actual buffer with the given smooth
 		// buffer = (buffer * smooth) + (bufferNew * (1.0f - smooth))
 		// this is basically some kind of low pass filtering operating at buffer rate
 		if( smooth!=0.0f ){
 			ofx_Aeq_BmulS( buffer, buffer, smooth, length+1 );
-			ofx_Aeq_BmulS( bufferNew, bufferNew, (1.0f-smooth), length+1 );
-			ofx_Aeq_BaddC( buffer, buffer, bufferNew, length+1 );			
+			ofx_Aeq_Badd_CmulS( buffer, buffer, bufferNew, (1.0f-smooth), length+1 );
 		}else{
 			ofx_Aeq_B( buffer, bufferNew, length+1);
 		}
 		
 		// cleans
 		lastTurn = OutputNode::getGlobalProcessingTurnId();
-		bLoaded = false;
 	}
 }
 
-void pdsp::DataTable::additive() {
-	ofx_Aeq_Zero( bufferNew, length);
+void pdsp::DataTable::startBuilder() {
+	quit = false;
+	builder = std::thread( &DataTable::builderFunction, this );
+}
+
+void pdsp::DataTable::stopBuilder() {
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		quit = true;
+	}
+	condition.notify_one();
+	if( builder.joinable() ){
+		builder.join();
+	}
+}
+
+void pdsp::DataTable::builderFunction() {
+
+	while( true ){
+		int partials;
+		bool additiveMode;
+		bool harmonic;
+
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			condition.wait( lock, [this]{ return quit || bPending.load(); } );
+			if( quit ) return;
+
+			// copies the data, so the main thread can start setting the next one
+			for (size_t i=0; i<vData.size(); ++i){
+				vBuild[i] = vData[i];
+			}
+			partials = lastIndex+1;
+			additiveMode = bAdditive;
+			harmonic = bHarmonic;
+			bPending = false;
+		}
+
+		float* table = tables[writeIndex];
+		if( additiveMode ) {
+			additive( table, partials, harmonic );
+		} else {
+			for( int n=0; n<length; ++n ){
+				table[n] = vBuild[n];
+			}
+		}
+		table[length] = table[0]; // guard point
+
+		// publish the table, taking the one the audio thread doesn't use
+		writeIndex = middle.exchange( writeIndex | PDSP_DATATABLE_FRESH ) & ~PDSP_DATATABLE_FRESH;
+	}
+}
+
+void pdsp::DataTable::additive( float* table, int partials, bool harmonicScale ) {
+	renderer.clear();
     
     double signalMax = 0.0;
     
-	for ( int i=0; i<(lastIndex+1) && i<maxPartials; ++i ){
+	for ( int i=0; i<partials && i<maxPartials; ++i ){
 		
 		int partial_i = i+1;
-		double harmonic_amp = vData[i];
+		double harmonic_amp = vBuild[i];
 		double partial = (double) partial_i;
 
-		if(bHarmonic){
+		if(harmonicScale){
 			double harmonic = 1.0 / partial;
 			harmonic_amp *= harmonic;  
 		}
 		if(partial_i%2 == 0) harmonic_amp = -harmonic_amp;
 		
-		ofx_Aeq_Badd_CmulS( bufferNew, bufferNew, partialsTable[i], harmonic_amp, length );
+		renderer.setPartial( partial_i, harmonic_amp );
 		signalMax += std::abs( harmonic_amp );
 	}
 
-	if(signalMax>0.0f){
-		float div = 1.0 / signalMax;
-		ofx_Aeq_BmulS( bufferNew, bufferNew, div, length );		
-	}
+	float div = (signalMax>0.0f) ? 1.0 / signalMax : 1.0f;
+	renderer.render( table, div );
 }
 
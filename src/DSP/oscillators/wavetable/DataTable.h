@@ -6,12 +6,17 @@
 #define PDSP_OSC_DATATABLE_H_INCLUDED
 
 #include "../pdspCore.h"
+#include "PartialsRenderer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace pdsp {
     
     /*!
     @brief Utility class for creating waveform from realtime data, thread safely.
     
+    The waveforms are built on a background thread and handed to the oscillators with a lock-free triple buffer, the audio thread only does the smoothing crossfade.
     */
     
 class DataTable {
@@ -54,7 +59,7 @@ public:
    
 
     /*!
-    @brief checks if you can set the wave, always use it for thread-safe operations
+    @brief checks if you can set the wave, always use it for thread-safe operations. It returns true again as soon as the background thread has taken the last data, if you set waves faster than the audio buffers only the last one is played.
     */     
 	bool ready();
 	
@@ -80,18 +85,21 @@ private:
 	void update(); // accessible from DataOscillator
 								// use OutputNode::getGlobalProcessingTurnId() to check if it needs updating
 	
-	void additive();
+	void additive( float* table, int partials, bool harmonicScale );
+	
+	void builderFunction();
+	void startBuilder();
+	void stopBuilder();
 
     float * buffer;  // read by DataOscillator
     int length;
 
     int maxPartials;
-    float ** partialsTable;    
+    PartialsRenderer renderer;
 
-    float * bufferNew;            
 	std::vector<float> vData;
 	std::atomic<bool>  bSetting;
-	std::atomic<bool>  bLoaded;
+	std::atomic<bool>  bPending; // data waiting for the builder thread
 	std::atomic<bool>  bAdditive;
 	std::atomic<bool>  bHarmonic;
 	int lastIndex;
@@ -99,6 +107,19 @@ private:
 	
 	std::atomic<float> smooth;
 	
+	// triple buffer, the builder writes tables[writeIndex], the audio thread reads tables[readIndex]
+	// the third one is exchanged through middle, with the fresh bit set when it contains a new table
+	float * tables[3];
+	int writeIndex;
+	int readIndex;
+	std::atomic<int> middle;
+	
+	std::vector<float> vBuild;
+	std::thread builder;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool quit;
+	
 };    
 
 }
@@ -0,0 +1,98 @@
+
+#include "PartialsRenderer.h"
+
+
+pdsp::PartialsRenderer::PartialsRenderer(){
+    length = 0;
+    maxPartials = 0;
+    fft = nullptr;
+}
+
+pdsp::PartialsRenderer::PartialsRenderer(const PartialsRenderer & other) : PartialsRenderer() {
+    setup( other.length, other.maxPartials );
+}
+
+pdsp::PartialsRenderer& pdsp::PartialsRenderer::operator=(const PartialsRenderer & other){
+    if(this != &other){
+        setup( other.length, other.maxPartials );
+    }
+    return *this;
+}
+
+pdsp::PartialsRenderer::~PartialsRenderer(){
+    release();
+}
+
+void pdsp::PartialsRenderer::release(){
+    if(fft != nullptr){
+        FFTPlanCache::release( length, fft );
+        fft = nullptr;
+    }
+}
+
+void pdsp::PartialsRenderer::setup( int length, int maxPartials ){
+    
+    release();
+    
+    this->length = length;
+    this->maxPartials = maxPartials;
+    
+    if( length>=4 && (length & (length-1)) == 0 ){
+        fft = FFTPlanCache::acquire( length );
+        re.assign( audiofft::AudioFFT::ComplexSize(length), 0.0f );
+        im.assign( audiofft::AudioFFT::ComplexSize(length), 0.0f );
+        sines.clear();
+    }else if( length > 0 ){
+        // amplitudes for the sines sum, index 0 is the first partial
+        re.assign( maxPartials, 0.0f );
+        im.clear();
+        // the partials have integer periods in the table, so all their samples are in one sine cycle
+        sines.resize( length );
+        for( int n=0; n<length; ++n ){
+            sines[n] = sin( static_cast<double>(n) * M_TAU_DOUBLE / (double) length );
+        }
+    }
+}
+
+void pdsp::PartialsRenderer::clear() noexcept {
+    for( size_t k=0; k<re.size(); ++k ){ re[k] = 0.0f; }
+    for( size_t k=0; k<im.size(); ++k ){ im[k] = 0.0f; }
+}
+
+void pdsp::PartialsRenderer::setPartial( int partial, float amplitude ) noexcept {
+    if( partial < 1 || partial > maxPartials ) return;
+    
+    if( fft != nullptr ){
+        // bin k is the partial k, the partials at or above nyquist can't be represented
+        if( partial < length/2 ){
+            // a sine of amplitude a has a spectrum of -a * length/2 on the imaginary part
+            im[partial] = -amplitude * static_cast<float>(length/2);
+        }
+    }else{
+        re[partial-1] = amplitude;
+    }
+}
+
+void pdsp::PartialsRenderer::render( float* table, float gain ) noexcept {
+    
+    if( fft != nullptr ){
+        fft->ifft( table, re.data(), im.data() );
+    }else{
+        for( int n=0; n<length; ++n ){
+            double sum = 0.0;
+            int index = 0; // n * partial, wrapped in the sine cycle
+            for( size_t i=0; i<re.size(); ++i ){
+                index += n;
+                if( index >= length ){ index -= length; }
+                if( re[i] != 0.0f ){
+                    sum += re[i] * sines[index];
+                }
+            }
+            table[n] = static_cast<float>(sum);
+        }
+    }
+    
+    if( gain != 1.0f ){
+        ofx_Aeq_BmulS( table, table, gain, length );
+    }
+}
@@ -0,0 +1,55 @@
+
+// PartialsRenderer.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_OSC_PARTIALSRENDERER_H_INCLUDED
+#define PDSP_OSC_PARTIALSRENDERER_H_INCLUDED
+
+#include "../../helpers/FFTWorker.h"
+#include <vector>
+
+namespace pdsp {
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+// renders a waveform from the amplitudes of its sine partials with an inverse real FFT
+// with non power of 2 lengths it falls back to summing the sines, read from a table of one sine cycle
+class PartialsRenderer {
+public:
+    PartialsRenderer();
+    PartialsRenderer(const PartialsRenderer & other);
+    PartialsRenderer& operator=(const PartialsRenderer & other);
+    ~PartialsRenderer();
+
+    void setup( int length, int maxPartials );
+
+    // sets all the partials to 0.0f
+    void clear() noexcept;
+
+    // partials start from 1, each one is a sine starting at phase 0
+    void setPartial( int partial, float amplitude ) noexcept;
+
+    // writes length samples to the table, multiplied by gain, no memory is allocated
+    void render( float* table, float gain ) noexcept;
+
+private:
+    void release();
+
+    int length;
+    int maxPartials;
+    audiofft::AudioFFTBase* fft;
+    std::vector<float> re;
+    std::vector<float> im;
+    std::vector<double> sines;
+};
+
+/*!
+    @endcond
+*/
+
+}
+
+#endif // PDSP_OSC_PARTIALSRENDERER_H_INCLUDED
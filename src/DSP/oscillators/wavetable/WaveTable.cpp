@@ -7,6 +7,8 @@ pdsp::WaveTable::WaveTable() {
     tableSize = 0;
     buffer = nullptr;
     verbose = false;
+    mipLevels = 1;
+    mipmaps = nullptr;
 }
 
 
@@ -16,8 +18,13 @@ pdsp::WaveTable::~WaveTable(){
         
         for(int i=0; i<tableSize+1; ++i){
             ofx_deallocate_aligned(buffer[i]);
+            for(int l=1; l<mipLevels; ++l){
+                ofx_deallocate_aligned(mipmaps[i][l]);
+            }
+            delete[] mipmaps[i];
         }
         delete[] buffer;
+        delete[] mipmaps;
  
     }
     
@@ -33,6 +40,10 @@ int pdsp::WaveTable::tableLength() const{
     return length;
 }
 
+int pdsp::WaveTable::mipMapLevels() const{
+    return mipLevels;
+}
+
 void pdsp::WaveTable::setup( int len, int maxPartials ) {
     
     if(length==-1){
@@ -40,19 +51,15 @@ void pdsp::WaveTable::setup( int len, int maxPartials ) {
         length = len;
         this->maxPartials = maxPartials;
         
-        // init partials table
-        double divider = 1.0 / (double) length;
-        
-        partialsTable = new float*[maxPartials];
-         
-        for( int i=0; i<maxPartials; ++i){
-            ofx_allocate_aligned(partialsTable[i], length+1);     // guard point   
-
-            for( int n=0; n<length; ++n){
-                double theta = static_cast<double>(n) * (double)(i+1) * M_TAU_DOUBLE * divider ;
-                partialsTable[i][n] = sin( theta );
+        // one band-limited level for each octave, until only the fundamental is left
+        mipLevels = 1;
+        if( length>=4 && (length & (length-1)) == 0 ){
+            for( int k=length/2; k>1; k/=2 ){
+                mipLevels++;
             }
         }
+        
+        renderer.setup( length, maxPartials );
     
     }else{
         std::cout<< "[pdsp] warning! table length already set automatically, setup() failed\n";
@@ -81,25 +88,33 @@ void pdsp::WaveTable::addEmpty( int numberOfWavesToAdd ) {
         if(buffer == nullptr){
             
             buffer = new float*[numberOfWavesToAdd+1]; // guard point
+            mipmaps = new float**[numberOfWavesToAdd+1];
             for( int i=0; i<numberOfWavesToAdd+1; ++i){
                 ofx_allocate_aligned(buffer[i], length+1);                
+                allocateMipMaps(i);
             }
             tableSize = numberOfWavesToAdd;
             
         }else{
             
             float** newHandles = new float* [tableSize+numberOfWavesToAdd+1];
+            float*** newMipMaps = new float** [tableSize+numberOfWavesToAdd+1];
             
             for(int i=0; i<tableSize+1; ++i){
                 newHandles[i] = buffer[i];
-            }
-            for( int i=0; i<numberOfWavesToAdd; ++i){
-                tableSize++;            
-                ofx_allocate_aligned( newHandles[tableSize], length+1 );                                   
+                newMipMaps[i] = mipmaps[i];
             }
             
             delete [] buffer;
+            delete [] mipmaps;
             buffer = newHandles;
+            mipmaps = newMipMaps;
+            
+            for( int i=0; i<numberOfWavesToAdd; ++i){
+                tableSize++;            
+                ofx_allocate_aligned( buffer[tableSize], length+1 );                                   
+                allocateMipMaps(tableSize);
+            }
         }
         if(verbose) std::cout<< "[pdsp] wavetable size: "<< tableSize << " waveforms\n";
   
@@ -119,6 +134,7 @@ void pdsp::WaveTable::setEmpty( int index ) {
     for(int i=0; i<length; ++i){
         buffer[index][i] = 0.0f;
     }
+    buildMipMaps( index );
 }    
 
 void pdsp::WaveTable::addSample( std::string path ) {
@@ -148,6 +164,7 @@ void pdsp::WaveTable::setSample(int index, std::string path ) {
                 buffer[index][n] = loader.buffer[0][n];
             }
             buffer[index][length] = buffer[index][0];
+            buildMipMaps( index );
         }        
     }
     
@@ -171,7 +188,7 @@ void pdsp::WaveTable::setAdditiveWave(int index, const std::vector<float> & part
 
     int partial_i = 1; 
     
-    ofx_Aeq_Zero(buffer[index], length);
+    renderer.clear();
     
     double signalMax = 0.0;
     
@@ -186,19 +203,18 @@ void pdsp::WaveTable::setAdditiveWave(int index, const std::vector<float> & part
             harmonic_amp *= harmonic;  
         }
         
-        ofx_Aeq_Badd_CmulS( buffer[index], buffer[index], partialsTable[partial_i-1], harmonic_amp, length );
+        renderer.setPartial( partial_i, harmonic_amp );
         signalMax += std::abs( harmonic_amp );
         
         partial_i++;
         if(partial_i>maxPartials) break;
     }
 
-	if(signalMax>0.0f){
-		float div = 1.0 / signalMax;
-		ofx_Aeq_BmulS( buffer[index], buffer[index], div, length );
-	}
+	float div = (signalMax>0.0f) ? 1.0 / signalMax : 1.0f;
+	renderer.render( buffer[index], div );
     
     buffer[index][length] = buffer[index][0];
+    buildMipMaps( index );
 
 }
 
@@ -220,7 +236,7 @@ void pdsp::WaveTable::setAdditiveWave(int index, std::initializer_list<float> pa
 
     int partial_i = 1; 
     
-    ofx_Aeq_Zero(buffer[index], length);
+    renderer.clear();
     
     double signalMax = 0.0;
     
@@ -236,7 +252,7 @@ void pdsp::WaveTable::setAdditiveWave(int index, std::initializer_list<float> pa
         }
         if(partial_i%2 == 0) harmonic_amp = -harmonic_amp;
         
-        ofx_Aeq_Badd_CmulS( buffer[index], buffer[index], partialsTable[partial_i-1], harmonic_amp, length );
+        renderer.setPartial( partial_i, harmonic_amp );
         signalMax += std::abs( harmonic_amp );
         
         partial_i++;
@@ -250,9 +266,10 @@ void pdsp::WaveTable::setAdditiveWave(int index, std::initializer_list<float> pa
     //    buffer[index][n] *= div;
     //}
 
-    ofx_Aeq_BmulS( buffer[index], buffer[index], div, length );
+    renderer.render( buffer[index], div );
     
     buffer[index][length] = buffer[index][0];
+    buildMipMaps( index );
 
 }
 
@@ -274,7 +291,7 @@ void pdsp::WaveTable::setSawWave(int index, int partials ) {
 
     int partial_i = 1; 
     
-    ofx_Aeq_Zero(buffer[index], length);
+    renderer.clear();
     
     double signalMax = 0.0;
     
@@ -285,16 +302,17 @@ void pdsp::WaveTable::setSawWave(int index, int partials ) {
         double harmonic_amp = 1.0 / partial;
         if(partial_i%2 == 0) harmonic_amp = -harmonic_amp;
         
-        ofx_Aeq_Badd_CmulS( buffer[index], buffer[index], partialsTable[partial_i-1], harmonic_amp, length );
+        renderer.setPartial( partial_i, harmonic_amp );
         signalMax += std::abs( harmonic_amp );
         
     }
 
     float div = 1.0 / signalMax;
 
-    ofx_Aeq_BmulS( buffer[index], buffer[index], div, length );
+    renderer.render( buffer[index], div );
     
     buffer[index][length] = buffer[index][0];
+    buildMipMaps( index );
     
 }
 
@@ -316,7 +334,7 @@ void pdsp::WaveTable::setSquareWave (int index, int partials ) {
     
     int partial_i = 1;     
     
-    ofx_Aeq_Zero(buffer[index], length);
+    renderer.clear();
     
     double signalMax = 0.0;
     
@@ -326,16 +344,17 @@ void pdsp::WaveTable::setSquareWave (int index, int partials ) {
 
         double harmonic_amp = 1.0 / partial;
         
-        ofx_Aeq_Badd_CmulS( buffer[index], buffer[index], partialsTable[partial_i-1], harmonic_amp, length );
+        renderer.setPartial( partial_i, harmonic_amp );
         signalMax += std::abs( harmonic_amp );
         
     }
 
     float div = 1.0 / signalMax;
 
-    ofx_Aeq_BmulS( buffer[index], buffer[index], div, length );
+    renderer.render( buffer[index], div );
     
     buffer[index][length] = buffer[index][0];    
+    buildMipMaps( index );
         
 }
 
@@ -357,7 +376,7 @@ void pdsp::WaveTable::setTriangleWave (int index, int partials ) {
 
     int partial_i = 1; 
     
-    ofx_Aeq_Zero(buffer[index], length);
+    renderer.clear();
     
     double signalMax = 0.0;
     
@@ -368,16 +387,17 @@ void pdsp::WaveTable::setTriangleWave (int index, int partials ) {
         double harmonic_amp = 1.0 / partial;
         harmonic_amp *= harmonic_amp;
         
-        ofx_Aeq_Badd_CmulS( buffer[index], buffer[index], partialsTable[partial_i-1], harmonic_amp, length );
+        renderer.setPartial( partial_i, harmonic_amp );
         signalMax += std::abs( harmonic_amp );
     
     }
 
     float div = 1.0 / signalMax;
 
-    ofx_Aeq_BmulS( buffer[index], buffer[index], div, length );
+    renderer.render( buffer[index], div );
     
     buffer[index][length] = buffer[index][0];      
+    buildMipMaps( index );
     
             
 }
@@ -396,8 +416,53 @@ void pdsp::WaveTable::setSineWave ( int index ) {
     if(index<0 ) index = 0;
     if(index >= tableSize ) index = tableSize-1;
 
-    ofx_Aeq_B(buffer[index], partialsTable[0], length);
+    renderer.clear();
+    renderer.setPartial( 1, 1.0f );
+    renderer.render( buffer[index], 1.0f );
     
     buffer[index][length] = buffer[index][0];  
+    buildMipMaps( index );
             
 }
+
+
+void pdsp::WaveTable::allocateMipMaps( int index ){
+    mipmaps[index] = new float*[mipLevels];
+    mipmaps[index][0] = buffer[index];
+    for(int l=1; l<mipLevels; ++l){
+        ofx_allocate_aligned(mipmaps[index][l], length+1);     // guard point
+    }
+}
+
+void pdsp::WaveTable::buildMipMaps( int index ){
+
+    if( mipLevels==1 ) return;
+
+    int complexSize = audiofft::AudioFFT::ComplexSize(length);
+    std::vector<float> spectrumR( complexSize );
+    std::vector<float> spectrumI( complexSize );
+    std::vector<float> levelR( complexSize );
+    std::vector<float> levelI( complexSize );
+
+    audiofft::AudioFFTBase* fft = FFTPlanCache::acquire( length );
+    
+    fft->fft( buffer[index], spectrumR.data(), spectrumI.data() );
+
+    // each level keeps half the partials of the previous one, bin k is the partial k
+    for( int l=1; l<mipLevels; ++l ){
+        int maxPartial = (length/2) >> l;
+        for( int k=0; k<complexSize; ++k ){
+            if( k<=maxPartial ){
+                levelR[k] = spectrumR[k];
+                levelI[k] = spectrumI[k];
+            }else{
+                levelR[k] = 0.0f;
+                levelI[k] = 0.0f;
+            }
+        }
+        fft->ifft( mipmaps[index][l], levelR.data(), levelI.data() );
+        mipmaps[index][l][length] = mipmaps[index][l][0];
+    }
+
+    FFTPlanCache::release( length, fft );
+}
@@ -4,12 +4,15 @@
 
 
 #include "../../samplers/SampleBuffer.h"
+#include "../../helpers/FFTWorker.h"
+#include "PartialsRenderer.h"
 
 namespace pdsp {
     
     /*!
     @brief Utility class for storing and loading buffers of waveforms
     
+    If the table length is a power of 2 each waveform also has a pyramid of band-limited versions, one for each octave, with half the partials of the previous one. WaveTableOsc selects and crossfades them using its phase increment, so the waveforms don't alias at high pitches.
     */
     
 class WaveTable {
@@ -168,12 +171,18 @@ public:
     int tableLength() const;
 
 
+    /*!
+    @brief returns the number of band-limited versions of each waveform, including the original one. It is 1 if the table length is not a power of 2.
+    */  
+    int mipMapLevels() const;
+
+
     /*!
     @brief sets the table length, and the maximum number of partial.
     @param[in]  len length of each wave sample buffer
     @param[in]  maxPartials max number of partials available for the waves. 64 if not given.
     
-    It is called automatically if you add samples as first waves, maxPartial default is 64. Keeping the partial number low will use less memory, 128-256 is enough, the old Waldorf synths sounded good with just 64 partial waves.
+    It is called automatically if you add samples as first waves, maxPartial default is 64. With power of 2 lengths the waves are generated with an inverse FFT, so the number of partials doesn't change the memory used or the generation time, up to len/2 partials. Other lengths sum each partial and are a lot slower.
 
     */  
     void setup( int len, int maxPartials=64);
@@ -195,13 +204,19 @@ public:
     void setVerbose( bool verbose );
     
 private:    
+    void allocateMipMaps( int index );
+    void buildMipMaps( int index );
+
     float ** buffer;    
     int length;
+    
+    int mipLevels;
+    float *** mipmaps; // mipmaps[index][0] is buffer[index]
     int tableSize;
     bool verbose;
 
     int maxPartials;
-    float ** partialsTable;    
+    PartialsRenderer renderer;
         
     SampleBuffer loader;
 };    
@@ -4,6 +4,9 @@
 
 pdsp::WaveTableOsc::WaveTableOsc(){
     waveTable = nullptr;
+    addInput("inc", input_inc);
+    input_inc.setDefaultValue(0.0f);
+    updateOutputNodes();
 }
 
 pdsp::WaveTableOsc::WaveTableOsc(const pdsp::WaveTableOsc & other) : WaveTableOsc(){
@@ -18,6 +21,10 @@ pdsp::WaveTableOsc& pdsp::WaveTableOsc::operator=(const WaveTableOsc& other){
 }
 
 
+pdsp::Patchable& pdsp::WaveTableOsc::in_inc(){
+    return in("inc");
+}
+
 void pdsp::WaveTableOsc::setTable(WaveTable& waveTable){
     this->waveTable = &waveTable;
     input_shape.enableBoundaries(0.0f, (float)(waveTable.tableSize -1) );
@@ -32,6 +39,13 @@ void pdsp::WaveTableOsc::prepareOscillator(double sampleRate) {
 void pdsp::WaveTableOsc::oscillateShapeCR(float* outputBuffer, const float* phaseBuffer, const float shape, int bufferSize) noexcept {
     
     assert(waveTable!=nullptr && waveTable->buffer!=nullptr && "wavetable not set!!!");
+    
+    float levelStart, levelEnd;
+    if( getLevels(levelStart, levelEnd, bufferSize) ){
+        process_mipmap<false>(outputBuffer, phaseBuffer, nullptr, shape, levelStart, levelEnd, bufferSize);
+        meter.store( shape );
+        return;
+    }
            
     int shapeA = static_cast<int>(shape);
     float shape_fract = shape - shapeA;
@@ -56,6 +70,13 @@ void pdsp::WaveTableOsc::oscillateShapeCR(float* outputBuffer, const float* phas
 void pdsp::WaveTableOsc::oscillateShapeAR(float* outputBuffer, const float* phaseBuffer, const float* shapeBuffer, int bufferSize) noexcept {
    
     assert(waveTable!=nullptr && waveTable->buffer!=nullptr && "wavetable not set!!!");
+    
+    float levelStart, levelEnd;
+    if( getLevels(levelStart, levelEnd, bufferSize) ){
+        process_mipmap<true>(outputBuffer, phaseBuffer, shapeBuffer, 0.0f, levelStart, levelEnd, bufferSize);
+        meter.store(shapeBuffer[0]);
+        return;
+    }
            
     for (int n = 0; n < bufferSize; ++n){
         
@@ -78,6 +99,81 @@ void pdsp::WaveTableOsc::oscillateShapeAR(float* outputBuffer, const float* phas
     meter.store(shapeBuffer[0]);
 }
 
+
+bool pdsp::WaveTableOsc::getLevels(float & levelStart, float & levelEnd, int bufferSize) noexcept {
+    
+    int incState;
+    const float* incBuffer = processInput(input_inc, incState);
+    
+    if( waveTable->mipLevels == 1 ) return false;
+    
+    float incStart = std::abs(incBuffer[0]);
+    float incEnd = (incState==AudioRate) ? std::abs(incBuffer[bufferSize-1]) : incStart;
+    
+    if( incStart==0.0f && incEnd==0.0f ) return false;
+    
+    // the level with length/2 partials is alias-free up to inc = 1/length, each level is an octave higher
+    float maxLevel = static_cast<float>(waveTable->mipLevels - 1);
+    float length = static_cast<float>(waveTable->length);
+    
+    levelStart = (incStart > 0.0f) ? log2f(incStart * length) : 0.0f;
+    levelEnd = (incEnd > 0.0f) ? log2f(incEnd * length) : 0.0f;
+    
+    levelStart = (levelStart < 0.0f) ? 0.0f : ( (levelStart > maxLevel) ? maxLevel : levelStart );
+    levelEnd = (levelEnd < 0.0f) ? 0.0f : ( (levelEnd > maxLevel) ? maxLevel : levelEnd );
+    
+    return true;
+}
+
+template<bool shapeAR>
+void pdsp::WaveTableOsc::process_mipmap(float* outputBuffer, const float* phaseBuffer, const float* shapeBuffer, float shape, float levelStart, float levelEnd, int bufferSize) noexcept {
+    
+    float*** mipmaps = waveTable->mipmaps;
+    float length = static_cast<float>(waveTable->length);
+    int maxLevel = waveTable->mipLevels - 1;
+    
+    // with audio rate increments the level is linearly interpolated along the buffer
+    float level = levelStart;
+    float levelInc = (levelEnd - levelStart) / static_cast<float>(bufferSize);
+    
+    for (int n = 0; n < bufferSize; ++n){
+        
+        if(shapeAR){
+            shape = shapeBuffer[n];
+        }
+        int shapeA = static_cast<int>(shape);
+        float shape_fract = shape - shapeA;
+        int shapeB = shapeA +1;
+        
+        // levelHigh is always alias-free, levelLow has one more octave of partials and it is faded
+        // out in the first half of the octave, before the folded partials go down in the audible range
+        int levelHigh = static_cast<int>(level);
+        if( static_cast<float>(levelHigh) < level ) levelHigh++;
+        // the accumulated increment can go a little over the last level
+        if( levelHigh > maxLevel ) levelHigh = maxLevel;
+        int levelLow = (levelHigh > 0) ? levelHigh-1 : 0;
+        float mix = (level - static_cast<float>(levelLow)) * 2.0f;
+        if(mix > 1.0f) mix = 1.0f;
+        
+        float index_f = phaseBuffer[n] * length;
+        int index_i = static_cast<int>(index_f);
+        float fract = index_f - index_i;
+        
+        const float* tableAL = mipmaps[ shapeA ][ levelLow ];
+        const float* tableAH = mipmaps[ shapeA ][ levelHigh ];
+        const float* tableBL = mipmaps[ shapeB ][ levelLow ];
+        const float* tableBH = mipmaps[ shapeB ][ levelHigh ];
+        
+        float waveA = interpolate_linear( interpolate_linear(tableAL[index_i], tableAL[index_i + 1], fract),
+                                          interpolate_linear(tableAH[index_i], tableAH[index_i + 1], fract), mix );
+        float waveB = interpolate_linear( interpolate_linear(tableBL[index_i], tableBL[index_i + 1], fract),
+                                          interpolate_linear(tableBH[index_i], tableBH[index_i + 1], fract), mix );
+        
+        outputBuffer[n] = interpolate_linear(waveA, waveB, shape_fract);
+        
+        level += levelInc;
+    }
+}
     
 float pdsp::WaveTableOsc::meter_index() const {
     return meter.load();
@@ -12,7 +12,7 @@ namespace pdsp{
     /*!
     @brief Wavetable oscillator
     
-    This is a wavetable oscillator that takes a pointer to a SampleBuffer and use that buffer as waveform table, where each waveform is a channel.
+    This is a wavetable oscillator that takes a pointer to a SampleBuffer and use that buffer as waveform table, where each waveform is a channel. If you patch a phase increment to in_inc() the band-limited levels of the WaveTable are selected and crossfaded following the oscillator frequency, so it doesn't alias at high pitches.
     */
 
 class WaveTableOsc : public OscillatorVariShape {
@@ -26,6 +26,11 @@ public:
     */
     void setTable(WaveTable& waveTable);
 
+    /*!
+    @brief Sets "inc" as selected input and returns this Unit ready to be patched. This is the phase increment of the oscillator, used for selecting the band-limited level of the waveforms, usually you patch the out_inc() of a PMPhasor to this. If not patched the waveforms are always used with all their partials.
+    */   
+    Patchable& in_inc();
+
     /*!
     @brief returns the actual index of the wavetable, updated at control rate. Thread-safe.
     */    
@@ -37,6 +42,12 @@ private:
     void oscillateShapeCR(float* outputBuffer, const float* phaseBuffer, const float shape, int bufferSize) noexcept override;
     void oscillateShapeAR(float* outputBuffer, const float* phaseBuffer, const float* shapeBuffer, int bufferSize) noexcept override;
     
+    template<bool shapeAR>
+    void process_mipmap(float* outputBuffer, const float* phaseBuffer, const float* shapeBuffer, float shape, float levelStart, float levelEnd, int bufferSize) noexcept;
+    
+    bool getLevels(float & levelStart, float & levelEnd, int bufferSize) noexcept;
+    
+    InputNode input_inc;
     WaveTable* waveTable;
     std::atomic<float> meter;
 };
@@ -32,6 +32,8 @@
 #include "core/Processor.h"
 #include "core/Formula.h"
 #include "core/Amp.h"
+#include "core/RealtimeChecker.h"
+#include "core/Profiler.h"
 
 #include "../math/header.h"
 #include "../messages/header.h"
@@ -63,6 +63,7 @@ void pdsp::GrainWindow::prepareUnit( int expectedBufferSize, double sampleRate )
 void pdsp::GrainWindow::changeLength( float newLength){
 
         length = sampleRate * newLength * 0.001f;
+        if( length < 1.0f ){ length = 1.0f; } // at least one sample
         baseInc = 1.0f / length;
         
 
@@ -81,7 +82,7 @@ void pdsp::GrainWindow::process(int bufferSize) noexcept{
 
                 int lenState;
                 const float* lenBuffer = processInput(input_length_ms, lenState);
-                if(lenState==Changed ){
+                if(lenState!=Unchanged ){ // at audio rate the length is taken from the first sample
                     changeLength(lenBuffer[0]);
                 }
 
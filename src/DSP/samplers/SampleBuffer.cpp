@@ -1,31 +1,52 @@
 
 #include "SampleBuffer.h"
+#include "stream/SampleStream.h"
+#include "SampleLoader.h"
 #include <iostream>
+#include <algorithm>
 
 pdsp::SampleBuffer::SampleBuffer()  {
     filePath = "file not loaded";
     buffer = nullptr;
     channels = 0;
     length = 0;
+    fileLength = 0;
     fileSampleRate = 11050.0f;
     verbose = false;
     mono = 0;
+    reader = nullptr;
+    loadRequest = 0;
 }
 
 
 pdsp::SampleBuffer::~SampleBuffer(){
+    if(loadRequest!=0){
+        SampleLoader::cancel(this);
+    }
     if(buffer!=nullptr){
         unLoad();
     }
 }
 
 pdsp::SampleBuffer::SampleBuffer(const pdsp::SampleBuffer& other) {
+    buffer = nullptr;
+    reader = nullptr;
+    loadRequest = 0;
+    verbose = other.verbose;
+    
+    if( other.reader!=nullptr ){ // opens the file again for its own stream
+        loadStreaming( other.filePath, other.length );
+        this->mono = other.mono;
+        return;
+    }
+    
     init( other.length, other.channels );
     
     if( buffer!=nullptr || other.buffer==nullptr ){
         this->filePath = other.filePath;
         this->channels = other.channels;
         this->length = other.length;
+        this->fileLength = other.length;
         this->fileSampleRate = other.fileSampleRate;
         this->verbose = other.verbose;
         this->mono = other.mono;
@@ -41,12 +62,20 @@ pdsp::SampleBuffer::SampleBuffer(const pdsp::SampleBuffer& other) {
 pdsp::SampleBuffer& pdsp::SampleBuffer::operator= (const pdsp::SampleBuffer& other) {
     unLoad();
   
+    if( other.reader!=nullptr ){
+        this->verbose = other.verbose;
+        loadStreaming( other.filePath, other.length );
+        this->mono = other.mono;
+        return *this;
+    }
+  
     init( other.length, other.channels );
     
     if( buffer!=nullptr || other.buffer==nullptr ){
         this->filePath = other.filePath;
         this->channels = other.channels;
         this->length = other.length;
+        this->fileLength = other.length;
         this->fileSampleRate = other.fileSampleRate;
         this->verbose = other.verbose;
         this->mono = other.mono;
@@ -75,6 +104,12 @@ void pdsp::SampleBuffer::setMonoChannel(int monoChannelIndex){
 
 void pdsp::SampleBuffer::unLoad(){
 
+    if(reader!=nullptr){
+        SampleStreamer::removeSource(reader);
+        delete reader;
+        reader = nullptr;
+    }
+
     for(int i=0; i<channels; ++i){
         ofx_deallocate_aligned(buffer[i]);
     }
@@ -84,11 +119,12 @@ void pdsp::SampleBuffer::unLoad(){
     buffer = nullptr;
     channels = 0;
     length = 0;
+    fileLength = 0;
     fileSampleRate = 11050.0f;
     //ratesRatio = 0.0f;
 }
 
-bool pdsp::SampleBuffer::loaded(){
+bool pdsp::SampleBuffer::loaded() const {
 	if (buffer != nullptr) {
 		return true;
 	}
@@ -138,6 +174,7 @@ void pdsp::SampleBuffer::load( float* interleavedBuffer, double sampleRate, long
     this->buffer = toReturn;
     this->channels = channels;
     this->length = channelLength;
+    this->fileLength = channelLength;
     this->fileSampleRate = sampleRate;
 
     if(verbose) std::cout <<"[pdsp] file correctly loaded into SampleBuffer\n";
@@ -171,6 +208,91 @@ void pdsp::SampleBuffer::load( std::string filePath ){
 }
 
 
+std::shared_future<bool> pdsp::SampleBuffer::loadAsync( std::string filePath, bool resample, bool normalize, std::function<void(SampleBuffer&, bool)> callback ){
+    if(verbose) std::cout<< "[pdsp] loading audio file in background: "<<filePath<<"\n";
+    return SampleLoader::load( this, filePath, resample, normalize, callback );
+}
+
+
+void pdsp::SampleBuffer::swapData( SampleBuffer & other ){
+    std::swap( buffer, other.buffer );
+    std::swap( channels, other.channels );
+    std::swap( length, other.length );
+    std::swap( fileLength, other.fileLength );
+    std::swap( fileSampleRate, other.fileSampleRate );
+    std::swap( reader, other.reader );
+    filePath.swap( other.filePath );
+    
+    if(mono>=channels){
+        mono = (channels>0) ? channels-1 : 0;
+    }
+}
+
+
+void pdsp::SampleBuffer::loadStreaming( std::string filePath, long headLength ){
+    
+    if(verbose) std::cout<< "[pdsp] streaming audio file: "<<filePath<<"\n";
+    
+    WavReader* newReader = new WavReader();
+    if( ! newReader->open( filePath ) ){
+        delete newReader;
+        if(verbose) std::cout<<"[pdsp] only .wav files can be streamed, loading the whole file\n";
+        load( filePath );
+        return;
+    }
+    
+    int channels = newReader->channels();
+    long head = (headLength < newReader->length()) ? headLength : newReader->length();
+    if(head < 1) head = 1;
+    
+    float ** toReturn;
+    toReturn = new float*[channels];
+    
+    for(int i=0; i<channels; ++i){
+        ofx_allocate_aligned(toReturn[i], head+1); //guard point for linear interpolation
+        
+        if(toReturn[i] == nullptr){
+            for(int j = 0; j<i; j++){ //deallocate already allocated vectors
+                ofx_deallocate_aligned(toReturn[j]);
+            }
+            delete [] toReturn;
+            delete newReader;
+            std::string error = "[pdsp] memory low, impossible to load sample\n";
+            if (verbose) std::cout << error;
+            this->filePath = error;
+            return; //abort
+        }
+        ofx_Aeq_Zero(toReturn[i], head+1);
+    }
+    
+    // the guard point is the first streamed frame
+    newReader->read( 0, head+1, toReturn );
+    
+    // the streamer thread opens the file again when it is played, so the streamed files don't keep a handle open
+    newReader->release();
+    
+    if(buffer!=nullptr){ // changing samples
+        unLoad();
+    }
+    
+    this->buffer = toReturn;
+    this->channels = channels;
+    this->length = head;
+    this->fileLength = newReader->length();
+    this->fileSampleRate = newReader->samplerate();
+    this->filePath = filePath;
+    this->reader = newReader;
+    
+    SampleStreamer::addSource(reader);
+    
+    if(verbose) std::cout << "[pdsp] sample rate: "<<this->fileSampleRate<<" | length: "<<this->fileLength<<" | channels: "<<this->channels<<" | preloaded: "<<this->length<<"\n";
+}
+
+bool pdsp::SampleBuffer::streaming() const {
+    return (reader != nullptr);
+}
+
+
 void pdsp::SampleBuffer::init( long tableLen, int numTables ){
     
     float ** newTables;
@@ -201,9 +323,14 @@ void pdsp::SampleBuffer::init( long tableLen, int numTables ){
 
     if(verbose) std::cout <<"[pdsp] SampleBuffer buffer initialized\n";  
     
+    if(buffer!=nullptr){
+        unLoad();
+    }
+    
     this->buffer = newTables;
     this->channels = numTables;
     this->length = tableLen;
+    this->fileLength = tableLen;
     this->fileSampleRate = Preparable::getGlobalSampleRate();
     
     std::string info = std::to_string(tableLen);
@@ -214,7 +341,10 @@ void pdsp::SampleBuffer::init( long tableLen, int numTables ){
 
 void pdsp::SampleBuffer::normalize( ){
     
-    if (buffer!=nullptr){
+    if (reader!=nullptr){
+        std::cout <<"[pdsp] impossible to normalize a streaming sample buffer\n";
+        pdsp_trace();
+    }else if (buffer!=nullptr){
         
         double max = -1.0f;
         for(int c=0; c<channels; ++c){
@@ -238,3 +368,67 @@ void pdsp::SampleBuffer::normalize( ){
     }
     
 }
+
+
+void pdsp::SampleBuffer::resample( double sampleRate ){
+    
+    if (reader!=nullptr){
+        std::cout <<"[pdsp] impossible to resample a streaming sample buffer\n";
+        pdsp_trace();
+        return;
+    }else if (buffer==nullptr){
+        std::cout <<"[pdsp] impossible to resample, sample buffer empty\n";
+        pdsp_trace();
+        return;
+    }
+    
+    if( sampleRate <= 0.0 || sampleRate == fileSampleRate ){
+        return;
+    }
+    
+    const int taps = 128;
+    const int phases = 512;
+    const int offset = taps/2 - 1;
+    
+    double step = fileSampleRate / sampleRate; // input frames for each output frame
+    double cutoff = (step > 1.0) ? 0.95 / step : 0.95; // the transition band ends near the nyquist frequency
+    
+    long newLength = static_cast<long>( static_cast<double>(length) / step );
+    if(newLength < 1) newLength = 1;
+    
+    SampleBuffer resampled;
+    resampled.setVerbose( verbose );
+    resampled.init( newLength, channels );
+    if( resampled.buffer==nullptr ){
+        this->filePath = resampled.filePath; // error
+        return;
+    }
+    
+    float* kernel = sincTable( Blackman, taps, phases, cutoff );
+    
+    // zeros before and after the data, for the kernel at the edges
+    std::vector<float> padded( length + taps*2, 0.0f );
+    
+    for(int c=0; c<channels; ++c){
+        std::copy( buffer[c], buffer[c] + length, padded.begin() + taps );
+        
+        float* output = resampled.buffer[c];
+        for(long n=0; n<newLength; ++n){
+            double position = static_cast<double>(n) * step;
+            long index = static_cast<long>(position);
+            float mu = static_cast<float>( position - index );
+            output[n] = interpolate_polyphase( padded.data() + taps + index - offset, kernel, taps, phases, mu );
+        }
+    }
+    
+    ofx_deallocate_aligned( kernel );
+    
+    resampled.fileSampleRate = sampleRate;
+    resampled.filePath = filePath;
+    
+    InputNode::whileNotProcessing( [&](){ swapData( resampled ); } );
+    
+    if(verbose) std::cout << "[pdsp] resampled to: "<<this->fileSampleRate<<" | length: "<<this->length<<"\n";
+    
+    // the old data is freed by resampled
+}
@@ -12,9 +12,12 @@
 #include "../../flags.h"
 
 #include "ofxAudioFile.h"
+#include "stream/WavReader.h"
 
 #include <cstring>
 #include <string>
+#include <future>
+#include <functional>
 
 namespace pdsp {
 
@@ -23,6 +26,9 @@ namespace pdsp {
 
     This is a class that contains data loaded from an audio file (or created in any other way). It is used by units that require samples like Sampler, FDLConvolver or TableOsc. On Windows it uses libsndfile to load audio file from path so if you want to use it you have to link libsndfile to your project, go in flags.h and uncomment #define PDSP_USE_LIBSNDFILE. You also use any method you have on you platform for getting an interleaved or a mono array of floats and load it with  load( float* interleavedBuffer, double sampleRate, int length, int channels=1 ). You can also use init() to initialize an empty table and manually fill it with your data.
     
+    Big .wav files can be streamed from disk with loadStreaming(), in this case only the first part of each file is kept in memory and the Samplers playing it read the rest through a background disk thread. Streaming SampleBuffers can be used only with Sampler (and with modules that use it, like GrainCloud), the other units use the data in memory and see only the preloaded head.
+
+    With loadAsync() the files are decoded on background threads and the data is replaced while the SampleBuffer is played, for changing a set of samples without stopping the audio or the main thread.
     */
 
 class SampleBuffer {
@@ -38,6 +44,16 @@ public:
     @param[in] filePath absolute or relative path to audio file
     */
     void    load( std::string filePath );
+
+    /*!
+    @brief loads the audio data from a file on a background thread and returns immediately. The files are decoded in parallel by a pool of threads, one for each core. When the file is decoded the new data replaces the old one between two audio buffers, so a SampleBuffer can be loaded while it is played, and the old data is freed outside of the audio thread. If more files are loaded into the same SampleBuffer only the last one is used.
+    @param[in] filePath absolute or relative path to audio file
+    @param[in] resample if true the data is converted to the global sample rate with resample(), so the Samplers play it without rate conversion. False if not given.
+    @param[in] normalize if true the data is normalized after loading. False if not given.
+    @param[in] callback function called from the loading thread when the load is done, with this SampleBuffer and true if the new data is in place. Don't destroy the SampleBuffer from the callback.
+    @return a future that is set to true when the new data is in place, or to false if the load failed or was replaced by a newer one
+    */
+    std::shared_future<bool> loadAsync( std::string filePath, bool resample=false, bool normalize=false, std::function<void(SampleBuffer&, bool)> callback=nullptr );
     
     /*!
     @brief loads the audio data from a given interleaved float array (or from a single non interleaved channel)
@@ -48,6 +64,18 @@ public:
     */
     void    load( float* interleavedBuffer, double sampleRate, long length, int channels=1 );
 
+    /*!
+    @brief opens an audio file for streaming from disk, only the first headLength frames of each channel are loaded into memory. Only .wav files can be streamed, other files are loaded with load(). The Samplers start to stream the rest of the file when triggered, so the head should be long enough to cover the time needed to read from disk. Samplers that start playing after the head (or in reverse) will play silence until the data is read from disk.
+    @param[in] filePath absolute or relative path to audio file
+    @param[in] headLength frames kept in memory, if not given PDSP_SAMPLEBUFFER_STREAM_HEAD is used
+    */
+    void    loadStreaming( std::string filePath, long headLength=PDSP_SAMPLEBUFFER_STREAM_HEAD );
+
+    /*!
+    @brief returns true if the SampleBuffer is streaming its file from disk
+    */
+    bool    streaming() const;
+
     /*!
     @brief unload the data from the buffer and free the allocated memory
     */    
@@ -56,7 +84,7 @@ public:
     /*!
     @brief returns true if data has been loaded into the SampleBuffer
     */ 
-    bool    loaded();
+    bool    loaded() const;
     
     /*!
     @brief inits the SampleBuffer with an empty table (all the values set to 0.0f)
@@ -70,6 +98,12 @@ public:
 
     */
     void    normalize( );
+
+    /*!
+    @brief converts the data to the given sample rate with a 128 points windowed sinc, only the frequencies below the lowest of the two nyquist frequencies are kept. The new data replaces the old one between two audio buffers, so this can be used on a SampleBuffer that is being played. Streaming SampleBuffers can't be resampled.
+    @param[in] sampleRate the new sample rate
+    */
+    void    resample( double sampleRate );
     
     /*!
     @brief some Units automatically select one channel if more than one are loaded. This set this default channel.
@@ -108,13 +142,26 @@ public:
     */    
     long           length;
     
+    /*!
+    @brief length of the whole audio file, when streaming only the first length samples are in buffer. Otherwise it is equal to length.
+    */    
+    long           fileLength;
+    
     /*!
     @brief sample rate of the loaded channels
     */    
     double          fileSampleRate;
 
 private:
+    friend class SampleStream;
+    friend class SampleLoader;
+
+    // swaps the data with another SampleBuffer, call it with InputNode::whileNotProcessing() if the buffer is played
+    void            swapData( SampleBuffer & other );
+
     bool            verbose;
+    WavReader*      reader; // only in streaming mode
+    int             loadRequest; // guarded by the SampleLoader mutex
 
 };
 
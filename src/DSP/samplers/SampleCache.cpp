@@ -0,0 +1,161 @@
+
+#include "SampleCache.h"
+
+bool pdsp::SampleCache::Key::operator< ( const Key & other ) const {
+    if( filePath != other.filePath ){ return filePath < other.filePath; }
+    if( sampleRate != other.sampleRate ){ return sampleRate < other.sampleRate; }
+    return channel < other.channel;
+}
+
+pdsp::SampleCache::SampleCache(){
+    memoryLimit = PDSP_SAMPLECACHE_MEMORY;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
+pdsp::SampleCache & pdsp::SampleCache::get(){
+    // never destroyed, as the SampleStreamer
+    static SampleCache* cache = new SampleCache();
+    return *cache;
+}
+
+std::shared_ptr<const pdsp::SampleBuffer> pdsp::SampleCache::load( std::string filePath, double sampleRate, int channel ){
+    SampleCache & cache = get();
+
+    Key key;
+    key.filePath = filePath;
+    key.sampleRate = (sampleRate > 0.0) ? sampleRate : 0.0;
+    key.channel = (channel >= 0) ? channel : -1;
+
+    std::promise<bool> promise;
+    std::shared_ptr<SampleBuffer> buffer;
+    std::shared_future<bool> cached;
+    {
+        std::lock_guard<std::mutex> lock( cache.mutex );
+        auto found = cache.index.find( key );
+        if( found != cache.index.end() ){
+            cache.entries.splice( cache.entries.begin(), cache.entries, found->second );
+            buffer = found->second->buffer;
+            cached = found->second->ready;
+        }else{
+            // the entry is added before decoding, so the other threads wait for this one
+            Entry entry;
+            entry.key = key;
+            entry.buffer = std::make_shared<SampleBuffer>();
+            entry.ready = promise.get_future().share();
+            entry.loaded = false;
+            entry.bytes = 0;
+            cache.entries.push_front( entry );
+            cache.index[key] = cache.entries.begin();
+            cache.misses++;
+            buffer = entry.buffer;
+        }
+    }
+
+    if( cached.valid() ){
+        // another thread could be still decoding it, if that fails the file is not in the cache
+        bool loaded = cached.get();
+        std::lock_guard<std::mutex> lock( cache.mutex );
+        if( loaded ){
+            cache.hits++;
+        }else{
+            cache.misses++;
+        }
+        return buffer;
+    }
+
+    decode( *buffer, key );
+
+    {
+        std::lock_guard<std::mutex> lock( cache.mutex );
+        auto found = cache.index.find( key );
+        if( buffer->loaded() ){
+            found->second->loaded = true;
+            found->second->bytes = sizeof(float) * size_t(buffer->channels) * size_t(buffer->length + 1);
+        }else{
+            // not cached, the next load() tries again
+            cache.entries.erase( found->second );
+            cache.index.erase( found );
+        }
+        cache.evict( cache.memoryLimit );
+    }
+    promise.set_value( buffer->loaded() );
+
+    return buffer;
+}
+
+void pdsp::SampleCache::decode( SampleBuffer & buffer, const Key & key ){
+
+    buffer.load( key.filePath );
+    if( ! buffer.loaded() ){ return; }
+
+    if( key.channel >= 0 && buffer.channels > 1 ){
+        int channel = (key.channel < buffer.channels) ? key.channel : buffer.channels-1;
+        // load() copies the data before freeing the old buffers
+        buffer.load( buffer.buffer[channel], buffer.fileSampleRate, buffer.length, 1 );
+        buffer.filePath = key.filePath;
+    }
+
+    if( key.sampleRate > 0.0 ){
+        buffer.resample( key.sampleRate );
+    }
+}
+
+void pdsp::SampleCache::evict( size_t limit ){
+    // only the cache references the unused buffers
+    size_t unused = 0;
+    for( Entry & entry : entries ){
+        if( entry.loaded && entry.buffer.use_count() == 1 ){
+            unused += entry.bytes;
+        }
+    }
+
+    for( auto it = entries.end(); it != entries.begin() && unused > limit; ){
+        --it;
+        if( it->loaded && it->buffer.use_count() == 1 ){
+            unused -= it->bytes;
+            index.erase( it->key );
+            it = entries.erase( it );
+            evictions++;
+        }
+    }
+}
+
+void pdsp::SampleCache::setMemoryLimit( size_t bytes ){
+    SampleCache & cache = get();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.memoryLimit = bytes;
+    cache.evict( bytes );
+}
+
+void pdsp::SampleCache::release(){
+    SampleCache & cache = get();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+    cache.evict( 0 );
+}
+
+pdsp::SampleCache::Stats pdsp::SampleCache::stats(){
+    SampleCache & cache = get();
+    std::lock_guard<std::mutex> lock( cache.mutex );
+
+    Stats stats;
+    stats.samples = 0;
+    stats.used = 0;
+    stats.bytes = 0;
+    stats.usedBytes = 0;
+    for( Entry & entry : cache.entries ){
+        if( entry.loaded ){
+            stats.samples++;
+            stats.bytes += entry.bytes;
+            if( entry.buffer.use_count() > 1 ){
+                stats.used++;
+                stats.usedBytes += entry.bytes;
+            }
+        }
+    }
+    stats.hits = cache.hits;
+    stats.misses = cache.misses;
+    stats.evictions = cache.evictions;
+    return stats;
+}
@@ -0,0 +1,105 @@
+
+// SampleCache.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_SAMPLERS_SAMPLECACHE_H_INCLUDED
+#define PDSP_SAMPLERS_SAMPLECACHE_H_INCLUDED
+
+#include "SampleBuffer.h"
+#include <memory>
+#include <list>
+#include <map>
+#include <mutex>
+#include <future>
+
+namespace pdsp {
+
+    /*!
+    @brief Process-wide cache of the loaded audio files, that shares the same SampleBuffer between all the units that use the same file.
+
+    SampleCache::load() decodes each file only once and returns a shared pointer to the SampleBuffer, the next calls with the same file and options return the same SampleBuffer. Give the pointer to the units with get(), for example sampler.addSample( sample.get() ), and keep the shared pointer as long as the units use it. The shared SampleBuffers are const, as they can be used by many units. When a SampleBuffer is not referenced anymore it is kept in the cache for the next load(), if the memory of the unused samples is over the limit the least recently used ones are freed. load() can be called from many threads, if the same file is requested at the same time it is decoded only once.
+    */
+
+class SampleCache {
+
+public:
+    /*!
+    @brief memory usage of the cache, returned by stats()
+    */
+    struct Stats {
+        int     samples;    // loaded files in the cache
+        int     used;       // files that are referenced outside of the cache
+        size_t  bytes;      // memory used by all the files
+        size_t  usedBytes;  // memory used by the referenced files
+        long    hits;       // load() calls that returned a loaded file without decoding it
+        long    misses;     // load() calls that decoded the file or waited for a decoding that failed
+        long    evictions;  // unused files freed
+    };
+
+    /*!
+    @brief returns the shared SampleBuffer for the given file and options, the file is loaded only if it is not already in the cache. If the file can't be loaded an empty SampleBuffer is returned and it is not cached.
+    @param[in] filePath absolute or relative path to audio file
+    @param[in] sampleRate if greater than 0.0 the file is converted to this sample rate with SampleBuffer::resample(), 0.0 if not given
+    @param[in] channel if 0 or greater only this channel of the file is kept, -1 (all the channels) if not given
+    */
+    static std::shared_ptr<const SampleBuffer> load( std::string filePath, double sampleRate=0.0, int channel=-1 );
+
+    /*!
+    @brief sets the memory kept for the files that are not used anymore, the default is PDSP_SAMPLECACHE_MEMORY
+    @param[in] bytes memory limit in bytes
+    */
+    static void setMemoryLimit( size_t bytes );
+
+    /*!
+    @brief frees all the files that are not used anymore
+    */
+    static void release();
+
+    /*!
+    @brief returns the number of cached files and their memory usage
+    */
+    static Stats stats();
+
+private:
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    struct Key {
+        std::string filePath;
+        double      sampleRate;
+        int         channel;
+        bool operator< ( const Key & other ) const;
+    };
+
+    struct Entry {
+        Key                             key;
+        std::shared_ptr<SampleBuffer>   buffer;
+        std::shared_future<bool>        ready;
+        bool                            loaded;
+        size_t                          bytes;
+    };
+/*!
+    @endcond
+*/
+
+    SampleCache();
+    static SampleCache & get();
+
+    static void decode( SampleBuffer & buffer, const Key & key );
+    void evict( size_t limit );
+
+    std::list<Entry>                                entries; // the most recently used first
+    std::map<Key, std::list<Entry>::iterator>       index;
+
+    size_t      memoryLimit;
+    long        hits;
+    long        misses;
+    long        evictions;
+
+    std::mutex  mutex;
+};
+
+} // end pdsp namespace
+
+#endif  // PDSP_SAMPLERS_SAMPLECACHE_H_INCLUDED
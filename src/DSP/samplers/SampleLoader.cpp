@@ -0,0 +1,135 @@
+
+#include "SampleLoader.h"
+#include <algorithm>
+
+pdsp::SampleLoader::SampleLoader(){}
+
+pdsp::SampleLoader & pdsp::SampleLoader::get(){
+    // never destroyed, as the SampleStreamer
+    static SampleLoader* loader = new SampleLoader();
+    return *loader;
+}
+
+std::shared_future<bool> pdsp::SampleLoader::load( SampleBuffer* target, const std::string & filePath, bool resample, bool normalize, const std::function<void(SampleBuffer&, bool)> & callback ){
+    SampleLoader & loader = get();
+    
+    Job job;
+    job.target = target;
+    job.filePath = filePath;
+    job.resample = resample;
+    job.normalize = normalize;
+    job.callback = callback;
+    job.promise = std::make_shared<std::promise<bool>>();
+    std::shared_future<bool> future = job.promise->get_future().share();
+    
+    {
+        std::lock_guard<std::mutex> lock( loader.mutex );
+        job.request = ++target->loadRequest;
+        loader.queue.push_back( job );
+
+        // the threads are started only if some file is loaded in background
+        if( loader.workers.empty() ){
+            int threads = std::thread::hardware_concurrency();
+            if( threads < 1 ){ threads = 1; }
+            for( int i=0; i<threads; ++i ){
+                loader.workers.push_back( std::thread( &SampleLoader::threadFunction, &loader ) );
+            }
+        }
+    }
+    loader.condition.notify_one();
+    
+    return future;
+}
+
+void pdsp::SampleLoader::cancel( SampleBuffer* target ){
+    SampleLoader & loader = get();
+    std::unique_lock<std::mutex> lock( loader.mutex );
+    
+    for( auto it = loader.queue.begin(); it != loader.queue.end(); ){
+        if( it->target == target ){
+            it->promise->set_value( false );
+            it = loader.queue.erase( it );
+        }else{
+            ++it;
+        }
+    }
+    
+    while( std::find( loader.running.begin(), loader.running.end(), target ) != loader.running.end() ){
+        loader.finished.wait( lock );
+    }
+}
+
+void pdsp::SampleLoader::threadFunction(){
+    while( true ){
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            while( queue.empty() ){
+                condition.wait( lock );
+            }
+            job = queue.front();
+            queue.pop_front();
+            running.push_back( job.target );
+        }
+        
+        run( job );
+        
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            running.erase( std::find( running.begin(), running.end(), job.target ) );
+        }
+        finished.notify_all();
+    }
+}
+
+void pdsp::SampleLoader::run( Job & job ){
+    
+    SampleBuffer loaded;
+    loaded.setVerbose( job.target->verbose );
+    
+    // a newer load of the same SampleBuffer makes this one useless
+    bool superseded;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        superseded = ( job.request != job.target->loadRequest );
+    }
+    
+    if( ! superseded ){
+        loaded.load( job.filePath );
+        if( loaded.loaded() ){
+            double sampleRate = Preparable::getGlobalSampleRate();
+            if( job.resample && sampleRate != loaded.fileSampleRate ){
+                loaded.resample( sampleRate );
+            }
+            if( job.normalize ){
+                loaded.normalize();
+            }
+        }
+    }
+    
+    bool success = false;
+    if( loaded.loaded() ){
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            superseded = ( job.request != job.target->loadRequest );
+        }
+        // the mutex is not held while waiting for the audio thread, so load() and the other workers don't block
+        // the request is checked again inside, as a newer load could have been requested in the meantime
+        if( ! superseded ){
+            SampleBuffer* target = job.target;
+            InputNode::whileNotProcessing( [&](){
+                std::lock_guard<std::mutex> lock( mutex );
+                if( job.request == target->loadRequest ){
+                    target->swapData( loaded );
+                    success = true;
+                }
+            });
+        }
+    }
+    // here the old data is freed by the destructor of loaded
+    
+    if( job.callback ){
+        job.callback( *job.target, success );
+    }
+    job.promise->set_value( success );
+}
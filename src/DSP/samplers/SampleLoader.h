@@ -0,0 +1,61 @@
+
+// SampleLoader.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_SAMPLERS_SAMPLELOADER_H_INCLUDED
+#define PDSP_SAMPLERS_SAMPLELOADER_H_INCLUDED
+
+#include "SampleBuffer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+
+namespace pdsp {
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+    // pool of background threads that decode the files for SampleBuffer::loadAsync()
+    class SampleLoader{
+    public:
+        static std::shared_future<bool> load( SampleBuffer* target, const std::string & filePath, bool resample, bool normalize, const std::function<void(SampleBuffer&, bool)> & callback );
+
+        // removes the queued loads of the target and waits for the running ones, used when a SampleBuffer is destroyed
+        static void cancel( SampleBuffer* target );
+
+    private:
+        struct Job {
+            SampleBuffer*   target;
+            std::string     filePath;
+            bool            resample;
+            bool            normalize;
+            int             request;
+            std::function<void(SampleBuffer&, bool)>    callback;
+            std::shared_ptr<std::promise<bool>>         promise;
+        };
+
+        SampleLoader();
+        static SampleLoader & get();
+
+        void threadFunction();
+        void run( Job & job );
+
+        std::deque<Job>             queue;
+        std::vector<SampleBuffer*>  running;
+
+        std::vector<std::thread>    workers;
+        std::mutex                  mutex;
+        std::condition_variable     condition;
+        std::condition_variable     finished;
+    };
+
+/*!
+    @endcond
+*/
+}
+
+#endif // PDSP_SAMPLERS_SAMPLELOADER_H_INCLUDED
@@ -18,6 +18,9 @@ pdsp::Sampler::Sampler(){
         readIndex = 0.0f;
         direction = 1.0f;
         isPlaying = false;
+        interpolation = Smooth;
+        // set here and never changed, so the audio thread can't see the Sinc mode before the table
+        sincTable = &SincTable::get();
         
         positionMeter.store(0.0f);
         positionDivider = 0.001f;
@@ -70,7 +73,7 @@ pdsp::Patchable& pdsp::Sampler::out_signal(){
 }
 
 
-void pdsp::Sampler::addSample(SampleBuffer* newSample, int channel){
+void pdsp::Sampler::addSample(const SampleBuffer* newSample, int channel){
         samples.push_back(newSample);
         channels.push_back(channel);
         if(sample==nullptr){
@@ -78,7 +81,7 @@ void pdsp::Sampler::addSample(SampleBuffer* newSample, int channel){
         }  
 }
 
-bool pdsp::Sampler::setSample(SampleBuffer* newSample, int index, int channel){
+bool pdsp::Sampler::setSample(const SampleBuffer* newSample, int index, int channel){
         if(index< int(samples.size()) && index>=0){
                 samples[index] = newSample;
                 channels[index] = channel;
@@ -93,6 +96,10 @@ bool pdsp::Sampler::setSample(SampleBuffer* newSample, int index, int channel){
         }
 }
 
+void pdsp::Sampler::setInterpolation( Interpolator_t type ){
+        interpolation = type;
+}
+
 void pdsp::Sampler::prepareUnit( int expectedBufferSize, double sampleRate ) {
         readIndex = 0.0;
         incBase = 1.0 / sampleRate;
@@ -160,6 +167,30 @@ void pdsp::Sampler::process_once( const float* pitchModBuffer)noexcept{
         }
 }
 
+inline float pdsp::Sampler::frame( long index ) const noexcept {
+        if( index<0 || index>=sample->fileLength ){
+                return 0.0f;
+        }else if( index < sample->length ){
+                return sample->buffer[channel][index];
+        }else{
+                return stream.get( index );
+        }
+}
+
+inline float pdsp::Sampler::interpolateSinc( long index, float mu, const float* kernel ) const noexcept {
+        long first = index - SincTable::offset;
+        if( first>=0 && first+SincTable::taps <= sample->length ){
+                return interpolate_polyphase( sample->buffer[channel] + first, kernel, SincTable::taps, SincTable::phases, mu );
+        }else{
+                // near the edges or streamed from disk
+                float frames[SincTable::taps];
+                for( int i=0; i<SincTable::taps; ++i ){
+                        frames[i] = frame( first + i );
+                }
+                return interpolate_polyphase( frames, kernel, SincTable::taps, SincTable::phases, mu );
+        }
+}
+
 template<bool pitchModAR, bool triggerAR>
 void pdsp::Sampler::process_audio( const float* pitchModBuffer, const float* triggerBuffer, int bufferSize)noexcept{
 
@@ -167,6 +198,11 @@ void pdsp::Sampler::process_audio( const float* pitchModBuffer, const float* tri
         
         sample = samples[sampleIndex]; // this will make hot-swap of SampleBuffer files more robust
         channel = channels[sampleIndex]; 
+        if(channel >= sample->channels){
+                channel = sample->channels - 1; // the sample could have been loaded again with less channels
+        }
+        
+        stream.update( sample, channel, static_cast<long>(readIndex), direction > 0.0 );
 
         if(pitchModAR){
                 //
@@ -174,6 +210,12 @@ void pdsp::Sampler::process_audio( const float* pitchModBuffer, const float* tri
                 //in this way is always correct even with oversample
         }
 
+        const Interpolator_t mode = interpolation; // can be changed by another thread
+        const float* kernel = nullptr;
+        if(mode==Sinc){
+                kernel = sincTable->kernel( inc );
+        }
+
         for(int n=0; n<bufferSize; ++n){
 
                 if(triggerAR){
@@ -188,14 +230,29 @@ void pdsp::Sampler::process_audio( const float* pitchModBuffer, const float* tri
                 }
 
                 long readIndex_int = static_cast<long>(readIndex);
-                if(readIndex_int>=0 && readIndex_int < sample->length){
+                if(mode==Sinc && readIndex>=0.0 && readIndex_int < sample->fileLength){
+                    
+                    if(pitchModAR){
+                        kernel = sincTable->kernel( inc );
+                    }
+                    float mu = static_cast<float>( readIndex - readIndex_int );
+                    
+                        outputBuffer[n] = interpolateSinc( readIndex_int, mu, kernel );
+                }else if(readIndex_int>=0 && readIndex_int < sample->length){
                     
                     long index_int = static_cast<long> (readIndex);
                     double mu = readIndex - index_int;
                     double x1 = sample->buffer[channel][index_int];
                     double x2 = sample->buffer[channel][index_int+1];
 
-                        outputBuffer[n] = interpolate_smooth( x1, x2, mu );
+                        outputBuffer[n] = (mode==Linear) ? interpolate_linear( x1, x2, mu ) : interpolate_smooth( x1, x2, mu );
+                }else if(readIndex_int>=0 && readIndex_int < sample->fileLength){
+                    // streamed from disk
+                    double mu = readIndex - readIndex_int;
+                    double x1 = stream.get( readIndex_int );
+                    double x2 = stream.get( readIndex_int+1 );
+
+                        outputBuffer[n] = (mode==Linear) ? interpolate_linear( x1, x2, mu ) : interpolate_smooth( x1, x2, mu );
                 }else{
                         outputBuffer[n] = 0.0f;
                         isPlaying = false;
@@ -240,6 +297,9 @@ void pdsp::Sampler::selectSample( int n, int bufferSize, float trigger )noexcept
         //SET START POSITION
         sample = samples[sampleIndex];
         channel = channels[sampleIndex];
+        if(channel >= sample->channels){
+                channel = sample->channels - 1;
+        }
         
         trigger = (trigger > 1.0f) ? 1.0f : trigger;
         trigger = (trigger < 0.0f) ? 0.0f : trigger;
@@ -258,7 +318,7 @@ void pdsp::Sampler::selectSample( int n, int bufferSize, float trigger )noexcept
         start = (start > 1.0f) ? 1.0f : start;
         start = (start < 0.0f) ? 0.0f : start;
         
-        float lenFloat = static_cast<float>(sample->length);
+        float lenFloat = static_cast<float>(sample->fileLength);
         readIndex = start * lenFloat;
         positionDivider = 1.0f / lenFloat;
 
@@ -270,4 +330,6 @@ void pdsp::Sampler::selectSample( int n, int bufferSize, float trigger )noexcept
             direction = 1.0;
         }
 
+        stream.start( sample, channel, static_cast<long>(readIndex), direction > 0.0 );
+
 }
@@ -9,12 +9,14 @@
 
 #include "../pdspCore.h"
 #include "SampleBuffer.h"
+#include "stream/SampleStream.h"
+#include "SincTable.h"
 
 namespace pdsp {
     /*!
     @brief plays SampleBuffer
 
-    This class plays SampleBuffers, it can change the sample pitch, change the start position, play in revers, and select a different sample when is triggered with in_select().
+    This class plays SampleBuffers, it can change the sample pitch, change the start position, play in revers, and select a different sample when is triggered with in_select(). SampleBuffers loaded with loadStreaming() are played from memory for their preloaded head and then streamed from disk.
     */
 
 
@@ -64,7 +66,7 @@ public:
     @param[in] newSample pointer to a SampleBuffer
     @param[in] channel selelect channel, usually 0 is left and 1 right, if not given 0 is used
     */ 
-    void addSample(SampleBuffer* newSample, int channel=0);
+    void addSample(const SampleBuffer* newSample, int channel=0);
     
     /*!
     @brief Sets the SampleBuffer pointer at the given index to a new pointer.
@@ -72,7 +74,13 @@ public:
     @param[in] index sample index
     @param[in] channel selelect channel, usually 0 is left and 1 right, if not given 0 is used
     */ 
-    bool setSample(SampleBuffer* newSample, int index, int channel=0);
+    bool setSample(const SampleBuffer* newSample, int index, int channel=0);
+
+    /*!
+    @brief Sets the interpolation used to read the samples. Smooth is the default. Linear is the cheapest. Sinc is a band limited interpolation with a 16 points windowed sinc: it doesn't add aliasing when the sample is pitched up, as the cutoff of the kernel is lowered following the playback speed (up to two octaves up), and it is cleaner when the sample is pitched down. Sinc costs more than the other modes but less than playing the sampler oversampled 4x.
+    @param[in] type interpolation type
+    */ 
+    void setInterpolation( Interpolator_t type );
 
     /*!
     @brief returns a value from 0.0f to 1.0f that broadly rapresent the "playhead" of the current sample. This method is thread-safe.
@@ -93,6 +101,9 @@ private:
     void process_audio( const float* pitchModBuffer, const float* triggerBuffer, int bufferSize)noexcept;
 
     void selectSample( int n, int bufferSize, float trigger) noexcept;
+
+    float frame( long index ) const noexcept;
+    float interpolateSinc( long index, float mu, const float* kernel ) const noexcept;
     
     InputNode input_trig;
     InputNode input_pitch_mod;
@@ -104,12 +115,16 @@ private:
     
     double readIndex;
     double inc;
-    SampleBuffer* sample;
+    const SampleBuffer* sample;
+    SampleStream stream;
     int channel;
     int sampleIndex;
     bool isPlaying;
     
-    std::vector<SampleBuffer*> samples;
+    Interpolator_t interpolation;
+    const SincTable* sincTable;
+    
+    std::vector<const SampleBuffer*> samples;
     
     double incBase;
     double direction;
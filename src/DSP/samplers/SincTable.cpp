@@ -0,0 +1,20 @@
+
+#include "SincTable.h"
+
+pdsp::SincTable::SincTable(){
+    for( int i=0; i<cutoffs; ++i ){
+        ratios[i] = pow( 2.0, static_cast<double>(i) / 4.0 );
+        kernels[i] = sincTable( Blackman, taps, phases, 1.0 / ratios[i] );
+    }
+}
+
+pdsp::SincTable::~SincTable(){
+    for( int i=0; i<cutoffs; ++i ){
+        ofx_deallocate_aligned( kernels[i] );
+    }
+}
+
+const pdsp::SincTable & pdsp::SincTable::get(){
+    static SincTable table;
+    return table;
+}
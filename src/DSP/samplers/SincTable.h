@@ -0,0 +1,50 @@
+
+// SincTable.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_SAMPLERS_SINCTABLE_H_INCLUDED
+#define PDSP_SAMPLERS_SINCTABLE_H_INCLUDED
+
+#include "../pdspCore.h"
+
+namespace pdsp {
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    // polyphase sinc kernels used by the Sampler for the Sinc interpolation, shared between all the samplers
+    // there is a kernel for each cutoff, the cutoff is lowered when the sample is played faster than its rate
+    class SincTable{
+    public:
+        static const int taps = 16;
+        static const int phases = 256;
+        static const int cutoffs = 9; // a cutoff each 3 semitones, up to two octaves
+        
+        // the first tap is at the frame index-offset, the interpolated point is between the frames index and index+1
+        // that are the taps offset and offset+1
+        static const int offset = taps/2 - 1;
+        
+        ~SincTable();
+
+        // returns the shared table, the kernels are calculated at the first call, when the first Sampler is constructed
+        static const SincTable & get();
+        
+        // returns the kernel with the right cutoff for the given absolute increment
+        inline const float* kernel( double increment ) const noexcept {
+            int i = 0;
+            while( i < cutoffs-1 && increment > ratios[i] ){ ++i; }
+            return kernels[i];
+        }
+        
+    private:
+        SincTable();
+        
+        float* kernels[cutoffs];
+        double ratios[cutoffs];
+    };
+/*!
+    @endcond
+*/
+}
+
+#endif  // PDSP_SAMPLERS_SINCTABLE_H_INCLUDED
@@ -0,0 +1,276 @@
+
+#include "SampleStream.h"
+#include "../SincTable.h"
+#include <algorithm>
+#include <chrono>
+
+#define PDSP_SAMPLESTREAM_RING_MASK (PDSP_SAMPLESTREAM_RING_SIZE-1)
+#define PDSP_SAMPLESTREAM_FRAMES_MASK 0xFFFFFFFF
+
+pdsp::SampleStream::SampleStream(){
+    sequence = 0;
+    source = nullptr;
+    channel = 0;
+    begin = 0;
+    forward = true;
+    consumed = 0;
+    filled = 0;
+    ring = nullptr;
+
+    generation = 0;
+    currentSource = nullptr;
+    currentChannel = 0;
+    currentForward = true;
+    currentStart = 0;
+    consumedFrames = 0;
+    availableFrames = 0;
+    currentRing = nullptr;
+
+    servedGeneration = 0;
+    servedFrames = 0;
+
+    SampleStreamer::addStream( this );
+}
+
+pdsp::SampleStream::SampleStream(const SampleStream & other) : SampleStream() {}
+
+pdsp::SampleStream& pdsp::SampleStream::operator=(const SampleStream & other){ return *this; }
+
+pdsp::SampleStream::~SampleStream(){
+    SampleStreamer::removeStream( this );
+    float* toFree = ring.load();
+    ofx_deallocate_aligned( toFree );
+}
+
+void pdsp::SampleStream::start( const SampleBuffer* sample, int channel, long position, bool forward ) noexcept {
+
+    currentSource = sample->reader;
+    currentChannel = channel;
+    currentForward = forward;
+    if( currentSource == nullptr ){ return; }
+
+    // starts a bit before the position for the interpolation, in reverse the window goes backward from first
+    long first;
+    if( forward ){
+        long head = sample->length;
+        first = position - SincTable::taps;
+        first = ( first > head ) ? first : head;
+    }else{
+        long end = sample->reader->length();
+        first = position + SincTable::taps + 1;
+        first = ( first < end ) ? first : end;
+    }
+
+    // sequence lock, the streamer discards the request if the sequence changes while it reads it
+    uint32_t odd = generation + 1;
+    sequence.store( odd, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    generation += 2;
+    this->source.store( sample->reader, std::memory_order_relaxed );
+    this->channel.store( channel, std::memory_order_relaxed );
+    this->begin.store( first, std::memory_order_relaxed );
+    this->forward.store( forward, std::memory_order_relaxed );
+    consumed.store( uint64_t(generation) << 32, std::memory_order_relaxed );
+
+    sequence.store( generation, std::memory_order_release );
+
+    currentStart = first;
+    consumedFrames = 0;
+    availableFrames = 0;
+
+    SampleStreamer::notify();
+}
+
+void pdsp::SampleStream::update( const SampleBuffer* sample, int channel, long position, bool forward ) noexcept {
+
+    if( sample->reader == nullptr ){ return; }
+
+    if( sample->reader != currentSource || channel != currentChannel || forward != currentForward ){
+        start( sample, channel, position, forward );
+        return;
+    }
+
+    uint64_t state = filled.load( std::memory_order_acquire );
+    if( uint32_t(state >> 32) == generation ){
+        availableFrames = long( state & PDSP_SAMPLESTREAM_FRAMES_MASK );
+        currentRing = ring.load( std::memory_order_acquire );
+    }
+
+    // the head is played from memory
+    if( position < sample->length ){ return; }
+
+    // frames from the start of the window, going backward in reverse
+    long rel = forward ? position - currentStart : currentStart - 1 - position;
+
+    if( rel < consumedFrames || rel > availableFrames + PDSP_SAMPLESTREAM_RING_SIZE ){
+        start( sample, channel, position, forward );
+    }else if( rel - SincTable::taps > consumedFrames ){
+        // the window slides following the position, keeping the frames already played needed for the interpolation
+        // so the streamer can go on prefetching the frames that come next
+        consumedFrames = rel - SincTable::taps;
+        consumed.store( (uint64_t(generation) << 32) | uint64_t(consumedFrames), std::memory_order_release );
+    }
+}
+
+
+pdsp::SampleStreamer::SampleStreamer(){
+    scratch.resize( PDSP_SAMPLESTREAM_READ_BLOCK );
+    pinnedStream = nullptr;
+    pinnedReader = nullptr;
+}
+
+pdsp::SampleStreamer & pdsp::SampleStreamer::get(){
+    // never destroyed, so SampleBuffers and Samplers with static storage can unregister at exit
+    static SampleStreamer* streamer = new SampleStreamer();
+    return *streamer;
+}
+
+void pdsp::SampleStreamer::addStream( SampleStream* stream ){
+    SampleStreamer & streamer = get();
+    std::lock_guard<std::mutex> lock( streamer.mutex );
+    streamer.streams.push_back( stream );
+}
+
+void pdsp::SampleStreamer::removeStream( SampleStream* stream ){
+    SampleStreamer & streamer = get();
+    std::unique_lock<std::mutex> lock( streamer.mutex );
+    streamer.unpinned.wait( lock, [&](){ return streamer.pinnedStream != stream; } );
+    streamer.streams.erase( std::remove( streamer.streams.begin(), streamer.streams.end(), stream ), streamer.streams.end() );
+}
+
+void pdsp::SampleStreamer::addSource( WavReader* reader ){
+    SampleStreamer & streamer = get();
+    std::lock_guard<std::mutex> lock( streamer.mutex );
+    streamer.sources.push_back( reader );
+
+    // the thread is started only if some file is streamed
+    if( ! streamer.worker.joinable() ){
+        streamer.worker = std::thread( &SampleStreamer::threadFunction, &streamer );
+    }
+}
+
+void pdsp::SampleStreamer::removeSource( WavReader* reader ){
+    SampleStreamer & streamer = get();
+    std::unique_lock<std::mutex> lock( streamer.mutex );
+    streamer.unpinned.wait( lock, [&](){ return streamer.pinnedReader != reader; } );
+    streamer.sources.erase( std::remove( streamer.sources.begin(), streamer.sources.end(), reader ), streamer.sources.end() );
+    streamer.openSources.erase( std::remove( streamer.openSources.begin(), streamer.openSources.end(), reader ), streamer.openSources.end() );
+}
+
+void pdsp::SampleStreamer::notify(){
+    get().condition.notify_one();
+}
+
+void pdsp::SampleStreamer::flush(){
+    SampleStreamer & streamer = get();
+    std::lock_guard<std::mutex> serving( streamer.serviceMutex );
+    while( streamer.servicePass() ){}
+}
+
+bool pdsp::SampleStreamer::servicePass(){
+    std::unique_lock<std::mutex> lock( mutex );
+    // one block for each stream at time, so all the playing samplers are filled at the same pace
+    // the list can change while a file is read, a stream skipped for that is serviced in the next pass
+    bool worked = false;
+    for( size_t i=0; i<streams.size(); ++i ){
+        worked = service( *streams[i], lock ) || worked;
+    }
+    return worked;
+}
+
+bool pdsp::SampleStreamer::service( SampleStream & stream, std::unique_lock<std::mutex> & lock ){
+
+    uint32_t generation = stream.sequence.load( std::memory_order_acquire );
+    if( generation == 0 || (generation & 1) ){ return false; }
+
+    WavReader* reader = stream.source.load( std::memory_order_relaxed );
+    int channel = stream.channel.load( std::memory_order_relaxed );
+    long begin = stream.begin.load( std::memory_order_relaxed );
+    bool forward = stream.forward.load( std::memory_order_relaxed );
+    uint64_t consumed = stream.consumed.load( std::memory_order_relaxed );
+
+    std::atomic_thread_fence( std::memory_order_acquire );
+    if( stream.sequence.load( std::memory_order_relaxed ) != generation ){ return false; }
+
+    if( generation != stream.servedGeneration ){
+        stream.servedGeneration = generation;
+        stream.servedFrames = 0;
+    }
+
+    if( std::find( sources.begin(), sources.end(), reader ) == sources.end() ){ return false; }
+
+    long remaining = forward ? reader->length() - begin - stream.servedFrames : begin - stream.servedFrames;
+    if( remaining <= 0 ){ return false; }
+
+    long consumedFrames = ( uint32_t(consumed >> 32) == generation ) ? long( consumed & PDSP_SAMPLESTREAM_FRAMES_MASK ) : 0;
+    if( stream.servedFrames + PDSP_SAMPLESTREAM_READ_BLOCK > consumedFrames + PDSP_SAMPLESTREAM_RING_SIZE ){ return false; }
+
+    float* ring = stream.ring.load( std::memory_order_relaxed );
+    if( ring == nullptr ){
+        ofx_allocate_aligned( ring, PDSP_SAMPLESTREAM_RING_SIZE );
+        if( ring == nullptr ){ return false; }
+        stream.ring.store( ring, std::memory_order_release );
+    }
+
+    if( channel >= reader->channels() ){ channel = reader->channels() - 1; }
+    outputs.assign( reader->channels(), nullptr );
+    outputs[channel] = scratch.data();
+
+    // only the last read files are kept open, the others are opened again by the reader when needed
+    std::vector<WavReader*>::iterator open = std::find( openSources.begin(), openSources.end(), reader );
+    if( open != openSources.end() ){
+        openSources.erase( open );
+    }else if( openSources.size() >= PDSP_SAMPLESTREAM_OPEN_FILES ){
+        openSources.front()->release();
+        openSources.erase( openSources.begin() );
+    }
+    openSources.push_back( reader );
+
+    // in reverse the block before the frames already served is read
+    long frames = ( remaining < PDSP_SAMPLESTREAM_READ_BLOCK ) ? remaining : PDSP_SAMPLESTREAM_READ_BLOCK;
+    long position = forward ? begin + stream.servedFrames : begin - stream.servedFrames - frames;
+
+    // the lock is released for the disk access, so adding and removing streams and sources doesn't wait for it
+    pinnedStream = &stream;
+    pinnedReader = reader;
+    lock.unlock();
+    long read = reader->read( position, frames, outputs.data() );
+    lock.lock();
+    pinnedStream = nullptr;
+    pinnedReader = nullptr;
+    unpinned.notify_all();
+
+    if( read < frames ){
+        // read error, stops streaming this request
+        stream.servedFrames += remaining;
+        return false;
+    }
+
+    // sequence lock again, if the audio thread made a new request during the read the block is discarded
+    // the filled frames are tagged with the generation, so a request changed after this check ignores them
+    if( stream.sequence.load( std::memory_order_acquire ) != generation ){ return true; }
+
+    for( long n=0; n<read; ++n ){
+        ring[ (position + n) & PDSP_SAMPLESTREAM_RING_MASK ] = scratch[n];
+    }
+    stream.servedFrames += read;
+
+    stream.filled.store( (uint64_t(generation) << 32) | uint64_t(stream.servedFrames), std::memory_order_release );
+    return true;
+}
+
+void pdsp::SampleStreamer::threadFunction(){
+
+    while( true ){
+        bool worked;
+        {
+            std::lock_guard<std::mutex> serving( serviceMutex );
+            worked = servicePass();
+        }
+        if( ! worked ){
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait_for( lock, std::chrono::microseconds( PDSP_SAMPLESTREAM_WAIT_US ) );
+        }
+    }
+}
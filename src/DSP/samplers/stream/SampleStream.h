@@ -0,0 +1,130 @@
+
+// SampleStream.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_STREAM_SAMPLESTREAM_H_INCLUDED
+#define PDSP_STREAM_SAMPLESTREAM_H_INCLUDED
+
+#include "../../pdspCore.h"
+#include "../SampleBuffer.h"
+#include "WavReader.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstdint>
+
+namespace pdsp {
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+    // ring buffer of a single channel of a streaming SampleBuffer, used by one Sampler
+    // the audio thread requests a position and reads the ring, the SampleStreamer thread fills it from disk
+    class SampleStream{
+        friend class SampleStreamer;
+
+    public:
+        SampleStream();
+        SampleStream(const SampleStream & other);
+        SampleStream& operator=(const SampleStream & other);
+        ~SampleStream();
+
+        // audio thread, starts streaming the frames after the preloaded head from the given position
+        // when playing in reverse the frames before the position are streamed, from the position going backward
+        void start( const SampleBuffer* sample, int channel, long position, bool forward ) noexcept;
+
+        // audio thread, once for buffer: gets the frames arrived from disk and frees the ones already played
+        void update( const SampleBuffer* sample, int channel, long position, bool forward ) noexcept;
+
+        // audio thread, returns 0.0f if the frame is not streamed yet
+        inline float get( long position ) const noexcept {
+            long rel = currentForward ? position - currentStart : currentStart - 1 - position;
+            if( rel >= consumedFrames && rel < availableFrames ){
+                return currentRing[ position & (PDSP_SAMPLESTREAM_RING_SIZE-1) ];
+            }
+            return 0.0f;
+        }
+
+    private:
+        // request, written by the audio thread and read by the streamer with a sequence lock
+        // the sequence is odd while the request is written, the even values are used as request generation
+        std::atomic<uint32_t>       sequence;
+        std::atomic<WavReader*>     source;
+        std::atomic<int>            channel;
+        std::atomic<long>           begin;
+        std::atomic<bool>           forward;
+
+        // frames from begin consumed by the audio thread and filled by the streamer, the generation is in the upper 32 bits
+        // going forward they are the frames after begin, in reverse the frames before it, each frame is at its position in the ring
+        std::atomic<uint64_t>       consumed;
+        std::atomic<uint64_t>       filled;
+
+        std::atomic<float*>         ring; // allocated by the streamer thread
+
+        // audio thread
+        uint32_t            generation;
+        const WavReader*    currentSource;
+        int                 currentChannel;
+        bool                currentForward;
+        long                currentStart;
+        long                consumedFrames;
+        long                availableFrames;
+        const float*        currentRing;
+
+        // streamer thread
+        uint32_t            servedGeneration;
+        long                servedFrames;
+    };
+
+
+    // background thread that reads from disk the frames requested by all the SampleStreams
+    class SampleStreamer{
+    public:
+        static void addStream( SampleStream* stream );
+        static void removeStream( SampleStream* stream );
+
+        // after removeSource() returns the streamer thread doesn't use the reader anymore
+        static void addSource( WavReader* reader );
+        static void removeSource( WavReader* reader );
+
+        // wakes up the streamer, it doesn't lock so it can be called from the audio thread
+        static void notify();
+
+        // fills all the requested frames on the calling thread, used between the buffers of an offline rendering
+        static void flush();
+
+    private:
+        SampleStreamer();
+        static SampleStreamer & get();
+
+        // the lock is released while the file is read
+        bool service( SampleStream & stream, std::unique_lock<std::mutex> & lock );
+        bool servicePass();
+        void threadFunction();
+
+        std::vector<SampleStream*>  streams;
+        std::vector<WavReader*>     sources;
+        std::vector<WavReader*>     openSources; // the last read at the back
+        std::vector<float>          scratch;
+        std::vector<float*>         outputs;
+
+        // stream and reader read outside the lock, they can't be removed until the read is done
+        SampleStream*               pinnedStream;
+        WavReader*                  pinnedReader;
+
+        std::thread                 worker;
+        std::mutex                  mutex;          // streams, sources and the pinned ones
+        std::mutex                  serviceMutex;   // only one thread services the streams at time
+        std::condition_variable     condition;
+        std::condition_variable     unpinned;
+    };
+
+/*!
+    @endcond
+*/
+}
+
+#endif // PDSP_STREAM_SAMPLESTREAM_H_INCLUDED
@@ -0,0 +1,175 @@
+
+#include "WavReader.h"
+#include <cstring>
+#include <cstdint>
+
+#define PDSP_WAV_FORMAT_PCM 1
+#define PDSP_WAV_FORMAT_FLOAT 3
+#define PDSP_WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// wav files are little endian
+uint32_t pdsp::WavReader::readU32( const unsigned char* b ){
+    return uint32_t(b[0]) | (uint32_t(b[1])<<8) | (uint32_t(b[2])<<16) | (uint32_t(b[3])<<24);
+}
+
+uint16_t pdsp::WavReader::readU16( const unsigned char* b ){
+    return uint16_t( b[0] | (b[1]<<8) );
+}
+
+float pdsp::WavReader::decode( const unsigned char* b, int format, int bytesPerSample ){
+    if( format == PDSP_WAV_FORMAT_FLOAT ){
+        if( bytesPerSample == 4 ){
+            uint32_t bits = readU32( b );
+            float value;
+            std::memcpy( &value, &bits, 4 );
+            return value;
+        }else{
+            uint64_t bits = uint64_t(readU32( b )) | ( uint64_t(readU32( b+4 )) << 32 );
+            double value;
+            std::memcpy( &value, &bits, 8 );
+            return static_cast<float>( value );
+        }
+    }
+
+    switch( bytesPerSample ){
+        case 1: return ( float(b[0]) - 128.0f ) * ( 1.0f / 128.0f );
+        case 2: return float( int16_t( readU16( b ) ) ) * ( 1.0f / 32768.0f );
+        case 3: return float( int32_t( (uint32_t(b[0])<<8) | (uint32_t(b[1])<<16) | (uint32_t(b[2])<<24) ) ) * ( 1.0f / 2147483648.0f );
+        case 4: return float( int32_t( readU32( b ) ) ) * ( 1.0f / 2147483648.0f );
+        default: return 0.0f;
+    }
+}
+
+pdsp::WavReader::WavReader(){
+    format = 0;
+    numChannels = 0;
+    bytesPerSample = 0;
+    frameBytes = 0;
+    numFrames = 0;
+    sampleRate = 0.0;
+    dataStart = 0;
+}
+
+bool pdsp::WavReader::open( const std::string & path ){
+    close();
+
+    file.open( path, std::ios::binary );
+    if( ! file.is_open() ){ return false; }
+    this->path = path;
+
+    unsigned char header[12];
+    if( ! file.read( (char*) header, 12 ) || std::memcmp( header, "RIFF", 4 )!=0 || std::memcmp( header+8, "WAVE", 4 )!=0 ){
+        close();
+        return false;
+    }
+
+    bool formatFound = false;
+    unsigned char chunk[8];
+
+    while( file.read( (char*) chunk, 8 ) ){
+        uint32_t chunkSize = readU32( chunk+4 );
+        std::streamoff chunkStart = file.tellg();
+
+        if( std::memcmp( chunk, "fmt ", 4 )==0 && chunkSize >= 16 ){
+            unsigned char fmt[40];
+            std::memset( fmt, 0, 40 );
+            file.read( (char*) fmt, chunkSize < 40 ? chunkSize : 40 );
+
+            format = readU16( fmt );
+            numChannels = readU16( fmt+2 );
+            sampleRate = double( readU32( fmt+4 ) );
+            bytesPerSample = readU16( fmt+14 ) / 8;
+            if( format == PDSP_WAV_FORMAT_EXTENSIBLE && chunkSize >= 26 ){
+                format = readU16( fmt+24 ); // first two bytes of the subformat GUID
+            }
+            formatFound = true;
+
+        }else if( std::memcmp( chunk, "data", 4 )==0 && formatFound ){
+            bool supported = numChannels > 0 &&
+                ( ( format == PDSP_WAV_FORMAT_PCM && bytesPerSample>=1 && bytesPerSample<=4 ) ||
+                  ( format == PDSP_WAV_FORMAT_FLOAT && (bytesPerSample==4 || bytesPerSample==8) ) );
+            if( ! supported ){ break; }
+
+            frameBytes = numChannels * bytesPerSample;
+            dataStart = chunkStart;
+
+            // the size is wrong in files written by some streaming recorders, so it is clipped to the real one
+            file.seekg( 0, std::ios::end );
+            std::streamoff available = std::streamoff( file.tellg() ) - dataStart;
+            std::streamoff dataBytes = ( std::streamoff(chunkSize) < available ) ? std::streamoff(chunkSize) : available;
+            numFrames = long( dataBytes / frameBytes );
+            return true;
+        }
+
+        // chunks are padded to an even size
+        file.clear();
+        file.seekg( chunkStart + std::streamoff( chunkSize + (chunkSize & 1) ) );
+    }
+
+    close();
+    return false;
+}
+
+void pdsp::WavReader::close(){
+    if( file.is_open() ){
+        file.close();
+    }
+    file.clear();
+    format = 0;
+    numChannels = 0;
+    numFrames = 0;
+}
+
+bool pdsp::WavReader::isOpen() const {
+    return numFrames > 0;
+}
+
+void pdsp::WavReader::release(){
+    if( file.is_open() ){
+        file.close();
+    }
+    file.clear();
+}
+
+int pdsp::WavReader::channels() const {
+    return numChannels;
+}
+
+long pdsp::WavReader::length() const {
+    return numFrames;
+}
+
+double pdsp::WavReader::samplerate() const {
+    return sampleRate;
+}
+
+long pdsp::WavReader::read( long position, long frames, float* const* outputs ){
+
+    if( position < 0 || position >= numFrames || frames <= 0 ){ return 0; }
+    if( position + frames > numFrames ){ frames = numFrames - position; }
+
+    if( ! file.is_open() ){
+        file.open( path, std::ios::binary );
+        if( ! file.is_open() ){ return 0; }
+    }
+
+    bytes.resize( frames * frameBytes );
+
+    file.clear();
+    file.seekg( dataStart + std::streamoff(position) * frameBytes );
+    file.read( bytes.data(), frames * frameBytes );
+    long readFrames = long( file.gcount() / frameBytes );
+
+    for( int c=0; c<numChannels; ++c ){
+        float* output = outputs[c];
+        if( output != nullptr ){
+            const unsigned char* b = (const unsigned char*) bytes.data() + c * bytesPerSample;
+            for( long n=0; n<readFrames; ++n ){
+                output[n] = decode( b, format, bytesPerSample );
+                b += frameBytes;
+            }
+        }
+    }
+
+    return readFrames;
+}
@@ -0,0 +1,61 @@
+
+// WavReader.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_STREAM_WAVREADER_H_INCLUDED
+#define PDSP_STREAM_WAVREADER_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+namespace pdsp {
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    // reads frames from any position of a .wav file without decoding the whole file
+    // supports 8/16/24/32 bit integer PCM and 32/64 bit float data, also with the extensible format header
+    class WavReader{
+    public:
+        WavReader();
+
+        bool open( const std::string & path );
+        void close();
+        bool isOpen() const;
+
+        // closes the file but keeps its format, read() opens it again when needed
+        void release();
+
+        int     channels() const;
+        long    length() const;
+        double  samplerate() const;
+
+        // reads frames from position to outputs[channel], outputs[channel] can be nullptr to skip a channel
+        // returns the number of frames read, it is less than frames at the end of the file
+        long read( long position, long frames, float* const* outputs );
+
+    private:
+        static uint32_t readU32( const unsigned char* b );
+        static uint16_t readU16( const unsigned char* b );
+        static float decode( const unsigned char* b, int format, int bytesPerSample );
+
+        std::ifstream       file;
+        std::string         path;
+        std::vector<char>   bytes;
+
+        int         format;
+        int         numChannels;
+        int         bytesPerSample;
+        int         frameBytes;
+        long        numFrames;
+        double      sampleRate;
+        std::streamoff dataStart;
+    };
+/*!
+    @endcond
+*/
+}
+
+#endif // PDSP_STREAM_WAVREADER_H_INCLUDED
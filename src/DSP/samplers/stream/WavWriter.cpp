@@ -0,0 +1,140 @@
+
+#include "WavWriter.h"
+#include <cstring>
+#include <cmath>
+
+#define PDSP_WAV_FORMAT_PCM 1
+#define PDSP_WAV_FORMAT_FLOAT 3
+#define PDSP_WAV_HEADER_SIZE 44
+
+// wav files are little endian
+void pdsp::WavWriter::writeU32( unsigned char* b, uint32_t value ){
+    b[0] = value & 0xFF;
+    b[1] = (value>>8) & 0xFF;
+    b[2] = (value>>16) & 0xFF;
+    b[3] = (value>>24) & 0xFF;
+}
+
+void pdsp::WavWriter::writeU16( unsigned char* b, uint16_t value ){
+    b[0] = value & 0xFF;
+    b[1] = (value>>8) & 0xFF;
+}
+
+void pdsp::WavWriter::encode( unsigned char* b, float value, int bytesPerSample ){
+    if( bytesPerSample == 4 ){
+        uint32_t bits;
+        std::memcpy( &bits, &value, 4 );
+        writeU32( b, bits );
+        return;
+    }
+
+    // no dither, so the same input always gives the same file
+    value = ( value > 1.0f ) ? 1.0f : ( ( value < -1.0f ) ? -1.0f : value );
+    if( bytesPerSample == 2 ){
+        long sample = std::lround( value * 32767.0f );
+        writeU16( b, uint16_t( int16_t( sample ) ) );
+    }else{
+        long sample = std::lround( double(value) * 8388607.0 );
+        uint32_t bits = uint32_t( int32_t( sample ) );
+        b[0] = bits & 0xFF;
+        b[1] = (bits>>8) & 0xFF;
+        b[2] = (bits>>16) & 0xFF;
+    }
+}
+
+pdsp::WavWriter::WavWriter(){
+    numChannels = 0;
+    bytesPerSample = 0;
+    frameBytes = 0;
+    numFrames = 0;
+}
+
+pdsp::WavWriter::~WavWriter(){
+    close();
+}
+
+bool pdsp::WavWriter::open( const std::string & path, int channels, double sampleRate, int bitDepth ){
+    close();
+
+    if( channels <= 0 || ( bitDepth != 16 && bitDepth != 24 && bitDepth != 32 ) ){ return false; }
+
+    file.open( path, std::ios::binary | std::ios::trunc );
+    if( ! file.is_open() ){ return false; }
+
+    numChannels = channels;
+    bytesPerSample = bitDepth / 8;
+    frameBytes = numChannels * bytesPerSample;
+    numFrames = 0;
+
+    // the sizes are left to 0 until close()
+    unsigned char header[PDSP_WAV_HEADER_SIZE];
+    std::memset( header, 0, PDSP_WAV_HEADER_SIZE );
+    std::memcpy( header, "RIFF", 4 );
+    std::memcpy( header+8, "WAVE", 4 );
+    std::memcpy( header+12, "fmt ", 4 );
+    writeU32( header+16, 16 );
+    writeU16( header+20, ( bitDepth == 32 ) ? PDSP_WAV_FORMAT_FLOAT : PDSP_WAV_FORMAT_PCM );
+    writeU16( header+22, uint16_t( numChannels ) );
+    writeU32( header+24, uint32_t( sampleRate ) );
+    writeU32( header+28, uint32_t( sampleRate ) * frameBytes );
+    writeU16( header+32, uint16_t( frameBytes ) );
+    writeU16( header+34, uint16_t( bitDepth ) );
+    std::memcpy( header+36, "data", 4 );
+
+    if( ! file.write( (const char*) header, PDSP_WAV_HEADER_SIZE ) ){
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool pdsp::WavWriter::write( const float* const* inputs, long frames ){
+    if( ! file.is_open() ){ return false; }
+    if( frames <= 0 ){ return true; }
+
+    bytes.resize( frames * frameBytes );
+
+    for( int c=0; c<numChannels; ++c ){
+        const float* input = inputs[c];
+        unsigned char* b = (unsigned char*) bytes.data() + c * bytesPerSample;
+        for( long n=0; n<frames; ++n ){
+            encode( b, input[n], bytesPerSample );
+            b += frameBytes;
+        }
+    }
+
+    if( ! file.write( bytes.data(), frames * frameBytes ) ){ return false; }
+    numFrames += frames;
+    return true;
+}
+
+void pdsp::WavWriter::close(){
+    if( file.is_open() ){
+        uint32_t dataBytes = uint32_t( numFrames * frameBytes );
+        unsigned char size[4];
+
+        // the data chunk is padded to an even size
+        if( dataBytes & 1 ){
+            file.put( 0 );
+        }
+
+        writeU32( size, 36 + dataBytes + (dataBytes & 1) );
+        file.seekp( 4 );
+        file.write( (const char*) size, 4 );
+        writeU32( size, dataBytes );
+        file.seekp( 40 );
+        file.write( (const char*) size, 4 );
+        file.close();
+    }
+    file.clear();
+    numChannels = 0;
+    numFrames = 0;
+}
+
+bool pdsp::WavWriter::isOpen() const {
+    return file.is_open();
+}
+
+long pdsp::WavWriter::length() const {
+    return numFrames;
+}
@@ -0,0 +1,53 @@
+
+// WavWriter.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_STREAM_WAVWRITER_H_INCLUDED
+#define PDSP_STREAM_WAVWRITER_H_INCLUDED
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+namespace pdsp {
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+    // writes frames to a .wav file as they arrive, only one block of frames is kept in memory
+    // supports 16/24 bit integer PCM and 32 bit float data, the sizes in the header are written by close()
+    class WavWriter{
+    public:
+        WavWriter();
+        ~WavWriter();
+
+        bool open( const std::string & path, int channels, double sampleRate, int bitDepth );
+        void close();
+        bool isOpen() const;
+
+        // writes frames from inputs[channel], the values are clipped to [-1, 1] for the integer formats
+        // returns false on write errors
+        bool write( const float* const* inputs, long frames );
+
+        long length() const;
+
+    private:
+        static void writeU32( unsigned char* b, uint32_t value );
+        static void writeU16( unsigned char* b, uint16_t value );
+        static void encode( unsigned char* b, float value, int bytesPerSample );
+
+        std::ofstream       file;
+        std::vector<char>   bytes;
+
+        int         numChannels;
+        int         bytesPerSample;
+        int         frameBytes;
+        long        numFrames;
+    };
+/*!
+    @endcond
+*/
+}
+
+#endif // PDSP_STREAM_WAVWRITER_H_INCLUDED
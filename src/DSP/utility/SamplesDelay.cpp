@@ -12,6 +12,7 @@ pdsp::SamplesDelay::SamplesDelay( int samples ){
         updateOutputNodes();
         
         maxDelayTimeSamples = samples;
+        delayBuffer = nullptr;
         
         if(dynamicConstruction){
                 prepareToPlay(globalBufferSize, globalSampleRate);
@@ -12,16 +12,58 @@
 //if you can use FFTW for your project, link it and decomment this for faster FFT
 //#define AUDIOFFT_FFTW3
 
+//decomment this in a debug build to report allocations, locks and blocking calls made while processing audio
+//link the addon statically, on linux also link libdl
+//#define PDSP_REALTIME_CHECKS
+
+//decomment this to measure the processing time of each Unit, see pdsp::Profiler
+//#define PDSP_PROFILING
+
 
 // some internally used values
 #define PDSP_NODE_POINTERS_RESERVE 16
-#define PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT 32
+// messages a Sequence code can generate into the audio thread, the exceeding messages are dropped and counted
+#define PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT 512
 #define PDSP_SCORESECTIONMESSAGERESERVE 32
 
+// messages each MessageBuffer can hold in a single audio buffer, the exceeding messages are dropped and counted
+#define PDSP_MESSAGEBUFFER_CAPACITY 256
+
 #define PDSP_BUFFERS_EXTRA_DIM  5
 
 #define PDSP_MIN_ENVSTAGE_MS 0.000001f
 
 #define PDSP_MAX_OUTPUT_CHANNELS 32
 
+// idle audio worker threads yield this number of times before going to sleep
+#define PDSP_WORKERS_SPIN_CYCLES 4096
+#define PDSP_WORKERS_SLEEP_US 100
+
+// microseconds the control thread sleeps while waiting the audio thread to apply a repatching
+#define PDSP_REPATCH_WAIT_US 100
+
+// non-uniform partitioned convolution: each tail stage has partitions this number of times bigger than the previous
+#define PDSP_CONVOLVER_TAIL_GROWTH 4
+#define PDSP_CONVOLVER_MAX_PARTITION 16384
+// the audio thread yields and then sleeps if a tail partition is not ready yet, the tail thread polls with the same interval
+#define PDSP_CONVOLVER_TAIL_SPIN_CYCLES 1024
+#define PDSP_CONVOLVER_TAIL_WAIT_US 100
+
+// streaming SampleBuffers: frames kept in memory for each file, frames buffered for each Sampler (power of 2)
+// and frames read at once by the disk thread, the disk thread polls the Samplers with the given interval
+// and keeps open only the given number of streamed files, the others are opened again when they are read
+#define PDSP_SAMPLEBUFFER_STREAM_HEAD 16384
+#define PDSP_SAMPLESTREAM_RING_SIZE 65536
+#define PDSP_SAMPLESTREAM_READ_BLOCK 8192
+#define PDSP_SAMPLESTREAM_WAIT_US 1000
+#define PDSP_SAMPLESTREAM_OPEN_FILES 16
+
+// memory kept by the SampleCache for the files that are not used anymore, the least recently used are freed first
+#define PDSP_SAMPLECACHE_MEMORY 268435456
+
+// the thread generating the Sequences ahead of time polls the requests with this interval
+#define PDSP_SEQUENCEGENERATOR_WAIT_US 1000
+// buffers of processing time kept for each Unit by the Profiler
+#define PDSP_PROFILER_HISTORY 512
+
 #endif // PDSP_FLAGS_H_INCLUDED
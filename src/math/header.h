@@ -22,6 +22,7 @@
 #include "interpolation/smooth.h"
 #include "interpolation/hermite.h"
 #include "interpolation/cubic.h"
+#include "interpolation/polyphase.h"
 
 #include "dsphelpers/nonlinear1.h"
 #include "dsphelpers/phazorShifter.h"
@@ -34,6 +35,7 @@
 
 #include "tables/dsp_windows.h"
 #include "tables/blep.h"
+#include "tables/sinc.h"
 
 #include "random/random.h"
 
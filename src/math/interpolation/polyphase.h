@@ -0,0 +1,53 @@
+
+// polyphase.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_MATH_POLYPHASE_H_INCLUDED
+#define PDSP_MATH_POLYPHASE_H_INCLUDED
+
+#include "../functions.h"
+
+namespace pdsp{
+
+    // x points to the taps samples around the interpolated point, the interpolated point is between x[taps/2-1] and x[taps/2]
+    // kernel is a table of phases+1 rows of taps coefficients as made by sincTable(), taps has to be a multiple of 4
+    inline_f float interpolate_polyphase(const float* x, const float* kernel, const int taps, const int phases, const float mu){
+
+        float position = mu * phases;
+        int row = static_cast<int>(position);
+        float frac = position - row;
+        if(row >= phases){ // mu rounded up to 1.0f
+            row = phases - 1;
+            frac = 1.0f;
+        }
+
+        const float* k0 = kernel + row*taps;
+        const float* k1 = k0 + taps;
+
+#ifdef OFX_SIMD_USE_SIMD
+        ofx::f128 sum = ofx::m_set_zero();
+
+        for(int i=0; i<taps; i+=4){
+            ofx::f128 c0 = ofx::m_load(k0 + i);
+            ofx::f128 c = ofx::m_add( c0, ofx::m_mul1( ofx::m_sub( ofx::m_load(k1 + i), c0 ), frac ) );
+            sum = ofx::m_add( sum, ofx::m_mul( c, ofx::m_loadu(x + i) ) );
+        }
+
+        alignas(16) float lanes[4];
+        ofx::m_store( lanes, sum );
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+        float sum = 0.0f;
+
+        for(int i=0; i<taps; ++i){
+            sum += ( k0[i] + (k1[i]-k0[i]) * frac ) * x[i];
+        }
+        return sum;
+#endif
+
+    }
+
+}
+
+#endif  // PDSP_MATH_POLYPHASE_H_INCLUDED
@@ -29,6 +29,32 @@
     #define OFX_SIMD_ALIGNMENT_NUM 16
 #endif
 
+// 256 and 512 bit x86 vectors, they are used when the compiler targets them
+// ( -mavx2 -mfma or -mavx512f with gcc and clang, /arch:AVX2 or /arch:AVX512 with visual studio )
+// define OFX_SIMD_DISABLE_WIDE to keep using 128 bit vectors anyway
+#if defined(OFX_SIMD_USE_SSE2) && !defined(OFX_SIMD_DISABLE_WIDE)
+    #if defined(__AVX512F__)
+        #define OFX_SIMD_USE_AVX512
+        #define OFX_SIMD_USE_FMA
+        #define OFX_SIMD_WIDTH 16
+        #undef OFX_SIMD_ALIGNMENT_NUM
+        #define OFX_SIMD_ALIGNMENT_NUM 64
+    #elif defined(__AVX2__)
+        #define OFX_SIMD_USE_AVX2
+        #if defined(__FMA__) || defined(_MSC_VER)
+            #define OFX_SIMD_USE_FMA
+        #endif
+        #define OFX_SIMD_WIDTH 8
+        #undef OFX_SIMD_ALIGNMENT_NUM
+        #define OFX_SIMD_ALIGNMENT_NUM 32
+    #endif
+#endif
+
+// number of floats in the widest vector used by the kernels
+#ifndef OFX_SIMD_WIDTH
+    #define OFX_SIMD_WIDTH 4
+#endif
+
 
 
 
@@ -3,6 +3,8 @@
 #ifndef OFX_SIMDFLOATS_INLINES_H_INCLUDED
 #define OFX_SIMDFLOATS_INLINES_H_INCLUDED
 
+#include "flags.h"
+
 
 //DEFINITION OF FORCED INLINE---------------------------------------------------------------
 #ifndef inline_f
@@ -18,6 +20,11 @@
     // rounds down x to a multiple of s (i.e. ROUND_DOWN(5, 4) becomes 4)
 #endif
 
+#ifndef OFX_SIMD_BLOCK
+    #define OFX_SIMD_BLOCK(floats) ((floats) > OFX_SIMD_WIDTH ? (floats) : OFX_SIMD_WIDTH)
+    // kernel block size of the given number of floats, but never smaller than a vector
+#endif
+
 //to put before and after declared array (non pointers) to make them aligned
 //e.g.  ALIGNPRE float myArray[8] ALIGNPOST;
 #if defined ALIGNPRE || defined ALIGNPOST
@@ -7,6 +7,7 @@
 #include "functions/mathfun.h"
 #include "functions/ternaryOp.h"
 #include "functions/floor.h"
+#include "functions/simd_vector.h"
 
 //inclute math.h and defines math constants
 #define _USE_MATH_DEFINES
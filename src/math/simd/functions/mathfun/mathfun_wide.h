@@ -0,0 +1,219 @@
+
+/* 256 and 512 bit version of the sin, cos, exp and log of mathfun_SSE2.h
+
+     Same algorithms of the SSE2 version, based on the cephes math library,
+     written with the fvec functions of simd_vector.h so the same code is used
+     for AVX2 and AVX-512, the polynomials are evaluated with FMA when available.
+
+     Original SSE version Copyright (C) 2007  Julien Pommier, zlib license,
+     see mathfun_SSE2.h for the full license text.
+*/
+
+#ifndef OFX_SIMDFLOATS_MATHFUN_WIDE_H_INCLUDED
+#define OFX_SIMDFLOATS_MATHFUN_WIDE_H_INCLUDED
+
+#include "../../core/inlines.h"
+#include "../simd_vector.h"
+
+namespace ofx {
+
+    inline_f fvec v_log(fvec x) {
+        fvec one = v_set1(1.0f);
+        fvec invalid_mask = v_cmp_le(x, v_set_zero());
+
+        x = v_max(x, vi_as_float(vi_set1(0x00800000)));  /* cut off denormalized stuff */
+
+        ivec imm0 = vi_shift_right(v_as_int(x), 23);
+
+        /* keep only the fractional part */
+        x = v_and(x, vi_as_float(vi_set1(~0x7f800000)));
+        x = v_or(x, v_set1(0.5f));
+
+        imm0 = vi_sub(imm0, vi_set1(0x7f));
+        fvec e = v_conv_if(imm0);
+        e = v_add(e, one);
+
+        /* part2:
+         if( x < SQRTHF ) {
+         e -= 1;
+         x = x + x - 1.0;
+         } else { x = x - 1.0; }
+         */
+        fvec mask = v_cmp_lt(x, v_set1(0.707106781186547524f));
+        fvec tmp = v_and(x, mask);
+        x = v_sub(x, one);
+        e = v_sub(e, v_and(one, mask));
+        x = v_add(x, tmp);
+
+        fvec z = v_mul(x, x);
+
+        fvec y = v_set1(7.0376836292E-2f);
+        y = v_madd(y, x, v_set1(-1.1514610310E-1f));
+        y = v_madd(y, x, v_set1(1.1676998740E-1f));
+        y = v_madd(y, x, v_set1(-1.2420140846E-1f));
+        y = v_madd(y, x, v_set1(1.4249322787E-1f));
+        y = v_madd(y, x, v_set1(-1.6668057665E-1f));
+        y = v_madd(y, x, v_set1(2.0000714765E-1f));
+        y = v_madd(y, x, v_set1(-2.4999993993E-1f));
+        y = v_madd(y, x, v_set1(3.3333331174E-1f));
+        y = v_mul(y, x);
+        y = v_mul(y, z);
+
+        y = v_madd(e, v_set1(-2.12194440e-4f), y);
+        y = v_sub(y, v_mul(z, v_set1(0.5f)));
+
+        x = v_add(x, y);
+        x = v_madd(e, v_set1(0.693359375f), x);
+        x = v_or(x, invalid_mask); // negative arg will be NAN
+        return x;
+    }
+
+    inline_f fvec v_exp(fvec x) {
+        fvec one = v_set1(1.0f);
+
+        x = v_min(x, v_set1(88.3762626647949f));
+        x = v_max(x, v_set1(-88.3762626647949f));
+
+        /* express exp(x) as exp(g + n*log(2)) */
+        fvec fx = v_madd(x, v_set1(1.44269504088896341f), v_set1(0.5f));
+
+        /* how to perform a floorf with SSE: just below */
+        ivec emm0 = v_convt_fi(fx);
+        fvec tmp = v_conv_if(emm0);
+
+        /* if greater, substract 1 */
+        fvec mask = v_cmp_gt(tmp, fx);
+        mask = v_and(mask, one);
+        fx = v_sub(tmp, mask);
+
+        x = v_sub(x, v_mul(fx, v_set1(0.693359375f)));
+        x = v_sub(x, v_mul(fx, v_set1(-2.12194440e-4f)));
+
+        fvec z = v_mul(x, x);
+
+        fvec y = v_set1(1.9875691500E-4f);
+        y = v_madd(y, x, v_set1(1.3981999507E-3f));
+        y = v_madd(y, x, v_set1(8.3334519073E-3f));
+        y = v_madd(y, x, v_set1(4.1665795894E-2f));
+        y = v_madd(y, x, v_set1(1.6666665459E-1f));
+        y = v_madd(y, x, v_set1(5.0000001201E-1f));
+        y = v_madd(y, z, x);
+        y = v_add(y, one);
+
+        /* build 2^n */
+        emm0 = v_convt_fi(fx);
+        emm0 = vi_add(emm0, vi_set1(0x7f));
+        emm0 = vi_shift_left(emm0, 23);
+        fvec pow2n = vi_as_float(emm0);
+
+        return v_mul(y, pow2n);
+    }
+
+    inline_f fvec v_pow2(fvec x){
+        return v_exp(v_mul(x, v_set1(0.69314718055994530942f)));
+    }
+
+    /* since sin and cos are almost identical, sincos is used for both */
+    inline_f void v_sincos(fvec x, fvec* s, fvec* c) {
+        fvec sign_mask = v_set1(-0.0f);
+
+        fvec sign_bit_sin = v_and(x, sign_mask);
+        /* take the absolute value */
+        x = v_and_nota(sign_mask, x);
+
+        /* scale by 4/Pi */
+        fvec y = v_mul(x, v_set1(1.27323954473516f));
+
+        /* store the integer part of y in emm2 */
+        ivec emm2 = v_convt_fi(y);
+
+        /* j=(j+1) & (~1) (see the cephes sources) */
+        emm2 = vi_add(emm2, vi_set1(1));
+        emm2 = vi_and(emm2, vi_set1(~1));
+        y = v_conv_if(emm2);
+
+        ivec emm4 = emm2;
+
+        /* get the swap sign flag for the sine */
+        ivec emm0 = vi_and(emm2, vi_set1(4));
+        emm0 = vi_shift_left(emm0, 29);
+        fvec swap_sign_bit_sin = vi_as_float(emm0);
+
+        /* get the polynom selection mask for the sine*/
+        emm2 = vi_and(emm2, vi_set1(2));
+        emm2 = vi_cmp_eq(emm2, vi_set1(0));
+        fvec poly_mask = vi_as_float(emm2);
+
+        /* The magic pass: "Extended precision modular arithmetic"
+         x = ((x - y * DP1) - y * DP2) - y * DP3; */
+        x = v_madd(y, v_set1(-0.78515625f), x);
+        x = v_madd(y, v_set1(-2.4187564849853515625e-4f), x);
+        x = v_madd(y, v_set1(-3.77489497744594108e-8f), x);
+
+        emm4 = vi_sub(emm4, vi_set1(2));
+        emm4 = vi_and_nota(emm4, vi_set1(4));
+        emm4 = vi_shift_left(emm4, 29);
+        fvec sign_bit_cos = vi_as_float(emm4);
+
+        sign_bit_sin = v_xor(sign_bit_sin, swap_sign_bit_sin);
+
+        /* Evaluate the first polynom  (0 <= x <= Pi/4) */
+        fvec z = v_mul(x, x);
+        y = v_set1(2.443315711809948E-005f);
+        y = v_madd(y, z, v_set1(-1.388731625493765E-003f));
+        y = v_madd(y, z, v_set1(4.166664568298827E-002f));
+        y = v_mul(y, z);
+        y = v_mul(y, z);
+        y = v_sub(y, v_mul(z, v_set1(0.5f)));
+        y = v_add(y, v_set1(1.0f));
+
+        /* Evaluate the second polynom  (Pi/4 <= x <= 0) */
+        fvec y2 = v_set1(-1.9515295891E-4f);
+        y2 = v_madd(y2, z, v_set1(8.3321608736E-3f));
+        y2 = v_madd(y2, z, v_set1(-1.6666654611E-1f));
+        y2 = v_mul(y2, z);
+        y2 = v_madd(y2, x, x);
+
+        /* select the correct result from the two polynoms */
+        fvec ysin2 = v_and(poly_mask, y2);
+        fvec ysin1 = v_and_nota(poly_mask, y);
+        y2 = v_sub(y2, ysin2);
+        y = v_sub(y, ysin1);
+
+        fvec xmm1 = v_add(ysin1, ysin2);
+        fvec xmm2 = v_add(y, y2);
+
+        /* update the sign */
+        *s = v_xor(xmm1, sign_bit_sin);
+        *c = v_xor(xmm2, sign_bit_cos);
+    }
+
+    inline_f fvec v_sin(fvec x) {
+        fvec s, c;
+        v_sincos(x, &s, &c);
+        return s;
+    }
+
+    inline_f fvec v_cos(fvec x) {
+        fvec s, c;
+        v_sincos(x, &s, &c);
+        return c;
+    }
+
+    inline_f fvec v_tan(fvec x) {
+        fvec s, c;
+        v_sincos(x, &s, &c);
+        return v_mul(s, v_rcp(c));
+    }
+
+    // same as m_floor
+    inline_f fvec v_floor(fvec a){
+        fvec floor = v_conv_if(v_convt_fi(a));
+        fvec mask = v_cmp_lt(a, v_set_zero());
+        mask = v_and(mask, v_set1(-1.0f));
+        return v_add(floor, mask);
+    }
+
+}
+
+#endif  // OFX_SIMDFLOATS_MATHFUN_WIDE_H_INCLUDED
@@ -0,0 +1,444 @@
+
+#ifndef OFX_SIMDFLOATS_SIMD_VECTOR_H_INCLUDED
+#define OFX_SIMDFLOATS_SIMD_VECTOR_H_INCLUDED
+
+// fvec is the widest vector available, OFX_SIMD_WIDTH floats long
+// the kernels are written with the v_ functions so they use all the vector width
+// without AVX2 or AVX-512 fvec is f128 and the v_ functions are the m_ ones
+
+#include "../core/inlines.h"
+#include "../core/flags.h"
+#include "simd_wrapper.h"
+#include "mathfun.h"
+#include "floor.h"
+
+#if defined( OFX_SIMD_USE_AVX2 ) || defined( OFX_SIMD_USE_AVX512 )
+#include <immintrin.h>
+#endif
+
+namespace ofx{
+
+#if defined( OFX_SIMD_USE_AVX512 )
+    //----------------------AVX-512-----------------------------------------------
+        typedef __m512 fvec;
+        typedef __m512i ivec;
+
+        inline_f fvec v_load (const float* p){
+                // buffers are aligned but kernels can also be called on offsetted pointers
+                return _mm512_loadu_ps(p);
+        }
+
+        inline_f void v_store(float* p, fvec result){
+                _mm512_storeu_ps(p, result);
+        }
+
+        inline_f fvec v_set1 (const float s){
+                return _mm512_set1_ps(s);
+        }
+
+        inline_f fvec v_set_zero (){
+                return _mm512_setzero_ps();
+        }
+
+        inline_f fvec v_add (fvec a, fvec b){
+                return _mm512_add_ps(a, b);
+        }
+
+        inline_f fvec v_sub (fvec a, fvec b){
+                return _mm512_sub_ps(a, b);
+        }
+
+        inline_f fvec v_mul (fvec a, fvec b){
+                return _mm512_mul_ps(a, b);
+        }
+
+        inline_f fvec v_div (fvec a, fvec b){
+                return _mm512_div_ps(a, b);
+        }
+
+        // a * b + c
+        inline_f fvec v_madd (fvec a, fvec b, fvec c){
+                return _mm512_fmadd_ps(a, b, c);
+        }
+
+        inline_f fvec v_rcp (fvec a){
+                return _mm512_rcp14_ps(a);
+        }
+
+        inline_f fvec v_square_root (fvec a){
+                return _mm512_sqrt_ps(a);
+        }
+
+        inline_f fvec v_max (fvec a, fvec b){
+                return _mm512_max_ps(a, b);
+        }
+
+        inline_f fvec v_min (fvec a, fvec b){
+                return _mm512_min_ps(a, b);
+        }
+
+        // AVX-512F has no float logic operations, they are done on integers
+        inline_f fvec v_and (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+        }
+
+        inline_f fvec v_and_nota (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+        }
+
+        inline_f fvec v_or (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+        }
+
+        inline_f fvec v_xor (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+        }
+
+        // comparisons return a mask register, it is expanded to a vector like with SSE
+        inline_f fvec v_cmp_lt (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), -1));
+        }
+
+        inline_f fvec v_cmp_le (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(_mm512_cmp_ps_mask(a, b, _CMP_LE_OQ), -1));
+        }
+
+        inline_f fvec v_cmp_gt (fvec a, fvec b){
+                return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), -1));
+        }
+
+        inline_f ivec v_convt_fi (fvec a){
+                return _mm512_cvttps_epi32(a);
+        }
+
+        inline_f fvec v_conv_if (ivec a){
+                return _mm512_cvtepi32_ps(a);
+        }
+
+        inline_f ivec vi_set1 (const int s){
+                return _mm512_set1_epi32(s);
+        }
+
+        inline_f ivec vi_add (ivec a, ivec b){
+                return _mm512_add_epi32(a, b);
+        }
+
+        inline_f ivec vi_sub (ivec a, ivec b){
+                return _mm512_sub_epi32(a, b);
+        }
+
+        inline_f ivec vi_and (ivec a, ivec b){
+                return _mm512_and_si512(a, b);
+        }
+
+        inline_f ivec vi_and_nota (ivec a, ivec b){
+                return _mm512_andnot_si512(a, b);
+        }
+
+        inline_f ivec vi_cmp_eq (ivec a, ivec b){
+                return _mm512_maskz_set1_epi32(_mm512_cmpeq_epi32_mask(a, b), -1);
+        }
+
+        inline_f ivec vi_shift_left (ivec a, const int bits){
+                return _mm512_sll_epi32(a, _mm_cvtsi32_si128(bits));
+        }
+
+        inline_f ivec vi_shift_right (ivec a, const int bits){
+                return _mm512_srl_epi32(a, _mm_cvtsi32_si128(bits));
+        }
+
+        inline_f fvec vi_as_float (ivec a){
+                return _mm512_castsi512_ps(a);
+        }
+
+        inline_f ivec v_as_int (fvec a){
+                return _mm512_castps_si512(a);
+        }
+
+#elif defined( OFX_SIMD_USE_AVX2 )
+    //----------------------AVX2-----------------------------------------------
+        typedef __m256 fvec;
+        typedef __m256i ivec;
+
+        inline_f fvec v_load (const float* p){
+                // buffers are aligned but kernels can also be called on offsetted pointers
+                return _mm256_loadu_ps(p);
+        }
+
+        inline_f void v_store(float* p, fvec result){
+                _mm256_storeu_ps(p, result);
+        }
+
+        inline_f fvec v_set1 (const float s){
+                return _mm256_set1_ps(s);
+        }
+
+        inline_f fvec v_set_zero (){
+                return _mm256_setzero_ps();
+        }
+
+        inline_f fvec v_add (fvec a, fvec b){
+                return _mm256_add_ps(a, b);
+        }
+
+        inline_f fvec v_sub (fvec a, fvec b){
+                return _mm256_sub_ps(a, b);
+        }
+
+        inline_f fvec v_mul (fvec a, fvec b){
+                return _mm256_mul_ps(a, b);
+        }
+
+        inline_f fvec v_div (fvec a, fvec b){
+                return _mm256_div_ps(a, b);
+        }
+
+        // a * b + c
+        inline_f fvec v_madd (fvec a, fvec b, fvec c){
+#ifdef OFX_SIMD_USE_FMA
+                return _mm256_fmadd_ps(a, b, c);
+#else
+                return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+        }
+
+        inline_f fvec v_rcp (fvec a){
+                return _mm256_rcp_ps(a);
+        }
+
+        inline_f fvec v_square_root (fvec a){
+                return _mm256_sqrt_ps(a);
+        }
+
+        inline_f fvec v_max (fvec a, fvec b){
+                return _mm256_max_ps(a, b);
+        }
+
+        inline_f fvec v_min (fvec a, fvec b){
+                return _mm256_min_ps(a, b);
+        }
+
+        inline_f fvec v_and (fvec a, fvec b){
+                return _mm256_and_ps(a, b);
+        }
+
+        inline_f fvec v_and_nota (fvec a, fvec b){
+                return _mm256_andnot_ps(a, b);
+        }
+
+        inline_f fvec v_or (fvec a, fvec b){
+                return _mm256_or_ps(a, b);
+        }
+
+        inline_f fvec v_xor (fvec a, fvec b){
+                return _mm256_xor_ps(a, b);
+        }
+
+        inline_f fvec v_cmp_lt (fvec a, fvec b){
+                return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+        }
+
+        inline_f fvec v_cmp_le (fvec a, fvec b){
+                return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+        }
+
+        inline_f fvec v_cmp_gt (fvec a, fvec b){
+                return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+        }
+
+        inline_f ivec v_convt_fi (fvec a){
+                return _mm256_cvttps_epi32(a);
+        }
+
+        inline_f fvec v_conv_if (ivec a){
+                return _mm256_cvtepi32_ps(a);
+        }
+
+        inline_f ivec vi_set1 (const int s){
+                return _mm256_set1_epi32(s);
+        }
+
+        inline_f ivec vi_add (ivec a, ivec b){
+                return _mm256_add_epi32(a, b);
+        }
+
+        inline_f ivec vi_sub (ivec a, ivec b){
+                return _mm256_sub_epi32(a, b);
+        }
+
+        inline_f ivec vi_and (ivec a, ivec b){
+                return _mm256_and_si256(a, b);
+        }
+
+        inline_f ivec vi_and_nota (ivec a, ivec b){
+                return _mm256_andnot_si256(a, b);
+        }
+
+        inline_f ivec vi_cmp_eq (ivec a, ivec b){
+                return _mm256_cmpeq_epi32(a, b);
+        }
+
+        inline_f ivec vi_shift_left (ivec a, const int bits){
+                return _mm256_sll_epi32(a, _mm_cvtsi32_si128(bits));
+        }
+
+        inline_f ivec vi_shift_right (ivec a, const int bits){
+                return _mm256_srl_epi32(a, _mm_cvtsi32_si128(bits));
+        }
+
+        inline_f fvec vi_as_float (ivec a){
+                return _mm256_castsi256_ps(a);
+        }
+
+        inline_f ivec v_as_int (fvec a){
+                return _mm256_castps_si256(a);
+        }
+
+#else
+    //----------------------128 BIT-----------------------------------------------
+        typedef f128 fvec;
+        typedef i128 ivec;
+
+        inline_f fvec v_load (const float* p){
+                return m_load(p);
+        }
+
+        inline_f void v_store(float* p, fvec result){
+                m_store(p, result);
+        }
+
+        inline_f fvec v_set1 (const float s){
+                return m_set1(s);
+        }
+
+        inline_f fvec v_set_zero (){
+                return m_set_zero();
+        }
+
+        inline_f fvec v_add (fvec a, fvec b){
+                return m_add(a, b);
+        }
+
+        inline_f fvec v_sub (fvec a, fvec b){
+                return m_sub(a, b);
+        }
+
+        inline_f fvec v_mul (fvec a, fvec b){
+                return m_mul(a, b);
+        }
+
+        inline_f fvec v_div (fvec a, fvec b){
+                return m_div(a, b);
+        }
+
+        inline_f fvec v_rcp (fvec a){
+                return m_rcp(a);
+        }
+
+        inline_f fvec v_square_root (fvec a){
+                return m_square_root(a);
+        }
+
+        inline_f fvec v_max (fvec a, fvec b){
+                return m_max(a, b);
+        }
+
+        inline_f fvec v_min (fvec a, fvec b){
+                return m_min(a, b);
+        }
+
+        inline_f fvec v_log (fvec x){
+                return m_log(x);
+        }
+
+        inline_f fvec v_exp (fvec x){
+                return m_exp(x);
+        }
+
+        inline_f fvec v_sin (fvec x){
+                return m_sin(x);
+        }
+
+        inline_f fvec v_cos (fvec x){
+                return m_cos(x);
+        }
+
+        inline_f fvec v_tan (fvec x){
+                return m_tan(x);
+        }
+
+        inline_f fvec v_floor (fvec a){
+                return m_floor(a);
+        }
+#endif
+
+    //----------------------SHARED-----------------------------------------------
+
+        inline_f void v_store_zero (float* p){
+                v_store(p, v_set_zero());
+        }
+
+        inline_f void v_store_scalar (float* p, const float s){
+                v_store(p, v_set1(s));
+        }
+
+        inline_f fvec v_add1 (fvec a, const float s){
+                return v_add(a, v_set1(s));
+        }
+
+        inline_f fvec v_sub1 (fvec a, const float s){
+                return v_sub(a, v_set1(s));
+        }
+
+        inline_f fvec v_1sub (const float s, fvec b){
+                return v_sub(v_set1(s), b);
+        }
+
+        inline_f fvec v_mul1 (fvec a, const float s){
+                return v_mul(a, v_set1(s));
+        }
+
+        // a + b * s, fused when FMA is available
+        inline_f fvec v_add_bs (fvec a, fvec b, const float s){
+#if defined( OFX_SIMD_USE_AVX2 ) || defined( OFX_SIMD_USE_AVX512 )
+                return v_madd(b, v_set1(s), a);
+#else
+                return m_add_bs(a, b, s);
+#endif
+        }
+
+        inline_f fvec v_abs (fvec a){
+#if defined( OFX_SIMD_USE_AVX2 ) || defined( OFX_SIMD_USE_AVX512 )
+                return v_and_nota(v_set1(-0.0f), a);
+#else
+                return m_abs(a);
+#endif
+        }
+
+        inline_f fvec v_negate (fvec a){
+#if defined( OFX_SIMD_USE_AVX2 ) || defined( OFX_SIMD_USE_AVX512 )
+                return v_xor(v_set1(-0.0f), a);
+#else
+                return m_negate(a);
+#endif
+        }
+
+        inline_f fvec v_max1 (fvec a, const float s){
+                return v_max(a, v_set1(s));
+        }
+
+        inline_f fvec v_min1 (fvec a, const float s){
+                return v_min(a, v_set1(s));
+        }
+
+        inline_f fvec v_clip (fvec a, const float lo, const float hi){
+                return v_max(v_min(a, v_set1(hi)), v_set1(lo));
+        }
+
+}
+
+#if defined( OFX_SIMD_USE_AVX2 ) || defined( OFX_SIMD_USE_AVX512 )
+#include "mathfun/mathfun_wide.h"
+#endif
+
+#endif  // OFX_SIMDFLOATS_SIMD_VECTOR_H_INCLUDED
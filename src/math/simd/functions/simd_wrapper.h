@@ -114,6 +114,12 @@ namespace ofx{
 
         inline_f f128 m_trunc(f128 a);
 
+        // true if any lane of a comparison mask is set
+        inline_f bool m_any(f128 mask);
+
+        // load from an address without alignment requirements
+        inline_f f128 m_loadu (const float* p);
+
     
     //----------------------FUNCTION DEFINITIONS-----------------------------------------------
 #if defined( OFX_SIMD_USE_SSE2 )
@@ -320,6 +326,14 @@ namespace ofx{
         inline_f f128 m_trunc(f128 a){
                 return _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
         }
+
+        inline_f bool m_any(f128 mask){
+                return _mm_movemask_ps(mask) != 0;
+        }
+
+        inline_f f128 m_loadu (const float* p){
+                return _mm_loadu_ps(p);
+        }
     
 #elif defined( OFX_SIMD_USE_NEON )
     
@@ -523,6 +537,16 @@ namespace ofx{
         return vcvtq_f32_s32(vcvtq_s32_f32(a));
     }
     
+    inline_f bool m_any(f128 mask){
+        uint32x4_t bits = vreinterpretq_u32_f32(mask);
+        uint32x2_t half = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+        return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+    }
+    
+    inline_f f128 m_loadu (const float* p){
+        return vld1q_f32(p);
+    }
+    
 #else
     //----------------------NOT ACCELERATED-----------------------------------------------
     
@@ -588,6 +612,8 @@ namespace ofx{
     inline_f i128 m_intpow2(i128 x){}
     
     inline_f f128 m_trunc(f128 a){}
+    inline_f bool m_any(f128 mask){ return false; }
+    inline_f f128 m_loadu (const float* p){}
     
     
     inline_f f128 m_log(f128 x){}
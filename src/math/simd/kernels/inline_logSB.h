@@ -18,25 +18,26 @@ namespace ofx{
         
 #ifdef OFX_SIMD_USE_SIMD
 
-        f128 logBaseMult = m_set1( logBaseMult_f );
+        fvec logBaseMult = v_set1( logBaseMult_f );
 
-        int maxSimd = ROUND_DOWN(len, 8);
+        const int step = OFX_SIMD_WIDTH * 2;
+        int maxSimd = ROUND_DOWN(len, step);
         
-        for (; n<maxSimd; n+=8) {
+        for (; n<maxSimd; n+=step) {
             
             // load elements 
-            f128 x0  = m_load(B+n);
-            f128 x4  = m_load(B+n+4);
+            fvec x0  = v_load(B+n);
+            fvec x1  = v_load(B+n+OFX_SIMD_WIDTH);
          
             // do the computations
-            x0  = m_log(x0);
-            x4  = m_log(x4);
-            x0  = m_mul(x0, logBaseMult);
-            x4  = m_mul(x4, logBaseMult);
+            x0  = v_log(x0);
+            x1  = v_log(x1);
+            x0  = v_mul(x0, logBaseMult);
+            x1  = v_mul(x1, logBaseMult);
             
             // store the results
-            m_store(A+n,    x0);
-            m_store(A+n+4,  x4);
+            v_store(A+n,                 x0);
+            v_store(A+n+OFX_SIMD_WIDTH,  x1);
 
         }
         
@@ -18,23 +18,24 @@ namespace ofx{
 
     
 #ifdef OFX_SIMD_USE_SIMD
-        int maxSimd = ROUND_DOWN(len, 8);
-        f128 powBaseMult = m_set1( powBaseMult_f );
-        for (; n<maxSimd; n+=8) {
+        const int step = OFX_SIMD_WIDTH * 2;
+        int maxSimd = ROUND_DOWN(len, step);
+        fvec powBaseMult = v_set1( powBaseMult_f );
+        for (; n<maxSimd; n+=step) {
             
             // load elements 
-            f128 x0  = m_load(B+n);
-            f128 x4  = m_load(B+n+4);
+            fvec x0  = v_load(B+n);
+            fvec x1  = v_load(B+n+OFX_SIMD_WIDTH);
          
             // do the computations
-            x0  = m_mul(x0, powBaseMult);
-            x4  = m_mul(x4, powBaseMult);
-            x0  = m_exp(x0);
-            x4  = m_exp(x4);
+            x0  = v_mul(x0, powBaseMult);
+            x1  = v_mul(x1, powBaseMult);
+            x0  = v_exp(x0);
+            x1  = v_exp(x1);
             
             // store the results
-            m_store(A+n,    x0);
-            m_store(A+n+4,  x4);
+            v_store(A+n,                 x0);
+            v_store(A+n+OFX_SIMD_WIDTH,  x1);
 
         }
 
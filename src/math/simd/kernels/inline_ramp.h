@@ -16,34 +16,36 @@ namespace ofx{
         
 #ifdef OFX_SIMD_USE_SIMD
         
-        ALIGNPRE float init [8] ALIGNPOST;  //define alignment flag
-        init[0] = start;
-        init[1] = start + inc;
-        init[2] = start + inc*2;
-        init[3] = start + inc*3;
-        init[4] = start + inc*4;
-        init[5] = start + inc*5;
-        init[6] = start + inc*6;
-        init[7] = start + inc*7;
-        
-        f128 now = m_load(init);
-        f128 now2= m_load(init+4);
-        f128 inc128 = m_set1(inc);
-        
-        m_store(dest, now);
-        m_store(dest+4, now2);
-        n=8;
+        const int step = OFX_SIMD_WIDTH * 2;
+        int maxSimd = ROUND_DOWN(len, step);
 
-        int maxSimd = ROUND_DOWN(len, 8);
-        
-        for (; n<maxSimd; n+=8) {
-            now = m_add(now, inc128);
-            now2 = m_add(now2, inc128);
+        if( maxSimd > 0 ){
+            ALIGNPRE float init [OFX_SIMD_WIDTH * 2] ALIGNPOST;  //define alignment flag
+            for( int i=0; i<step; ++i ){
+                init[i] = start + inc*i;
+            }
             
-            m_store( dest + n , now);
-            m_store( dest + n +4, now2);
+            fvec now = v_load(init);
+            fvec now2= v_load(init+OFX_SIMD_WIDTH);
+            fvec incStep = v_set1(inc*step);
+            
+            v_store(dest, now);
+            v_store(dest+OFX_SIMD_WIDTH, now2);
+            n=step;
+
+            for (; n<maxSimd; n+=step) {
+                now = v_add(now, incStep);
+                now2 = v_add(now2, incStep);
+                
+                v_store( dest + n , now);
+                v_store( dest + n + OFX_SIMD_WIDTH, now2);
+            }
         }
 #endif
+        if( n==0 && len>0 ){
+            dest[0] = start;
+            n = 1;
+        }
         for (; n<len; ++n) {
             (*(dest+n)) = (*(dest+n-1) + inc);
         }
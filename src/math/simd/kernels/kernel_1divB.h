@@ -11,7 +11,7 @@ namespace ofx {
     struct kernel_1divB
     {
     public:
-        enum { BLOCK_SIZE = 16 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(16) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_1divB(){};
         
         inline_f  void operator()(float* a, const float* b) const {
@@ -20,24 +20,11 @@ namespace ofx {
     
         
         inline_f  void block(float* a, const float* b) const {
-            
-            // load elements 
-            f128 x0  = m_load(b);
-            f128 x4  = m_load(b+4);
-            f128 x8  = m_load(b+8);
-            f128 x12 = m_load(b+12);           
-            
-            // do the computations
-            x0  = m_rcp(x0);
-            x4  = m_rcp(x4);
-            x8  = m_rcp(x8);
-            x12 = m_rcp(x12);
-            
-            // store the results
-            m_store(a,    x0);
-            m_store(a+4,  x4);
-            m_store(a+8,  x8);
-            m_store(a+12, x12); 
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                fvec x = v_load(b+i);
+                x = v_rcp(x);
+                v_store(a+i, x);
+            }
         }
 
     };
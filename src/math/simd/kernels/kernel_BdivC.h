@@ -10,7 +10,7 @@ namespace ofx {
     struct kernel_BdivC
     {
     public:
-        enum { BLOCK_SIZE = 8 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(8) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_BdivC() {};
         
         inline_f  void operator()(float* a, const float* b, const float* c) const {
@@ -18,21 +18,12 @@ namespace ofx {
         }
         
         inline_f  void block(float* a, const float* b, const float* c) const {
-            
-            // load elements
-            f128 x0  = m_load(b);
-            f128 y0  = m_load(c);
-            f128 x4  = m_load(b+4);
-            f128 y4  = m_load(c+4);
-
-            // do the computations
-            x0  = m_div(x0,  y0);
-            x4  = m_div(x4,  y4); 
-                      
-            // store the results
-            m_store(a,    x0);
-            m_store(a+4,  x4);
-
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                fvec x = v_load(b+i);
+                fvec y = v_load(c+i);
+                x = v_div(x, y);
+                v_store(a+i, x);
+            }
         }
 
     };
@@ -10,7 +10,7 @@ namespace ofx{
     struct kernel_S
     {
     public:
-        enum { BLOCK_SIZE = 16 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(16) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_S(float s) : s(s){};
         
         inline_f  void operator()(float* a, const float* b) const {
@@ -18,12 +18,9 @@ namespace ofx{
         }
         
         inline_f  void block(float* a, const float* b) const {
-            
-            m_store_scalar (a,    s);
-            m_store_scalar (a+4,  s);
-            m_store_scalar (a+8,  s);
-            m_store_scalar (a+12, s);
-            
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                v_store_scalar(a+i, s);
+            }
         }
     protected:
         float s;
@@ -10,7 +10,7 @@ namespace ofx {
     struct kernel_Zero
     {
     public:
-        enum { BLOCK_SIZE = 16 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(16) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_Zero(){};
         
         inline_f  void operator()(float* a, const float* b) const {
@@ -18,12 +18,9 @@ namespace ofx {
         }
         
         inline_f  void block(float* a, const float* b) const {
-            //_mm_storeu_ps(y, _mm_setzero_ps());
-            //store(y, set_zero());
-            m_store_zero(a);
-            m_store_zero(a+4);
-            m_store_zero(a+8);
-            m_store_zero(a+12);
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                v_store_zero(a+i);
+            }
         }
         
         
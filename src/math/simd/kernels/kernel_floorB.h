@@ -10,7 +10,7 @@ namespace ofx {
     struct kernel_floorB
     {
     public:
-        enum { BLOCK_SIZE = 8 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(8) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_floorB(){};
         
         inline_f  void operator()(float* a, const float* b) const {
@@ -19,21 +19,11 @@ namespace ofx {
     
         
         inline_f  void block(float* a, const float* b) const {
-            
-            // load elements 
-            f128 x0  = m_load(b);
-            f128 x4  = m_load(b+4);
-        
-            
-            // do the computations
-            x0  = m_floor(x0);
-            x4  = m_floor(x4);
-
-            
-            // store the results
-            m_store(a,    x0);
-            m_store(a+4,  x4);
-
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                fvec x = v_load(b+i);
+                x = v_floor(x);
+                v_store(a+i, x);
+            }
         }
 
     };
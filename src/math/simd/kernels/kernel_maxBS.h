@@ -9,7 +9,7 @@ namespace ofx {
     struct kernel_maxBS
     {
     public:
-        enum { BLOCK_SIZE = 16 }; // this defines how many elements of the array are processed by a single call to block()
+        enum { BLOCK_SIZE = OFX_SIMD_BLOCK(16) }; // this defines how many elements of the array are processed by a single call to block()
         kernel_maxBS(float s) : s(s){};
         
         inline_f  void operator()(float* a, const float* b) const {
@@ -21,25 +21,11 @@ namespace ofx {
         }
         
         inline_f  void block(float* a, const float* b) const {
-            
-            // load elements 
-            f128 x0  = m_load(b);
-            f128 x4  = m_load(b+4);
-            f128 x8  = m_load(b+8);
-            f128 x12 = m_load(b+12);
-            
-            //do computations
-            x0 = m_max1(x0, s);
-            x4 = m_max1(x4, s);
-            x8 = m_max1(x8, s);
-            x12= m_max1(x12, s);
-            
-            // store the results
-            m_store(a,    x0);
-            m_store(a+4,  x4);
-            m_store(a+8,  x8);
-            m_store(a+12, x12);
-
+            for( int i=0; i<BLOCK_SIZE; i+=OFX_SIMD_WIDTH ){
+                fvec x = v_load(b+i);
+                x = v_max1(x, s);
+                v_store(a+i, x);
+            }
         }
         
     protected:
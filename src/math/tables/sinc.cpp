@@ -0,0 +1,44 @@
+
+#include "sinc.h"
+
+float* pdsp::sincTable( const Window_t windowType, const int taps, const int phases, const double cutoff ){
+
+    int len = taps * phases;
+
+    float* table = nullptr;
+    ofx_allocate_aligned(table, (phases+1) * taps);
+
+    // the window is sampled with the resolution of the phases, one point more to be simmetrical
+    float* win = window(windowType, len+1);
+
+    int center = taps / 2 - 1;
+    double phasesD = static_cast<double>(phases);
+
+    for (int p=0; p<=phases; ++p) {
+        
+        float* row = table + p*taps;
+        double sum = 0.0;
+        
+        for (int i=0; i<taps; ++i) {
+            // distance of the tap from the interpolated point
+            double t = static_cast<double>(i - center) - static_cast<double>(p) / phasesD;
+            double x = M_PI_DOUBLE * cutoff * t;
+            double value = (x!=0.0) ? cutoff * sin(x) / x : cutoff;
+            
+            value *= win[ (i+1)*phases - p ];
+            row[i] = static_cast<float>(value);
+            sum += value;
+        }
+        
+        //NORMALIZE
+        if(sum != 0.0){
+            for (int i=0; i<taps; ++i) {
+                row[i] = static_cast<float>( row[i] / sum );
+            }
+        }
+    }
+
+    ofx_deallocate_aligned(win);
+    
+    return table;
+}
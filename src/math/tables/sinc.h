@@ -0,0 +1,18 @@
+// sinc.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_MATH_SINC_H_INCLUDED
+#define PDSP_MATH_SINC_H_INCLUDED
+
+#include "dsp_windows.h"
+
+namespace pdsp{
+    
+    // polyphase windowed sinc kernel for interpolate_polyphase(), phases+1 rows of taps coefficients
+    // cutoff is relative to the nyquist frequency, each row is normalized to unity gain at DC
+    float* sincTable( const Window_t windowType, const int taps, const int phases, const double cutoff );
+    
+}
+
+#endif  // PDSP_MATH_SINC_H_INCLUDED
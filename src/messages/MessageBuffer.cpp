@@ -2,11 +2,13 @@
 #include "MessageBuffer.h"
 #include <iostream>
 
+std::atomic<int> pdsp::MessageBuffer::overflows( 0 );
+
 pdsp::MessageBuffer::MessageBuffer(){
     messages.clear();
     destination = nullptr;
     connectedToGate = false;
-    reserve(PDSP_SCORESECTIONMESSAGERESERVE);
+    reserve(PDSP_MESSAGEBUFFER_CAPACITY);
 }
 
 pdsp::MessageBuffer::MessageBuffer(const MessageBuffer & other){
@@ -16,7 +18,7 @@ pdsp::MessageBuffer::MessageBuffer(const MessageBuffer & other){
         this->destination->messageBuffer = this;
     }
     this->connectedToGate = other.connectedToGate;
-    this->reserve(PDSP_SCORESECTIONMESSAGERESERVE);
+    this->reserve(PDSP_MESSAGEBUFFER_CAPACITY);
     //std::cout << "message buffer copy constructed\n";
 }
 
@@ -27,7 +29,7 @@ pdsp::MessageBuffer& pdsp::MessageBuffer::operator=(const MessageBuffer & other)
         this->destination->messageBuffer = this;
     }
     this->connectedToGate = other.connectedToGate;
-    this->reserve(PDSP_SCORESECTIONMESSAGERESERVE);
+    this->reserve(PDSP_MESSAGEBUFFER_CAPACITY);
     //std::cout << "message buffer moved\n";
     return *this;
 }
@@ -36,8 +38,12 @@ void pdsp::MessageBuffer::clearMessages(){
     messages.clear();
 }
 
-void pdsp::MessageBuffer::addMessage(float value, int sample){
-    messages.push_back(ControlMessage(value, sample));
+void pdsp::MessageBuffer::addMessage(float value, int sample) noexcept{
+    if( messages.size() < messages.capacity() ){
+        messages.push_back(ControlMessage(value, sample));
+    }else{
+        overflows.fetch_add( 1, std::memory_order_relaxed );
+    }
 }
 
 void pdsp::MessageBuffer::processDestination( const int &bufferSize ){
@@ -58,6 +64,14 @@ bool pdsp::MessageBuffer::empty(){
     return messages.empty();
 }
 
+int pdsp::MessageBuffer::getOverflows(){
+    return overflows.load( std::memory_order_relaxed );
+}
+
+void pdsp::MessageBuffer::resetOverflows(){
+    overflows.store( 0, std::memory_order_relaxed );
+}
+
 //--------------------------------------------------------------------
 
 
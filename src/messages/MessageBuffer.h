@@ -9,6 +9,7 @@
 
 #include "Message.h"
 #include <vector>
+#include <atomic>
 #include "../DSP/control/SequencerBridge.h"
 #include "../flags.h"
 #include "ExtSequencer.h"
@@ -30,16 +31,25 @@ namespace pdsp{
         MessageBuffer& operator=(const MessageBuffer & other);
         
         void clearMessages();
-        void addMessage(float value, int sample);
+        void addMessage(float value, int sample) noexcept;
         void processDestination(const int &bufferSize);
         
         int  size();
+        // sets the fixed capacity, not to be called from the audio thread
         void reserve(int size); 
         bool empty();
 
+        // messages dropped because a buffer was full, from all the MessageBuffers
+        static int getOverflows();
+        static void resetOverflows();
+
         SequencerBridge*                destination;
+        // it never grows past its capacity, so adding messages never allocates
         std::vector<ControlMessage>     messages;
         bool                            connectedToGate;
+
+    private:
+        static std::atomic<int>         overflows;
             
     };
     
@@ -16,6 +16,7 @@ void pdsp::TableOscillator::patch(){
     p2f.set(69.0f); // standard freq is A4 = 440hz
     
     p2f >> phasor.in_freq() >> wto;
+    phasor.out_inc() >> wto.in_inc();
     
 }
 
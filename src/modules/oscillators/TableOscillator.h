@@ -9,7 +9,7 @@
 #include "../../DSP/pdspCore.h"
 
 #include "../../DSP/oscillators/wavetable/WaveTableOsc.h"
-#include "../../DSP/oscillators/phasors/LFOPhasor.h"
+#include "../../DSP/oscillators/phasors/PMPhasor.h"
 #include "../../DSP/utility/PitchToFreq.h"
 
 
@@ -17,7 +17,7 @@
 namespace pdsp{
 
     /*!
-    @brief pdsp::WaveTable based oscillator
+    @brief pdsp::WaveTable based oscillator, the band-limited levels of the WaveTable are selected following the pitch so it doesn't alias.
     */  
 
 class TableOscillator : public Patchable {
@@ -62,7 +62,7 @@ private:
 
     WaveTableOsc    wto;
     PitchToFreq     p2f;
-    LFOPhasor       phasor;
+    PMPhasor        phasor;
     
 };
 
@@ -43,6 +43,11 @@ void pdsp::IRVerb::loadIR ( std::string path ) {
     
 }
 
+void pdsp::IRVerb::setNonUniformPartitioning( bool active, int maxPartition ){
+    reverbL.setNonUniformPartitioning( active, maxPartition );
+    reverbR.setNonUniformPartitioning( active, maxPartition );
+}
+
 // ---------------------- legacy ------------------------------------
 
 pdsp::Patchable& pdsp::IRVerb::in_mono(){
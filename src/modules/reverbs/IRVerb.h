@@ -39,6 +39,13 @@ public:
     */  
     void loadIR ( std::string path );
 
+    /*!
+    @brief activates the non-uniform partitioning of the convolvers, the tail of the impulse response is processed on a background thread. Use it for long impulse responses, call it before loadIR().
+    @param[in] active true to activate the non-uniform partitioning
+    @param[in] maxPartition the max size of the tail partitions in samples. If omitted 16384 is used.
+    */  
+    void setNonUniformPartitioning( bool active, int maxPartition=PDSP_CONVOLVER_MAX_PARTITION );
+
 /*!
     @cond HIDDEN_SYMBOLS
 */
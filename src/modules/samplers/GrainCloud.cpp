@@ -194,13 +194,13 @@ pdsp::Patchable& pdsp::GrainCloud::ch( size_t index ){
     return out("L");
 }
 
-void pdsp::GrainCloud::setSample(SampleBuffer* samplePointer, int index){
+void pdsp::GrainCloud::setSample(const SampleBuffer* samplePointer, int index){
     for(int i=0; i<voices; ++i){
         streams[i].setSample(samplePointer, index);
     }
 }
 
-void pdsp::GrainCloud::addSample(SampleBuffer* samplePointer){
+void pdsp::GrainCloud::addSample(const SampleBuffer* samplePointer){
     for(int i=0; i<voices; ++i){
         streams[i].addSample(samplePointer);
     }
@@ -212,6 +212,12 @@ void pdsp::GrainCloud::setWindowType(Window_t type, int window_length){
     }
 }
 
+void pdsp::GrainCloud::setInterpolation(Interpolator_t type){
+    for(int i=0; i<voices; ++i){
+        streams[i].setInterpolation(type);
+    }
+}
+
 int pdsp::GrainCloud::getVoicesNum() const {
     return voices;
 }
@@ -126,14 +126,14 @@ public:
     @brief adds a pointer to a SampleBuffer to an internal array of SampleBuffer pointers
     @param[in] newSample pointer to a SampleBuffer
     */ 
-    void addSample(SampleBuffer* newSample);
+    void addSample(const SampleBuffer* newSample);
     
     /*!
     @brief Sets the SampleBuffer pointer at the given index to a new pointer.
     @param[in] samplePointer pointer to a sample buffer with a loaded file inside
     @param[in] index index of the position of the sample to set inside the sample pointers table
     */ 
-    void setSample(SampleBuffer* samplePointer, int index=0);
+    void setSample(const SampleBuffer* samplePointer, int index=0);
     
     /*!
     @brief sets the envelope window shape, optionally the resolution of the table.
@@ -141,6 +141,12 @@ public:
     @param[in] window_length window length, if not specified 1024
     */    
     void setWindowType(Window_t type, int window_length=1024 );
+    
+    /*!
+    @brief sets the interpolation used by all the grains to read the sample, see Sampler::setInterpolation(). Sinc avoids the aliasing of the grains pitched up.
+    @param[in] type interpolation type
+    */  
+    void setInterpolation(Interpolator_t type);
 
 /*!
     @cond HIDDEN_SYMBOLS
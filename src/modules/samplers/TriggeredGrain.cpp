@@ -91,14 +91,18 @@ pdsp::Patchable& pdsp::TriggeredGrain::out_jitter(){
     return out("jitter");
 }
 
-void pdsp::TriggeredGrain::addSample(pdsp::SampleBuffer* newSample){
+void pdsp::TriggeredGrain::addSample(const pdsp::SampleBuffer* newSample){
     grain.addSample(newSample);
 }
 
-void pdsp::TriggeredGrain::setSample(SampleBuffer* samplePointer, int index){
+void pdsp::TriggeredGrain::setSample(const SampleBuffer* samplePointer, int index){
     grain.setSample(samplePointer, index);
 }
 
 void pdsp::TriggeredGrain::setWindowType(Window_t type, int window_length){
     window.setWindowType(type, window_length);
 }
+
+void pdsp::TriggeredGrain::setInterpolation(Interpolator_t type){
+    grain.setInterpolation(type);
+}
@@ -127,7 +127,7 @@ void pdsp::Engine::setChannels( int inputChannels, int outputChannels ){
 
 }
 
-void pdsp::Engine::setup( int sampleRate, int bufferSize, int nBuffers){
+void pdsp::Engine::setup( int sampleRate, int bufferSize, int nBuffers, int threads ){
  
     //ofAddListener( ofEvents().exit, this, &pdsp::Engine::onExit );
     
@@ -159,6 +159,9 @@ void pdsp::Engine::setup( int sampleRate, int bufferSize, int nBuffers){
     // prepare all the units / modules
     pdsp::prepareAllToPlay(bufferSize, static_cast<double>(sampleRate) );
 
+    // starts the processing workers, if any
+    processor.setParallelThreads( threads );
+
 
     // starts engine
     
@@ -432,6 +435,19 @@ void pdsp::Engine::setBackgroundAudio( bool active ){
     bBackgroundAudio = active;
 }
 
+void pdsp::Engine::setCompiledGraph( bool active ){
+    processor.setCompiledGraph( active );
+}
+
+int pdsp::Engine::getMessageOverflows() const {
+    return pdsp::MessageBuffer::getOverflows() + pdsp::Sequence::getOverflows();
+}
+
+void pdsp::Engine::resetMessageOverflows(){
+    pdsp::MessageBuffer::resetOverflows();
+    pdsp::Sequence::resetOverflows();
+}
+
 void pdsp::Engine::setApi( ofSoundDevice::Api api ){
     this->api = api;
 }
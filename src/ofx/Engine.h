@@ -44,8 +44,9 @@ public:
     @param[in] sampleRate audio callbacks sample rate
     @param[in] bufferSize audio callbacks expected buffer size. 
     @param[in] nBuffers number of buffers in the audioQueue
+    @param[in] threads number of threads used for processing the patch, audio thread included, 1 by default. With more than one thread the independent parts of the patch are processed in parallel, see pdsp::Processor::setParallelThreads()
     */
-    void setup(int sampleRate, int bufferSize, int nBuffers);
+    void setup(int sampleRate, int bufferSize, int nBuffers, int threads=1);
     
     /*!
     @brief starts the audio streams again if they were stopped.
@@ -163,6 +164,22 @@ public:
     */   
     void setBackgroundAudio( bool active );
 
+    /*!
+    @brief activate/deactivate the compiled graph mode of the internal processor, see pdsp::Processor::setCompiledGraph() for more info.
+    @param active true to activate the compiled graph, false to go back to recursive processing
+    */   
+    void setCompiledGraph( bool active );
+
+    /*!
+    @brief returns the number of sequencer, midi and osc messages dropped since the start or the last resetMessageOverflows() because they exceeded the memory reserved to process them into the audio thread. Thread-safe.
+    */   
+    int getMessageOverflows() const;
+
+    /*!
+    @brief resets the counter returned by getMessageOverflows(). Thread-safe.
+    */   
+    void resetMessageOverflows();
+
 /*!
     @cond HIDDEN_SYMBOLS
 */
@@ -15,6 +15,7 @@ pdsp::midi::Input::Input(){
     
     lastread = 0;
     index = 0;
+    bufferPosition = 0.0;
 }
 
 pdsp::midi::Input::~Input(){
@@ -36,7 +37,6 @@ void pdsp::midi::Input::initPort() {
         midiIn_p = &midiIn;
         midiIn_p->addListener(this); // add ofApp as a listener
         connected = true;
-        bufferChrono = std::chrono::high_resolution_clock::now();
     }
 }
 
@@ -85,7 +85,8 @@ std::vector<std::string> pdsp::midi::Input::getPortList()
 
 
 void pdsp::midi::Input::prepareToPlay( int expectedBufferSize, double sampleRate ){
-    oneSlashMicrosecForSample = 1.0 / (1000000.0 / sampleRate);
+    clock.reset( sampleRate );
+    bufferPosition = 0.0;
 }
 
 void pdsp::midi::Input::releaseResources(){}
@@ -98,49 +99,59 @@ const std::vector<pdsp::_PositionedMidiMessage> & pdsp::midi::Input::getMessageV
 
 void pdsp::midi::Input::newMidiMessage(ofxMidiMessage& eventArgs) noexcept{
     	
-    // calculate the right offset inside the bufferSize
-    int write = index +1;
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+
+    int write = index.load( std::memory_order_relaxed ) + 1;
     if(write>=(int)circularBuffer.size()){ write = 0; } 
     
+    // the ring is full, the audio thread is not running
+    if( write == lastread.load( std::memory_order_acquire ) ){ return; }
+
     circularBuffer[write].message = eventArgs;
-    circularBuffer[write].timepoint = std::chrono::high_resolution_clock::now();
+    circularBuffer[write].timepoint = now;
+    // not used by the audio thread, copying them there would allocate
+    circularBuffer[write].message.bytes.clear();
+    circularBuffer[write].message.portName.clear();
     
-    index = write;    
-}
-
-void pdsp::midi::Input::pushToReadVector( pdsp::_PositionedMidiMessage & message ){
-        std::chrono::duration<double> offset = message.timepoint - bufferChrono; 
-        message.sample = static_cast<int>( static_cast <double>( std::chrono::duration_cast<std::chrono::microseconds>(offset).count()) * oneSlashMicrosecForSample);
-        readVector.push_back( message );    
+    // publishes the slot contents
+    index.store( write, std::memory_order_release );
 }
 
 void pdsp::midi::Input::processMidi( const int &bufferSize ) noexcept{
+
+    clock.addCallback( std::chrono::high_resolution_clock::now(), bufferPosition );
+    
+    // the messages arrived during the last buffer period are played in this buffer
+    // with the same offsets, so the latency is constant and the jitter of the callbacks doesn't matter 
+    double start = bufferPosition - bufferSize;
+    bufferPosition += bufferSize;
+
     if(connected){
         
         readVector.clear();
-        int read = index;
-
-        if(read<lastread){ // two segments
-            for(int i=lastread+1; i<(int)circularBuffer.size(); ++i){
-                pushToReadVector( circularBuffer[i] );
-            }            
-            for( int i=0; i<=read; ++i){
-                pushToReadVector( circularBuffer[i] );
-            }            
-        }else{
-            for(int i=lastread+1; i<=read; ++i){
-                pushToReadVector( circularBuffer[i] );
-            }
-        }
-        
-        lastread = read;
-        bufferChrono = std::chrono::high_resolution_clock::now();
-        
-        //now sanitize messages to bufferSize
-        for(_PositionedMidiMessage &msg : readVector){
+        int read = index.load( std::memory_order_acquire );
+        int i = lastread.load( std::memory_order_relaxed );
+
+        // the messages exceeding the reserved vector are left for the next buffer
+        while( i != read && readVector.size() < readVector.capacity() ){
+            int n = i + 1;
+            if( n == (int)circularBuffer.size() ){ n = 0; }
+
+            _PositionedMidiMessage & msg = circularBuffer[n];
+            double offset = clock.toSamples( msg.timepoint ) - start;
+
+            // arrived after the fitted start of this buffer because the callback was late, it is left for the next buffer
+            if( offset >= bufferSize && offset < 2*bufferSize ){ break; }
+
+            msg.sample = static_cast<int>( offset );
             if(msg.sample >= bufferSize){ msg.sample = bufferSize-1; } else 
             if(msg.sample < 0 ) { msg.sample = 0; }
-        }       
+            readVector.push_back( msg );
+
+            i = n;
+        }
+        
+        lastread.store( i, std::memory_order_release );
     }
 }
 
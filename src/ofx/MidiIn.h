@@ -11,6 +11,7 @@
 #include "ofxMidi.h"
 #include <chrono>
 #include "helper/PositionedMidiMessage.h"
+#include "helper/ClockMapper.h"
 #include "../DSP/pdspCore.h"
 
 /*!
@@ -92,15 +93,15 @@ private:
     ofxMidiIn   midiIn;
     ofxMidiIn*  midiIn_p;
     
+    // single producer single consumer ring, index is the last slot written by the midi thread
+    // and lastread the last slot consumed by the audio thread
     std::atomic<int> index;
-    int lastread;
+    std::atomic<int> lastread;
     std::vector<_PositionedMidiMessage>    circularBuffer;
     std::vector<_PositionedMidiMessage>    readVector;
 
-    double                                                      oneSlashMicrosecForSample;
-    std::chrono::time_point<std::chrono::high_resolution_clock> bufferChrono;
-    
-    void pushToReadVector( _PositionedMidiMessage & message );
+    ClockMapper clock;
+    double      bufferPosition;
     
     bool connected;
     
@@ -45,7 +45,6 @@ pdsp::midi::Output::Output(){
     connected = false;
     
     //midi daemon init
-    runMidiDaemon = false;
     chronoStarted = false;
     
     //processing init
@@ -296,6 +295,9 @@ void pdsp::midi::Output::process( int bufferSize ) noexcept{
             if( write >= (int)circularBuffer.size() ){ write = 0; };
             writeindex = write;
         }
+        if( ! messagesToSend.empty() ){
+            OutputScheduler::notify();
+        }
 
 
     }//end checking connected
@@ -303,53 +305,48 @@ void pdsp::midi::Output::process( int bufferSize ) noexcept{
 
 void pdsp::midi::Output::startMidiDaemon(){
     
-    runMidiDaemon = true;
-    midiDaemonThread = std::thread( midiDaemonFunctionWrapper, this );   
+    OutputScheduler::add( this );
     
 }
     
-void pdsp::midi::Output::midiDaemonFunctionWrapper(pdsp::midi::Output* parent){
-    parent->midiDaemonFunction();
-}
-   
+std::chrono::high_resolution_clock::time_point pdsp::midi::Output::dispatch( std::chrono::high_resolution_clock::time_point now ){
     
-void pdsp::midi::Output::midiDaemonFunction() noexcept{
-    
-    while (runMidiDaemon){
-
-        while( send!=writeindex && circularBuffer[send].scheduledTime < std::chrono::high_resolution_clock::now() ){
-           
-            // SEND MESSAGES HERE
-            ScheduledMidiMessage& nextMessage = circularBuffer[send];
-            
-            switch(nextMessage.midi.status){
-            case MIDI_NOTE_ON:
-                midiOut_p->sendNoteOn(nextMessage.midi.channel, nextMessage.midi.pitch, nextMessage.midi.velocity);
-                break;
-            case MIDI_NOTE_OFF:
-                midiOut_p->sendNoteOff(nextMessage.midi.channel, nextMessage.midi.pitch, nextMessage.midi.velocity);
-                break;
-            case MIDI_CONTROL_CHANGE:
-                midiOut_p->sendNoteOff(nextMessage.midi.channel, nextMessage.midi.control, nextMessage.midi.value);
-                break;
-            default: break;
-            }
-
-            send++;
+    while( send!=writeindex && circularBuffer[send].scheduledTime <= now ){
+       
+        // SEND MESSAGES HERE
+        ScheduledMidiMessage& nextMessage = circularBuffer[send];
+        
+        switch(nextMessage.midi.status){
+        case MIDI_NOTE_ON:
+            midiOut_p->sendNoteOn(nextMessage.midi.channel, nextMessage.midi.pitch, nextMessage.midi.velocity);
+            break;
+        case MIDI_NOTE_OFF:
+            midiOut_p->sendNoteOff(nextMessage.midi.channel, nextMessage.midi.pitch, nextMessage.midi.velocity);
+            break;
+        case MIDI_CONTROL_CHANGE:
+            midiOut_p->sendNoteOff(nextMessage.midi.channel, nextMessage.midi.control, nextMessage.midi.value);
+            break;
+        default: break;
         }
 
-        std::this_thread::sleep_for(std::chrono::microseconds(500));
-
-    }    
+        send++;
+        if( send >= int(circularBuffer.size()) ){
+            send = 0;
+        }
+    }
 
-    if(verbose) std::cout<<"[pdsp] closing midi out daemon thread\n";
+    if( send!=writeindex ){
+        return circularBuffer[send].scheduledTime;
+    }else{
+        return std::chrono::high_resolution_clock::time_point::max();
+    }
 }
     
  
     
 void pdsp::midi::Output::closeMidiDaemon(){
-    runMidiDaemon = false;
-    midiDaemonThread.detach();
+    OutputScheduler::remove( this );
+    if(verbose) std::cout<<"[pdsp] midi out removed from the output scheduler\n";
 }
     
 #endif
@@ -18,6 +18,7 @@
 #include <atomic>
 #include "../DSP/pdspCore.h"
 #include "../sequencer/SequencerSection.h"
+#include "helper/OutputScheduler.h"
 
 /*!
 @brief utility class manage midi output ports and send midi messages from the internal generative music system
@@ -25,7 +26,7 @@
 
 namespace pdsp { namespace midi {
 
-class Output : public pdsp::ExtSequencer, public pdsp::Preparable {
+class Output : public pdsp::ExtSequencer, public pdsp::Preparable, public pdsp::ScheduledOutput {
 
 private:
 
@@ -145,11 +146,7 @@ private:
     //MIDI DAEMON MEMBERS---------------------------------------------------------------
     void                                                startMidiDaemon();
     void                                                closeMidiDaemon();
-    void                                                midiDaemonFunction() noexcept;
-    static void                                         midiDaemonFunctionWrapper(Output* parent);
-    
-    std::thread                 midiDaemonThread;
-    std::atomic<bool>           runMidiDaemon;
+    std::chrono::high_resolution_clock::time_point      dispatch( std::chrono::high_resolution_clock::time_point now ) override;
     
     //midi output processing members
     bool                                                        chronoStarted;
@@ -1,7 +1,6 @@
 
 #include "OscInput.h"
 
-#define OFXPDSP_OSCINPUT_MESSAGERESERVE 128
 #define OFXPDSP_OSCCIRCULARBUFFER_SIZE 10000
 
 std::vector<pdsp::osc::Input*> pdsp::osc::Input::instances;
@@ -10,7 +9,6 @@ pdsp::osc::Input::Input() {
     
     parsers.clear();
     
-    readVector.reserve(OFXPDSP_OSCINPUT_MESSAGERESERVE);
     circularBuffer.resize( OFXPDSP_OSCCIRCULARBUFFER_SIZE );
     
     lastread = 0;
@@ -22,8 +20,7 @@ pdsp::osc::Input::Input() {
     tempoAddress = "";
     tempoArgument = 0;
     
-    receiver.circularBuffer = &circularBuffer;
-    receiver.index = &index;
+    receiver.input = this;
 
     instances.push_back(this);
 }   
@@ -74,20 +71,24 @@ void pdsp::osc::Input::close(){
 }
 
 void pdsp::osc::Input::linkTempo( string oscAddress, int argument ){
+    std::lock_guard<std::mutex> lock( addressMutex );
     tempoLinked = true;
     tempoAddress = oscAddress;
     tempoArgument = argument;
 }
 
 int pdsp::osc::Input::checkParser( std::string oscAddress ){
-    for( size_t i=0; i<parsers.size(); ++i ){
-        if( parsers[i]->address == oscAddress ){
-            return i;
-        }
+    auto it = addresses.find( oscAddress );
+    if( it != addresses.end() ){
+        return it->second;
     }
     parsers.emplace_back();
     parsers.back() = new OscParser();
     parsers.back()->address = oscAddress;
+    
+    // the parser is published to the network thread only when it's ready
+    std::lock_guard<std::mutex> lock( addressMutex );
+    addresses[oscAddress] = parsers.size()-1;
     return parsers.size()-1;
 }
 
@@ -109,11 +110,10 @@ std::function<float(float)> & pdsp::osc::Input::parser( string oscAddress, int a
 }
 
 void pdsp::osc::Input::initTo( string oscAddress, int argument, float value  ){
-    for( size_t i=0; i<parsers.size(); ++i ){
-        if( parsers[i]->address == oscAddress ){
-            parsers[i]->initTo( argument, value );
-            return;
-        }
+    auto it = addresses.find( oscAddress );
+    if( it != addresses.end() ){
+        parsers[it->second]->initTo( argument, value );
+        return;
     }
     std::cout<<"[pdsp] wrong address selected for initTo\n";
     pdsp_trace();
@@ -131,75 +131,43 @@ void pdsp::osc::Input::prepareToPlay( int expectedBufferSize, double sampleRate
 
 void pdsp::osc::Input::releaseResources(){}
 
-void pdsp::osc::Input::pushToReadVector( pdsp::osc::Input::_PositionedOscMessage & message ){
-        std::chrono::duration<double> offset = message.timepoint - bufferChrono; 
-        message.sample = static_cast<int>( static_cast <double>( std::chrono::duration_cast<std::chrono::microseconds>(offset).count()) * oneSlashMicrosecForSample);
-        readVector.push_back( message );    
-}
-
 void pdsp::osc::Input::processOsc( int bufferSize ) noexcept {
     
     if(connected){
         
-        readVector.clear();
-        int read = index;
-
-        if(read<lastread){ // two segments
-            for(int i=lastread+1; i<(int)circularBuffer.size(); ++i){
-                pushToReadVector( circularBuffer[i] );
-            }            
-            for( int i=0; i<=read; ++i){
-                pushToReadVector( circularBuffer[i] );
-            }            
-        }else{
-            for(int i=lastread+1; i<=read; ++i){
-                pushToReadVector( circularBuffer[i] );
-            }
-        }
-        
-        lastread = read;
-        bufferChrono = std::chrono::high_resolution_clock::now();
-        
-        //now sanitize messages to bufferSize
-        for(_PositionedOscMessage &msg : readVector){
-            if(msg.sample >= bufferSize){ msg.sample = bufferSize-1; } else
-            if(msg.sample < 0 ) { msg.sample = 0; }
-        }
-        
         // clean the message buffers
         for (size_t i = 0; i < parsers.size(); ++i){
             parsers[i]->clear( sendClearMessages );
         }
         
-        // adds the messages to the buffers, only the first arg of each osc message is read, as float
-        for(_PositionedOscMessage &osc : readVector){
-            for( size_t k=0; k<parsers.size(); ++k){
-                if( parsers[k]->address == osc.message.getAddress() ){
-                    parsers[k]->process( osc.message, osc.sample );
-                }
-            } 
+        int read = index;
+        
+        // adds the messages to the buffers, reading them directly from the circular buffer
+        int i = lastread;
+        while( i != read ){
+            i++;
+            if( i == (int)circularBuffer.size() ){ i = 0; }
+            
+            const _PositionedOscMessage & osc = circularBuffer[i];
+            
+            std::chrono::duration<double> offset = osc.timepoint - bufferChrono; 
+            int sample = static_cast<int>( static_cast <double>( std::chrono::duration_cast<std::chrono::microseconds>(offset).count()) * oneSlashMicrosecForSample);
+            if(sample >= bufferSize){ sample = bufferSize-1; } else
+            if(sample < 0 ) { sample = 0; }
+            
+            if( osc.parser >= 0 ){
+                parsers[osc.parser]->process( osc.args, osc.numArgs, sample );
+            }
             
-            if( tempoLinked ){
-                if(osc.message.getAddress() == tempoAddress ){
-                    if( tempoArgument < int(osc.message.getNumArgs()) ){
-                        switch( osc.message.getArgType( tempoArgument ) ){
-                            case OFXOSC_TYPE_INT32:
-                                tempoChanged = true;
-                                tempo = osc.message.getArgAsInt32( tempoArgument );
-                            break;
-                            
-                            case OFXOSC_TYPE_FLOAT:
-                                tempoChanged = true;
-                                tempo = osc.message.getArgAsFloat( tempoArgument );
-                            break;
-                            
-                            default: break;
-                        }
-                    }
-                }
+            if( osc.hasTempo ){
+                tempoChanged = true;
+                tempo = osc.tempo;
             }
         }
         
+        lastread = read;
+        bufferChrono = std::chrono::high_resolution_clock::now();
+        
         // now process all the linked sequencers
         for (size_t i = 0; i < parsers.size(); ++i){
             parsers[i]->processDestinations( bufferSize );
@@ -221,77 +189,63 @@ double pdsp::osc::Input::getTempo(){
 
 
 void pdsp::osc::Input::CustomOscReceiver::ProcessMessage(const _PDSPOscReceivedMessage_t &m, const _PDSPIpEndpointName_t &remoteEndpoint){
-	// convert the message to an ofxOscMessage
-	ofxOscMessage msg;
-
-	// set the address
-	msg.setAddress(m.AddressPattern());
-	
-	// set the sender ip/host
-	char endpointHost[_PDSPIpEndpointName_t::ADDRESS_STRING_LENGTH];
-	remoteEndpoint.AddressAsString(endpointHost);
-	msg.setRemoteEndpoint(endpointHost, remoteEndpoint.port);
-
-	// transfer the arguments
-	for(_PDSPOscReceivedMessage_t::const_iterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd(); ++arg){
-		if(arg->IsInt32()){
-			msg.addIntArg(arg->AsInt32Unchecked());
-		}
-		else if(arg->IsInt64()){
-			msg.addInt64Arg(arg->AsInt64Unchecked());
-		}
-		else if( arg->IsFloat()){
-			msg.addFloatArg(arg->AsFloatUnchecked());
-		}
-		else if(arg->IsDouble()){
-			msg.addDoubleArg(arg->AsDoubleUnchecked());
-		}
-		else if(arg->IsString()){
-			msg.addStringArg(arg->AsStringUnchecked());
-		}
-		else if(arg->IsSymbol()){
-			msg.addSymbolArg(arg->AsSymbolUnchecked());
-		}
-		else if(arg->IsChar()){
-			msg.addCharArg(arg->AsCharUnchecked());
-		}
-		else if(arg->IsMidiMessage()){
-			msg.addMidiMessageArg(arg->AsMidiMessageUnchecked());
-		}
-		else if(arg->IsBool()){
-			msg.addBoolArg(arg->AsBoolUnchecked());
-		}
-		else if(arg->IsNil()){
-			msg.addNoneArg();
-		}
-		else if(arg->IsInfinitum()){
-			msg.addTriggerArg();
-		}
-		else if(arg->IsTimeTag()){
-			msg.addTimetagArg(arg->AsTimeTagUnchecked());
-		}
-		else if(arg->IsRgbaColor()){
-			msg.addRgbaColorArg(arg->AsRgbaColorUnchecked());
-		}
-		else if(arg->IsBlob()){
-			const char * dataPtr;
-			_PDSPosc_bundle_element_size_t len = 0;
-			arg->AsBlobUnchecked((const void*&)dataPtr, len);
-			ofBuffer buffer(dataPtr, len);
-			msg.addBlobArg(buffer);
-		}
-		else {
-			ofLogError("ofxOscReceiver") << "ProcessMessage(): argument in message "
-				<< m.AddressPattern() << " is an unknown type "
-				<< (int) arg->TypeTag() << " '" << (char) arg->TypeTag() << "'";
-				break;
-		}
-	}
-
-    int write = index->load() +1;
-    if(write>=(int)circularBuffer->size()){ write = 0; } 
-    circularBuffer->at(write).message = msg;
-    circularBuffer->at(write).timepoint = std::chrono::high_resolution_clock::now();
-
-    index->store( write );   
+
+    int write = input->index.load() +1;
+    if(write>=(int)input->circularBuffer.size()){ write = 0; } 
+    _PositionedOscMessage & msg = input->circularBuffer[write];
+    
+    msg.parser = -1;
+    msg.hasTempo = false;
+    
+    {
+        std::lock_guard<std::mutex> lock( input->addressMutex );
+        auto it = input->addresses.find( m.AddressPattern() );
+        if( it != input->addresses.end() ){
+            msg.parser = it->second;
+        }
+        if( input->tempoLinked && input->tempoAddress == m.AddressPattern() ){
+            msg.hasTempo = true;
+        }
+    }
+    
+    if( msg.parser == -1 && !msg.hasTempo ){ 
+        return; // no one is listening to this address
+    }
+    
+    // convert the arguments to float
+    int a = 0;
+    bool tempoFound = false;
+    for(_PDSPOscReceivedMessage_t::const_iterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd() && a<OFXPDSP_OSCINPUT_MAXARGS; ++arg){
+        float value = 0.0f;
+        bool numeric = false;
+        
+        if(arg->IsInt32()){
+            value = arg->AsInt32Unchecked();
+            numeric = true;
+        }
+        else if( arg->IsFloat()){
+            value = arg->AsFloatUnchecked();
+            numeric = true;
+        }
+        else if(arg->IsBool()){
+            value = arg->AsBoolUnchecked() ? 1.0f : 0.0f;
+        }
+        else if(arg->IsString()){
+            // try to parse string
+            value = ofToFloat( arg->AsStringUnchecked() );
+        }
+        
+        if( msg.hasTempo && a == input->tempoArgument && numeric ){
+            msg.tempo = value;
+            tempoFound = true;
+        }
+        
+        msg.args[a] = value;
+        a++;
+    }
+    msg.numArgs = a;
+    msg.hasTempo = tempoFound;
+    msg.timepoint = std::chrono::high_resolution_clock::now();
+
+    input->index.store( write );   
 }
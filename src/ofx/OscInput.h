@@ -13,13 +13,19 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <unordered_map>
 #include "../DSP/pdspCore.h"
 #include "../sequencer/SequencerSection.h"
 #include "ofxOsc.h"
 #include "helper/OscParser.h"
 
+// arguments after this number are ignored
+#define OFXPDSP_OSCINPUT_MAXARGS 16
+
 /*!
 @brief utility class manage OSC input to the DSP
+
+The messages are decoded on the network thread, only the messages with a registered address are passed to the audio thread, with their first 16 arguments converted to float.
 */
 
 /*!
@@ -43,21 +49,22 @@ class Input : public pdsp::Preparable {
 
 private:
     
+    // plain data, so the network thread can write it into the circular buffer without allocations
     class _PositionedOscMessage {
     public:
-        _PositionedOscMessage(){ sample = -1; };
-        _PositionedOscMessage(ofxOscMessage message, int sample) : message(message), sample(sample){};
-        
+        _PositionedOscMessage(){ parser = -1; numArgs = 0; hasTempo = false; tempo = 0.0; };
         
         std::chrono::time_point<std::chrono::high_resolution_clock> timepoint;
-        ofxOscMessage message;
-        int sample;
+        int     parser; // index of the parser for the message address, -1 if there isn't one
+        int     numArgs;
+        float   args[OFXPDSP_OSCINPUT_MAXARGS];
+        bool    hasTempo;
+        double  tempo;
     };
 
     class CustomOscReceiver : public ofxOscReceiver {
     public:
-        std::vector<_PositionedOscMessage> * circularBuffer;
-        std::atomic<int> * index;
+        Input * input;
     protected:
         void ProcessMessage(const _PDSPOscReceivedMessage_t &m, const _PDSPIpEndpointName_t &remoteEndpoint) override;
     };
@@ -158,7 +165,10 @@ private:
     std::atomic<int> index;
     int lastread;
     std::vector<_PositionedOscMessage>    circularBuffer;
-    std::vector<_PositionedOscMessage>    readVector;
+    
+    // address to parser index, read by the network thread
+    std::unordered_map<std::string, int> addresses;
+    std::mutex addressMutex;
 
     double oneSlashMicrosecForSample;
 
@@ -171,7 +181,6 @@ private:
     double      tempo;
     bool        tempoChanged;
     
-    void pushToReadVector( _PositionedOscMessage & message );
     int checkParser( std::string oscAddress );
 
     static std::vector<Input*> instances;
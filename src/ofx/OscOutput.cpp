@@ -49,9 +49,6 @@ pdsp::osc::Output::Output(){
     
     chronoStarted = false;
     
-    //midi daemon init
-    runDaemon = false;
-    
     //processing init
     circularBuffer.resize(OFXPDSP_OSCOUTPUTCIRCULARBUFFERSIZE);
     writeindex = 0;
@@ -172,58 +169,53 @@ void pdsp::osc::Output::process( int bufferSize ) noexcept{
         //sort messages to send
         sort(messagesToSend.begin(), messagesToSend.end(), scheduledSort);
 
+        // the message is written before advancing the index, so the scheduler sends only complete messages
         for(ScheduledOscMessage &msg : messagesToSend){
+            circularBuffer[writeindex] = msg;
             int write = writeindex+1;
             if( write >= (int)circularBuffer.size() ){ write = 0; };
-            circularBuffer[write] = msg;
             writeindex = write;
         }
+        if( ! messagesToSend.empty() ){
+            OutputScheduler::notify();
+        }
         
     }//end checking connected
 }
 
 void pdsp::osc::Output::startDaemon(){ // OK
     
-    runDaemon = true;
-    daemonThread = thread( daemonFunctionWrapper, this );   
-    
-}
-   
+    OutputScheduler::add( this );
     
-void pdsp::osc::Output::daemonFunctionWrapper(pdsp::osc::Output* parent){
-    parent->daemonFunction();
 }
-   
-    
-void pdsp::osc::Output::daemonFunction() noexcept{
+       
+std::chrono::high_resolution_clock::time_point pdsp::osc::Output::dispatch( std::chrono::high_resolution_clock::time_point now ){
     
-    while (runDaemon){
-
-        while( send!=writeindex && circularBuffer[send].scheduledTime < chrono::high_resolution_clock::now() ){
-            
-            #ifndef NDEBUG
-                if(verbose) cout << "[pdsp] OSC message: address = "<< circularBuffer[send].message.getAddress() << " | value = "<<(int)circularBuffer[send].message.getArgAsFloat(0)<<"\n";
-            #endif
-                       
-            // SEND MESSAGES HERE
-            sender.sendMessage( circularBuffer[send].message, false );
-
-            send++;
-            if( send >= int(circularBuffer.size()) ){
-                send = 0;
-            }
+    while( send!=writeindex && circularBuffer[send].scheduledTime <= now ){
+        
+        #ifndef NDEBUG
+            if(verbose) cout << "[pdsp] OSC message: address = "<< circularBuffer[send].message.getAddress() << " | value = "<<(int)circularBuffer[send].message.getArgAsFloat(0)<<"\n";
+        #endif
+                   
+        // SEND MESSAGES HERE
+        sender.sendMessage( circularBuffer[send].message, false );
+
+        send++;
+        if( send >= int(circularBuffer.size()) ){
+            send = 0;
         }
+    }
 
-        std::this_thread::sleep_for(std::chrono::microseconds(500));
-
+    if( send!=writeindex ){
+        return circularBuffer[send].scheduledTime;
+    }else{
+        return std::chrono::high_resolution_clock::time_point::max();
     }
-   
-    if(verbose) cout<<"[pdsp] closing OSC out daemon thread\n";
 }
     
  
     
 void pdsp::osc::Output::closeDaemon(){
-    runDaemon = false;
-    daemonThread.detach();
+    OutputScheduler::remove( this );
+    if(verbose) cout<<"[pdsp] OSC out removed from the output scheduler\n";
 }
@@ -15,6 +15,7 @@
 #include <atomic>
 #include "../DSP/pdspCore.h"
 #include "../sequencer/SequencerSection.h"
+#include "helper/OutputScheduler.h"
 #include "ofxOsc.h"
 
 /*!
@@ -23,7 +24,7 @@
 
 namespace pdsp { namespace osc {
 
-class Output : public pdsp::ExtSequencer, public pdsp::Preparable {
+class Output : public pdsp::ExtSequencer, public pdsp::Preparable, public pdsp::ScheduledOutput {
 
 private:
 
@@ -123,11 +124,7 @@ private:
     //MIDI DAEMON MEMBERS---------------------------------------------------------------
     void                                                startDaemon();
     void                                                closeDaemon();
-    void                                                daemonFunction() noexcept;
-    static void                                         daemonFunctionWrapper(Output* parent);
-    
-    thread                                              daemonThread;
-    std::atomic<bool>                                   runDaemon;
+    std::chrono::high_resolution_clock::time_point      dispatch( std::chrono::high_resolution_clock::time_point now ) override;
     
     //serial output processing members
     std::chrono::time_point<std::chrono::high_resolution_clock>   bufferChrono;   
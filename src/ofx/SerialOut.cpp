@@ -58,9 +58,6 @@ pdsp::serial::Output::Output(){
     
     chronoStarted = false;
     
-    //midi daemon init
-    runDaemon = false;
-    
     //processing init
 
     circularBuffer.resize(OFXPDSP_SERIALOUTPUTCIRCULARBUFFERSIZE);   
@@ -221,50 +218,51 @@ void pdsp::serial::Output::process( int bufferSize ) noexcept{
             if( write >= (int)circularBuffer.size() ){ write = 0; };
             writeindex = write;
         }
+        if( ! messagesToSend.empty() ){
+            OutputScheduler::notify();
+        }
     }//end checking connected
 }
 
 void pdsp::serial::Output::startDaemon(){ // OK
     
-    runDaemon = true;
-    daemonThread = thread( daemonFunctionWrapper, this );   
+    OutputScheduler::add( this );
     
 }
+       
+std::chrono::high_resolution_clock::time_point pdsp::serial::Output::dispatch( std::chrono::high_resolution_clock::time_point now ){
     
-void pdsp::serial::Output::daemonFunctionWrapper(pdsp::serial::Output* parent){
-    parent->daemonFunction();
-}
+    while( send!=writeindex && circularBuffer[send].scheduledTime <= now ){
        
-void pdsp::serial::Output::daemonFunction() noexcept{
-    while (runDaemon){
-
-        while( send!=writeindex && circularBuffer[send].scheduledTime < std::chrono::high_resolution_clock::now() ){
-           
-            // SEND MESSAGES HERE
-            ScheduledSerialMessage& nextMessage = circularBuffer[send];
-                           
-            // SEND MESSAGES HERE
-            serial.writeByte( (char)nextMessage.channel );
-            serial.writeByte( (char)nextMessage.message );
-            
-            #ifndef NDEBUG
-                if(verbose) cout << "[pdsp] serial message: channel = "<< (- (int)nextMessage.channel)<< " | value = "<<(int)nextMessage.message<<"\n";
-            #endif
+        // SEND MESSAGES HERE
+        ScheduledSerialMessage& nextMessage = circularBuffer[send];
+                       
+        // SEND MESSAGES HERE
+        serial.writeByte( (char)nextMessage.channel );
+        serial.writeByte( (char)nextMessage.message );
+        
+        #ifndef NDEBUG
+            if(verbose) cout << "[pdsp] serial message: channel = "<< (- (int)nextMessage.channel)<< " | value = "<<(int)nextMessage.message<<"\n";
+        #endif
 
-            send++;
+        send++;
+        if( send >= int(circularBuffer.size()) ){
+            send = 0;
         }
+    }
 
-        std::this_thread::sleep_for(std::chrono::microseconds(500));
-    }    
-    
-    if(verbose) cout<<"[pdsp] closing serial out daemon thread\n";
+    if( send!=writeindex ){
+        return circularBuffer[send].scheduledTime;
+    }else{
+        return std::chrono::high_resolution_clock::time_point::max();
+    }
 }
     
  
     
 void pdsp::serial::Output::closeDaemon(){
-    runDaemon = false;
-    daemonThread.detach();
+    OutputScheduler::remove( this );
+    if(verbose) cout<<"[pdsp] serial out removed from the output scheduler\n";
 }
 
 #endif // __ANDROID__
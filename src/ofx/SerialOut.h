@@ -19,6 +19,7 @@
 #include <atomic>
 #include "../DSP/pdspCore.h"
 #include "../sequencer/SequencerSection.h"
+#include "helper/OutputScheduler.h"
 
 /*!
 @brief utility class manage serial output ports and send bytes from the internal generative music system
@@ -26,7 +27,7 @@
 
 namespace pdsp{ namespace serial {
 
-class Output : public pdsp::ExtSequencer, public pdsp::Preparable {
+class Output : public pdsp::ExtSequencer, public pdsp::Preparable, public pdsp::ScheduledOutput {
 
 private:
 
@@ -135,11 +136,7 @@ private:
     //MIDI DAEMON MEMBERS---------------------------------------------------------------
     void                                                startDaemon();
     void                                                closeDaemon();
-    void                                                daemonFunction() noexcept;
-    static void                                         daemonFunctionWrapper(Output* parent);
-    
-    std::thread                                         daemonThread;
-    std::atomic<bool>                                   runDaemon;
+    std::chrono::high_resolution_clock::time_point      dispatch( std::chrono::high_resolution_clock::time_point now ) override;
     
     //serial output processing members
     std::chrono::time_point<chrono::high_resolution_clock>   bufferChrono;     
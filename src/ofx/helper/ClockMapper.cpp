@@ -0,0 +1,88 @@
+
+#include "ClockMapper.h"
+#include <cmath>
+
+// number of audio callbacks used for the fit
+#define OFXPDSP_CLOCKMAPPER_POINTS 64
+// if a callback is further than this from the fitted line the audio stream was restarted or dropped buffers
+#define OFXPDSP_CLOCKMAPPER_RESET_SECONDS 0.05
+
+pdsp::ClockMapper::ClockMapper(){
+    times.resize( OFXPDSP_CLOCKMAPPER_POINTS );
+    positions.resize( OFXPDSP_CLOCKMAPPER_POINTS );
+    reset( 44100.0 );
+}
+
+void pdsp::ClockMapper::reset( double sampleRate ){
+    this->sampleRate = sampleRate;
+    count = 0;
+    next = 0;
+    slope = sampleRate;
+    intercept = 0.0;
+    origin = std::chrono::high_resolution_clock::now();
+}
+
+double pdsp::ClockMapper::seconds( std::chrono::high_resolution_clock::time_point time ) const noexcept{
+    return std::chrono::duration<double>( time - origin ).count();
+}
+
+void pdsp::ClockMapper::addCallback( std::chrono::high_resolution_clock::time_point time, double position ) noexcept{
+
+    double t = seconds( time );
+
+    if( count > 0 && std::abs( intercept + slope * t - position ) > sampleRate * OFXPDSP_CLOCKMAPPER_RESET_SECONDS ){
+        count = 0;
+        next = 0;
+    }
+
+    times[next] = t;
+    positions[next] = position;
+    next++;
+    if( next == OFXPDSP_CLOCKMAPPER_POINTS ){ next = 0; }
+    if( count < OFXPDSP_CLOCKMAPPER_POINTS ){ count++; }
+
+    fit();
+}
+
+void pdsp::ClockMapper::fit() noexcept{
+
+    // with few points the nominal samplerate is more reliable than the fitted one
+    if( count < 8 ){
+        slope = sampleRate;
+        int last = ( next == 0 ) ? count - 1 : next - 1;
+        intercept = positions[last] - slope * times[last];
+        return;
+    }
+
+    // centered on the mean to keep the precision
+    double meanT = 0.0;
+    double meanP = 0.0;
+    for( int i=0; i<count; ++i ){
+        meanT += times[i];
+        meanP += positions[i];
+    }
+    meanT /= count;
+    meanP /= count;
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for( int i=0; i<count; ++i ){
+        double dt = times[i] - meanT;
+        covariance += dt * ( positions[i] - meanP );
+        variance += dt * dt;
+    }
+
+    double fitted = ( variance > 0.0 ) ? covariance / variance : 0.0;
+
+    // device clocks drift by some ppm, anything far from the nominal rate comes from a bad fit
+    if( std::abs( fitted - sampleRate ) < sampleRate * 0.01 ){
+        slope = fitted;
+    }else{
+        slope = sampleRate;
+    }
+    intercept = meanP - slope * meanT;
+}
+
+double pdsp::ClockMapper::toSamples( std::chrono::high_resolution_clock::time_point time ) const noexcept{
+    return intercept + slope * seconds( time );
+}
@@ -0,0 +1,56 @@
+
+// ClockMapper.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef OFXPDSP_CLOCKMAPPER_H_INCLUDED
+#define OFXPDSP_CLOCKMAPPER_H_INCLUDED
+
+#include <chrono>
+#include <vector>
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+namespace pdsp{
+
+// maps the system clock to the sample clock of the audio device
+// the audio callback times are jittery, so a line is fitted to the last (time, sample count) pairs
+// with least squares and the times are converted with the line instead of the last callback time
+class ClockMapper {
+public:
+    ClockMapper();
+
+    // not on the audio thread, clears the fit
+    void reset( double sampleRate );
+
+    // audio thread, to be called at the start of each buffer with the count of the samples processed before it
+    void addCallback( std::chrono::high_resolution_clock::time_point time, double position ) noexcept;
+
+    // returns the position in samples of the given time, in the same domain of the positions given to addCallback()
+    double toSamples( std::chrono::high_resolution_clock::time_point time ) const noexcept;
+
+private:
+    void fit() noexcept;
+    double seconds( std::chrono::high_resolution_clock::time_point time ) const noexcept;
+
+    std::vector<double> times;
+    std::vector<double> positions;
+    int     count;
+    int     next;
+
+    double  sampleRate;
+    double  slope;
+    double  intercept;
+
+    std::chrono::high_resolution_clock::time_point origin;
+};
+
+}
+
+/*!
+    @endcond
+*/
+
+#endif //OFXPDSP_CLOCKMAPPER_H_INCLUDED
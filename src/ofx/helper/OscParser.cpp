@@ -104,8 +104,8 @@ std::function<float(float)> & pdsp::osc::OscParser::parser( int argument ){
     return channels[argument]->code;
 }
 
-void pdsp::osc::OscParser::process( ofxOscMessage msg, int sample ){
-    int ma = msg.getNumArgs();
+void pdsp::osc::OscParser::process( const float* args, int numArgs, int sample ){
+    int ma = numArgs;
     if( ma > (int) channels.size() ){
         ma = channels.size();
     }
@@ -115,32 +115,7 @@ void pdsp::osc::OscParser::process( ofxOscMessage msg, int sample ){
         bool bAssigned = (channels[a]->messageBuffer != nullptr);
         
         if( bParse || bAssigned ){
-            float value = 0.0f;
-            
-            switch( msg.getArgType( a ) ){
-                case OFXOSC_TYPE_INT32:
-                    value = msg.getArgAsInt32(a);
-                break;
-                
-                case OFXOSC_TYPE_FLOAT:
-                    value = msg.getArgAsFloat(a);
-                break;
-
-                case OFXOSC_TYPE_TRUE:
-                    value = 1.0f;
-                break;
-                
-                case OFXOSC_TYPE_FALSE:
-                    value = 0.0f;
-                break;
-                
-                case OFXOSC_TYPE_STRING:
-                    // try to parse string
-                    value = ofToFloat(msg.getArgAsString(a));
-                break;
-                
-                default: break;
-            }
+            float value = args[a]; // already converted to float by the network thread
             
             if( bParse ){
                 value = channels[a]->code( value );
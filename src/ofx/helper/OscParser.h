@@ -48,7 +48,7 @@ public:
     pdsp::SequencerValueOutput& out_value(  int out );
     void initTo( int argument, float value );
 
-    void process( ofxOscMessage msg, int sample );
+    void process( const float* args, int numArgs, int sample );
     void processDestinations( int bufferSize );
 
     std::function<float(float)> & parser( int argument );
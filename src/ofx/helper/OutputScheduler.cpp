@@ -0,0 +1,72 @@
+
+#include "OutputScheduler.h"
+#include <algorithm>
+
+// maximum sleep time, it bounds the delay of a notify() that finds the mutex taken just while the scheduler goes to sleep
+#define OFXPDSP_OUTPUTSCHEDULER_MAX_WAIT_US 5000
+
+pdsp::OutputScheduler::OutputScheduler(){
+    pending = false;
+}
+
+pdsp::OutputScheduler & pdsp::OutputScheduler::get(){
+    // never destroyed, so outputs with static storage can be removed at exit
+    static OutputScheduler* scheduler = new OutputScheduler();
+    return *scheduler;
+}
+
+void pdsp::OutputScheduler::add( ScheduledOutput* output ){
+    OutputScheduler & scheduler = get();
+    {
+        std::lock_guard<std::mutex> lock( scheduler.mutex );
+        scheduler.outputs.push_back( output );
+        scheduler.pending = true;
+
+        if( ! scheduler.worker.joinable() ){
+            scheduler.worker = std::thread( &OutputScheduler::threadFunction, &scheduler );
+        }
+    }
+    scheduler.condition.notify_one();
+}
+
+void pdsp::OutputScheduler::remove( ScheduledOutput* output ){
+    OutputScheduler & scheduler = get();
+    std::lock_guard<std::mutex> lock( scheduler.mutex );
+    scheduler.outputs.erase( std::remove( scheduler.outputs.begin(), scheduler.outputs.end(), output ), scheduler.outputs.end() );
+}
+
+void pdsp::OutputScheduler::notify(){
+    OutputScheduler & scheduler = get();
+    scheduler.pending = true;
+    // called from the audio thread, so it never blocks on the mutex
+    // when the mutex is free the scheduler is waiting or will check pending after waking up, so the notification can't be lost
+    std::unique_lock<std::mutex> lock( scheduler.mutex, std::try_to_lock );
+    scheduler.condition.notify_one();
+}
+
+void pdsp::OutputScheduler::threadFunction(){
+
+    std::unique_lock<std::mutex> lock( mutex );
+
+    while( true ){
+        pending = false;
+
+        std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+        std::chrono::high_resolution_clock::time_point next = std::chrono::high_resolution_clock::time_point::max();
+
+        // the queues are sorted, so the earliest message of all the outputs is one of their first messages
+        for( ScheduledOutput* output : outputs ){
+            std::chrono::high_resolution_clock::time_point scheduled = output->dispatch( now );
+            if( scheduled < next ){ next = scheduled; }
+        }
+
+        if( outputs.empty() ){
+            // no timeouts when there is nothing to send, add() sets pending under the lock
+            condition.wait( lock, [&](){ return pending.load(); } );
+        }else{
+            std::chrono::high_resolution_clock::time_point limit = now + std::chrono::microseconds( OFXPDSP_OUTPUTSCHEDULER_MAX_WAIT_US );
+            if( next > limit ){ next = limit; }
+            condition.wait_until( lock, next, [&](){ return pending.load(); } );
+        }
+    }
+}
@@ -0,0 +1,64 @@
+
+// OutputScheduler.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef OFXPDSP_OUTPUTSCHEDULER_H_INCLUDED
+#define OFXPDSP_OUTPUTSCHEDULER_H_INCLUDED
+
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+namespace pdsp{
+
+// base class for the outputs that send timed messages to external devices
+// each output has its queue of messages sorted by time, filled by the audio thread
+class ScheduledOutput {
+public:
+    virtual ~ScheduledOutput(){}
+
+    // sends the messages scheduled before now, returns the time of the next message in the queue
+    // or time_point::max() if the queue is empty. Called only from the OutputScheduler thread
+    virtual std::chrono::high_resolution_clock::time_point dispatch( std::chrono::high_resolution_clock::time_point now ) = 0;
+};
+
+// a single thread that sends the messages of all the outputs
+// it sleeps until the earliest scheduled message or until an output notifies new messages
+class OutputScheduler {
+public:
+    static void add( ScheduledOutput* output );
+
+    // after this returns the output is not used anymore by the scheduler thread
+    static void remove( ScheduledOutput* output );
+
+    // to be called after adding messages to the queue, it never waits for the lock so it is safe from the audio thread
+    static void notify();
+
+private:
+    OutputScheduler();
+    static OutputScheduler & get();
+
+    void threadFunction();
+
+    std::vector<ScheduledOutput*>   outputs;
+    std::thread                     worker;
+    std::mutex                      mutex;
+    std::condition_variable         condition;
+    std::atomic<bool>               pending;
+};
+
+}
+
+/*!
+    @endcond
+*/
+
+#endif //OFXPDSP_OUTPUTSCHEDULER_H_INCLUDED
@@ -2,6 +2,8 @@
 #include "Function.h"
 
 #include <string>
+#include <cstring>
+#include <cmath>
 
 pdsp::SequencerGateOutput pdsp::Function::invalidGate = pdsp::SequencerGateOutput();
 
@@ -41,10 +43,7 @@ pdsp::SequencerGateOutput& pdsp::Function::out_trig( std::string name ){
         }
     }
     
-    outputs.emplace_back();
-    outputs.back().name = name;
-    outputs.back().number = -1;
-    outputs.back().messageBuffer = new pdsp::MessageBuffer();
+    addOutput( name, -1 );
     outputs.back().gate_out = new pdsp::SequencerGateOutput();
     outputs.back().gate_out->link( *(outputs.back().messageBuffer) );
     
@@ -71,10 +70,7 @@ pdsp::SequencerGateOutput& pdsp::Function::out_trig( int number ){
         }
     }
     
-    outputs.emplace_back();
-    outputs.back().name = std::to_string( number );
-    outputs.back().number = number;
-    outputs.back().messageBuffer = new pdsp::MessageBuffer();
+    addOutput( std::to_string( number ), number );
     outputs.back().gate_out = new pdsp::SequencerGateOutput();
     outputs.back().gate_out->link( *(outputs.back().messageBuffer) );
     
@@ -94,10 +90,7 @@ pdsp::SequencerValueOutput& pdsp::Function::out_value( std::string name ){
         }
     }
     
-    outputs.emplace_back();
-    outputs.back().name = name;
-    outputs.back().number = -1;
-    outputs.back().messageBuffer = new pdsp::MessageBuffer();
+    addOutput( name, -1 );
     outputs.back().value_out = new pdsp::SequencerValueOutput();
     outputs.back().value_out->link( *(outputs.back().messageBuffer) );
     
@@ -123,36 +116,85 @@ pdsp::SequencerValueOutput& pdsp::Function::out_value( int number ){
         }
     }
     
-    outputs.emplace_back();
-    outputs.back().name = std::to_string(number);
-    outputs.back().number = number;
-    outputs.back().messageBuffer = new pdsp::MessageBuffer();
+    addOutput( std::to_string(number), number );
     outputs.back().value_out = new pdsp::SequencerValueOutput();
     outputs.back().value_out->link( *(outputs.back().messageBuffer) );
     
     return *(outputs.back().value_out);
 }
 
-void pdsp::Function::send( std::string name, float value ) noexcept{
+void pdsp::Function::addOutput( std::string name, int number ){
+    outputs.emplace_back();
+    outputs.back().name = name;
+    outputs.back().number = number;
+    outputs.back().messageBuffer = new pdsp::MessageBuffer();
+
+    if( number >= 0 ){
+        if( number >= (int)numbers.size() ){
+            numbers.resize( number+1, -1 );
+        }
+        numbers[number] = (int)outputs.size() - 1;
+    }
+}
+
+pdsp::Function::Handle pdsp::Function::output( const std::string & name ) const{
+    Handle handle;
     for( size_t i=0; i<outputs.size(); ++i ){
         if( outputs[i].name == name ){
-            outputs[i].messageBuffer->addMessage( value, sample );
-            return;
+            handle.index = (int) i;
+            return handle;
         }
     }
+    std::cout<<"[pdsp] warning! pdsp::Function has no output with this name, returning invalid handle\n";
+    pdsp::pdsp_trace();
+    return handle;
+}
+
+pdsp::Function::Handle pdsp::Function::output( int number ) const{
+    Handle handle;
+    if( number >= 0 && number < (int)numbers.size() ){
+        handle.index = numbers[number];
+    }
+    if( handle.index == -1 ){
+        std::cout<<"[pdsp] warning! pdsp::Function has no output with this number id, returning invalid handle\n";
+        pdsp::pdsp_trace();
+    }
+    return handle;
+}
+
+void pdsp::Function::notFound(){
     std::cout<<"[pdsp] warning! sending message to non-existent output into pdsp::Function.code\n";
     pdsp::pdsp_trace();
 }
 
-void pdsp::Function::send( int number, float value ) noexcept{
+void pdsp::Function::send( Handle handle, float value ) noexcept{
+    if( handle.index >= 0 && handle.index < (int)outputs.size() ){
+        outputs[handle.index].messageBuffer->addMessage( value, sample );
+    }else{
+        notFound();
+    }
+}
+
+void pdsp::Function::send( const char* name, float value ) noexcept{
     for( size_t i=0; i<outputs.size(); ++i ){
-        if( outputs[i].number == number ){
+        if( std::strcmp( outputs[i].name.c_str(), name ) == 0 ){
             outputs[i].messageBuffer->addMessage( value, sample );
             return;
         }
     }
-    std::cout<<"[pdsp] warning! sending message to non-existent output into pdsp::Function.code\n";
-    pdsp::pdsp_trace();
+    notFound();
+}
+
+void pdsp::Function::send( const std::string & name, float value ) noexcept{
+    send( name.c_str(), value );
+}
+
+void pdsp::Function::send( int number, float value ) noexcept{
+    if( number >= 0 && number < (int)numbers.size() && numbers[number] >= 0 ){
+        outputs[numbers[number]].messageBuffer->addMessage( value, sample );
+    }else{
+        notFound();
+    }
 }
 
 void pdsp::Function::process( double playhead, double barsPerSample, int bufferSize ){
@@ -168,16 +210,23 @@ void pdsp::Function::process( double playhead, double barsPerSample, int bufferS
         double f = playhead * t; 
         double step = barsPerSample * t;
         
-        // this loop could probably be unrolled 
-        for( int i=0; i<bufferSize; ++i ){
-            double next = int( f + 0.5 );
-            double delta = f-next;
-            if ( delta >= 0.0 && delta < step ){
-                sample = i;
-                fi = f;
-                if(code) code();
+        if( step > 0.0 ){
+            // a frame is executed at the first sample at or after each integer f,
+            // the first frame is the one that could still fall on the first sample
+            double k = std::floor( f - step ) + 1.0;
+            int last = -1;
+            while( true ){
+                int i = (int) std::ceil( (k - f) / step );
+                if( i >= bufferSize ){ break; }
+                if( i < 0 ){ i = 0; }
+                if( i != last ){ // with very fast timings more frames can fall on the same sample
+                    sample = i;
+                    fi = (int) k;
+                    if(code) code();
+                    last = i;
+                }
+                k += 1.0;
             }
-            f += step;
         }
     }
     
@@ -80,7 +80,14 @@ namespace pdsp{
         @param[in] name output name
         @param[in] value value to send
         */ 
-        void send( std::string name, float value ) noexcept;
+        void send( const std::string & name, float value ) noexcept;
+
+        /*!
+        @brief use this method inside the assigned code to send a value to a given output name, it doesn't construct a std::string from the literal
+        @param[in] name output name
+        @param[in] value value to send
+        */ 
+        void send( const char* name, float value ) noexcept;
         
         /*!
         @brief use this method inside the assigned code to send a value to a given output number id
@@ -89,6 +96,36 @@ namespace pdsp{
         */ 
         void send( int number, float value ) noexcept;
 
+        /*!
+        @brief handle to an output, returned by output() and used by send() to reach the output without searching it.
+        */ 
+        class Handle {
+            friend class Function;
+        public:
+            Handle() : index(-1) {}
+        private:
+            int index;
+        };
+
+        /*!
+        @brief returns an handle to the output with the given name, already created with out_trig() or out_value(). Call it outside of the code and use it for sending.
+        @param[in] name output name
+        */ 
+        Handle output( const std::string & name ) const;
+
+        /*!
+        @brief returns an handle to the output with the given number id, already created with out_trig() or out_value(). Call it outside of the code and use it for sending.
+        @param[in] number output number id
+        */ 
+        Handle output( int number ) const;
+
+        /*!
+        @brief use this method inside the assigned code to send a value to the output of the given handle
+        @param[in] handle output handle
+        @param[in] value value to send
+        */ 
+        void send( Handle handle, float value ) noexcept;
+
         /*!
         @brief returns the playback timepoint in bars, multiplied by the timing, as integer.
         */ 
@@ -133,6 +170,10 @@ namespace pdsp{
         
         void clear( int bufferSize );
 
+        void addOutput( std::string name, int number );
+        void notFound();
+
+        // indices of the outputs for each number id, -1 if the id is not used
         std::vector<int> numbers;
         std::vector<Out> outputs;            
         static pdsp::SequencerGateOutput invalidGate;
@@ -0,0 +1,123 @@
+
+#include "OfflineRenderer.h"
+#include "SequenceGenerator.h"
+#include "../DSP/samplers/stream/SampleStream.h"
+#include <iostream>
+#include <cmath>
+
+pdsp::OfflineRenderer::OfflineRenderer( Processor & processor, SequencerProcessor & sequencer )
+: processor( processor ), sequencer( sequencer ){
+    sampleRate = 0.0;
+    bufferSize = 0;
+    renderedFrames = 0;
+}
+
+pdsp::OfflineRenderer::~OfflineRenderer(){
+    clearInputs();
+}
+
+void pdsp::OfflineRenderer::setup( double sampleRate, int bufferSize ){
+    this->sampleRate = sampleRate;
+    this->bufferSize = bufferSize;
+    inputBuffer.resize( bufferSize );
+    pdsp::releaseAll();
+    pdsp::prepareAllToPlay( bufferSize, sampleRate );
+}
+
+bool pdsp::OfflineRenderer::addInput( ExternalInput & input, std::string path, int channel ){
+    WavReader* reader = new WavReader();
+    if( ! reader->open( path ) ){
+        std::cout<<"[pdsp] warning! offline renderer input file "<<path<<" can't be opened\n";
+        delete reader;
+        return false;
+    }
+    if( channel < 0 || channel >= reader->channels() ){
+        std::cout<<"[pdsp] warning! offline renderer input file "<<path<<" has not channel "<<channel<<"\n";
+        delete reader;
+        return false;
+    }
+    if( sampleRate != 0.0 && reader->samplerate() != sampleRate ){
+        std::cout<<"[pdsp] warning! offline renderer input file "<<path<<" has a different sample rate, it will not be resampled\n";
+    }
+
+    FileInput fileInput;
+    fileInput.input = &input;
+    fileInput.reader = reader;
+    fileInput.channel = channel;
+    inputs.push_back( fileInput );
+    return true;
+}
+
+void pdsp::OfflineRenderer::clearInputs(){
+    for( FileInput & fileInput : inputs ){
+        delete fileInput.reader;
+    }
+    inputs.clear();
+}
+
+long pdsp::OfflineRenderer::getRenderedFrames() const {
+    return renderedFrames;
+}
+
+void pdsp::OfflineRenderer::processBuffer( long position, float** outputs, int channels ){
+
+    for( FileInput & fileInput : inputs ){
+        inputOutputs.assign( fileInput.reader->channels(), nullptr );
+        inputOutputs[fileInput.channel] = inputBuffer.data();
+        long read = fileInput.reader->read( position, bufferSize, inputOutputs.data() );
+        if( read < 0 ){ read = 0; }
+        for( int n=int(read); n<bufferSize; ++n ){
+            inputBuffer[n] = 0.0f;
+        }
+        fileInput.input->copyInput( inputBuffer.data(), bufferSize );
+    }
+
+    sequencer.process( bufferSize );
+    // the scores requested by the sequencer are ready before the next buffer
+    SequenceGenerator::flush();
+
+    processor.processAndCopyOutput( outputs, channels, bufferSize );
+    // as the streamed samples
+    SampleStreamer::flush();
+}
+
+bool pdsp::OfflineRenderer::render( std::string path, double seconds, int channels, int bitDepth ){
+    renderedFrames = 0;
+
+    if( bufferSize <= 0 ){
+        std::cout<<"[pdsp] warning! offline renderer not set up, call setup() before render()\n";
+        return false;
+    }
+
+    WavWriter writer;
+    if( ! writer.open( path, channels, sampleRate, bitDepth ) ){
+        std::cout<<"[pdsp] warning! offline renderer can't write "<<path<<"\n";
+        return false;
+    }
+
+    // the channels missing from the Processor are written silent
+    outputBuffer.assign( bufferSize * channels, 0.0f );
+    outputs.resize( channels );
+    for( int c=0; c<channels; ++c ){
+        outputs[c] = outputBuffer.data() + c * bufferSize;
+    }
+    int processed = ( channels < int(processor.channels.size()) ) ? channels : int(processor.channels.size());
+
+    long frames = std::lround( seconds * sampleRate );
+    bool written = true;
+
+    while( renderedFrames < frames && written ){
+        processBuffer( renderedFrames, outputs.data(), processed );
+
+        long toWrite = frames - renderedFrames;
+        if( toWrite > bufferSize ){ toWrite = bufferSize; }
+        written = writer.write( outputs.data(), toWrite );
+        renderedFrames += toWrite;
+    }
+
+    writer.close();
+    if( ! written ){
+        std::cout<<"[pdsp] warning! offline renderer error writing "<<path<<"\n";
+    }
+    return written;
+}
@@ -0,0 +1,91 @@
+
+// OfflineRenderer.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_OFFLINERENDERER_H_INCLUDED
+#define PDSP_OFFLINERENDERER_H_INCLUDED
+
+#include "../DSP/pdspCore.h"
+#include "../DSP/samplers/stream/WavReader.h"
+#include "../DSP/samplers/stream/WavWriter.h"
+#include "SequencerProcessor.h"
+#include <vector>
+#include <string>
+
+namespace pdsp{
+
+/*!
+@brief renders a patch and its sequencer to a .wav file without an audio device, as fast as the cpu can go.
+
+The renderer calls the SequencerProcessor and the Processor in a loop, like the audio callback of pdsp::Engine. Between two buffers it waits for the background threads, so the streamed samples and the Sequences generated ahead are always ready in time. For this reason the same patch always renders the same file, as long as the random generators used by your code are seeded. The output is written to disk buffer after buffer, so the memory used doesn't depend on the length of the rendering. Midi, osc and serial inputs and outputs are not processed.
+*/
+class OfflineRenderer {
+
+public:
+    OfflineRenderer( Processor & processor, SequencerProcessor & sequencer );
+    ~OfflineRenderer();
+
+    /*!
+    @brief prepares all the Units and modules to play at the given settings, it has to be called before render(). Don't use it while an Engine is running.
+    @param[in] sampleRate sample rate of the rendering
+    @param[in] bufferSize size of the processed buffers, it can be any value
+    */
+    void setup( double sampleRate, int bufferSize );
+
+    /*!
+    @brief feeds an ExternalInput with a channel of a .wav file during the rendering, after the end of the file the input is silent. Each rendering starts reading from the start of the file. Returns false if the file can't be opened.
+    @param[in] input ExternalInput to feed
+    @param[in] path path of the .wav file
+    @param[in] channel channel of the file to use
+    */
+    bool addInput( ExternalInput & input, std::string path, int channel=0 );
+
+    /*!
+    @brief removes all the inputs added with addInput()
+    */
+    void clearInputs();
+
+    /*!
+    @brief renders the given time and writes the first channels of the Processor to a .wav file. The sequencer plays only if play() has been called on it. Returns false if the file can't be written.
+    @param[in] path path of the .wav file to write
+    @param[in] seconds length of the rendering
+    @param[in] channels number of channels to write
+    @param[in] bitDepth 16 or 24 for integer samples, 32 for float samples. 24 by default
+    */
+    bool render( std::string path, double seconds, int channels=2, int bitDepth=24 );
+
+    /*!
+    @brief returns the number of frames rendered by the last render() call
+    */
+    long getRenderedFrames() const;
+
+private:
+    OfflineRenderer( const OfflineRenderer & other );
+    OfflineRenderer& operator=( const OfflineRenderer & other );
+
+    struct FileInput {
+        ExternalInput*  input;
+        WavReader*      reader;
+        int             channel;
+    };
+
+    void processBuffer( long position, float** outputs, int channels );
+
+    Processor &             processor;
+    SequencerProcessor &    sequencer;
+
+    double                  sampleRate;
+    int                     bufferSize;
+    long                    renderedFrames;
+
+    std::vector<FileInput>  inputs;
+    std::vector<float>      inputBuffer;
+    std::vector<float*>     inputOutputs;
+    std::vector<float>      outputBuffer;
+    std::vector<float*>     outputs;
+};
+
+}
+
+#endif // PDSP_OFFLINERENDERER_H_INCLUDED
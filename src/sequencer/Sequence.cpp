@@ -1,10 +1,14 @@
 
 #include "Sequence.h"
+#include "SequenceGenerator.h"
 
 double pdsp::Sequence::defaultSteplen = 1.0;
+std::atomic<int> pdsp::Sequence::overflows( 0 );
 
 pdsp::Sequence::Sequence( double stepDivision ){ 
     modified = false;    
+    generating = false;
+    score.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     code = []() noexcept {};
     loopCounter = 0;
@@ -15,56 +19,120 @@ pdsp::Sequence::Sequence( double stepDivision ){
     currentDelay = 0.0;
     steplen = 1.0 / stepDivision;
     bars = 1.0;
+
+    ahead = false;
+    lookahead = 1.0;
+    pending = false;
+    requested = false;
+    aheadBuffer.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
+    prepared = nullptr;
+    spare = &aheadBuffer;
 }
 
 pdsp::Sequence::Sequence() : Sequence (1.0){}
 
 pdsp::Sequence::Sequence(const Sequence & other){
     this->modified = other.modified.load();
+    generating = false;
     score = other.score;
+    score.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore = other.nextScore;
     code = other.code;
     label = other.label;
     bars.store( other.bars.load() );
     steplen.store( other.steplen.load() );
+    copyAhead( other );
 }
 
 pdsp::Sequence::Sequence(Sequence && other){
     this->modified = other.modified.load();
+    generating = false;
     score = other.score;
+    score.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore = other.nextScore;
     code = other.code;
     label = other.label;
     bars.store( other.bars.load() );
     steplen.store( other.steplen.load() );
+    copyAhead( other );
 }
 
 pdsp::Sequence& pdsp::Sequence::operator= (const Sequence & other){
     this->modified = other.modified.load();
+    generating = false;
     score = other.score;
+    score.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore = other.nextScore;
     code = other.code;
     label = other.label;
     bars.store( other.bars.load() );
     steplen.store( other.steplen.load() );
+    copyAhead( other );
     return *this;
 }
 
 pdsp::Sequence& pdsp::Sequence::operator= (Sequence && other){
     this->modified = other.modified.load();
+    generating = false;
     score = other.score;
+    score.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
     nextScore = other.nextScore;
     code = other.code;
     label = other.label;
     bars.store( other.bars.load() );
     steplen.store( other.steplen.load() );
+    copyAhead( other );
     return *this;
 }
 
+pdsp::Sequence::~Sequence(){
+    SequenceGenerator::remove( this );
+}
+
+void pdsp::Sequence::copyAhead( const Sequence & other ){
+    bool active = other.ahead;
+    double time = other.lookahead;
+    
+    generateAhead( false );
+    pending = false;
+    requested = false;
+    aheadBuffer.reserve(PDSP_PATTERN_MESSAGE_RESERVE_DEFAULT);
+    prepared = nullptr;
+    spare = &aheadBuffer;
+    
+    if( active ){
+        generateAhead( true, time );
+    }else{
+        lookahead = time;
+    }
+}
+
+void pdsp::Sequence::generateAhead( bool active, double lookahead ){
+    this->lookahead = lookahead;
+    if( active ){
+        if( ! ahead ){
+            ahead = true;
+            // nothing is generated until the first request from the audio thread, so code can still be assigned
+            SequenceGenerator::add( this );
+        }
+    }else{
+        ahead = false;
+        SequenceGenerator::remove( this );
+    }
+}
+
+void pdsp::Sequence::requestAhead( double timeToStart ) noexcept{
+    if( ahead && !requested && timeToStart <= lookahead ){
+        requested = true;
+        pending.store( true, std::memory_order_release );
+        SequenceGenerator::notify();
+    }
+}
+
 pdsp::Sequence & pdsp::Sequence::begin() noexcept{
     nextScore.clear();
     currentOutput = 0;
@@ -78,6 +146,11 @@ pdsp::Sequence & pdsp::Sequence::end() noexcept{
 }
 
 void pdsp::Sequence::message(double step, float value, int outputIndex, MessageType mtype ) noexcept{
+    // into the audio thread the score can't grow past its reserved capacity
+    if( generating && nextScore.size() == nextScore.capacity() ){
+        overflows.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
     nextScore.push_back( pdsp::SequencerMessage( step, value, outputIndex, mtype) );
 }
                 
@@ -115,19 +188,39 @@ pdsp::Sequence &  pdsp::Sequence::slew( float milliseconds ) noexcept{
 }
 
 void pdsp::Sequence::executeGenerateScore() noexcept {
-    code();
-    if(modified){
-        score.swap( nextScore ); // swap score in a thread-safe section
-        std::sort (score.begin(), score.end(), messageSort); //sort the messages
-        for( size_t i=0; i<score.size(); ++i){
-            score[i].time *= steplen;
+    if( ahead ){
+        std::vector<SequencerMessage>* ready = prepared.exchange( nullptr, std::memory_order_acquire );
+        if( ready != nullptr ){
+            score.swap( *ready ); // already sorted and scaled
+            spare.store( ready, std::memory_order_release );
+            id = (id == 1) ? 2 : 1;
+        }
+        requested = false;
+    }else{
+        generating = true;
+        code();
+        generating = false;
+        if(modified){
+            score.swap( nextScore ); // swap score in a thread-safe section
+            std::sort (score.begin(), score.end(), messageSort); //sort the messages
+            for( size_t i=0; i<score.size(); ++i){
+                score[i].time *= steplen;
+            }
+            id = (id == 1) ? 2 : 1;
+            modified = false;
         }
-        id = (id == 1) ? 2 : 1;
-        modified = false;
     }
     loopCounter++;
 }
 
+int pdsp::Sequence::getOverflows(){
+    return overflows.load( std::memory_order_relaxed );
+}
+
+void pdsp::Sequence::resetOverflows(){
+    overflows.store( 0, std::memory_order_relaxed );
+}
+
 int pdsp::Sequence::getChangeID() const {
     return id;
 }
@@ -188,7 +281,7 @@ void pdsp::Sequence::setTiming( double division, double bars ){
 }
 
 void pdsp::Sequence::message(double step, float value, int outputIndex) noexcept {
-    nextScore.push_back( pdsp::SequencerMessage( step, value, outputIndex) );
+    message( step, value, outputIndex, MValue );
 }
 
 void pdsp::Sequence::set( std::initializer_list<float> init ) noexcept {
@@ -202,7 +295,7 @@ void pdsp::Sequence::set( std::initializer_list<float> init ) noexcept {
     double time=0.0;
     for (const float & value : init){
         if( value >= 0.0f){
-            nextScore.push_back(  pdsp::SequencerMessage( time , value, 0) );            
+            message( time, value, 0, MValue );
         }
         time += 1.0;
     }
@@ -223,7 +316,7 @@ void pdsp::Sequence::set( std::initializer_list<std::initializer_list<float> >
         double time = 0.0;
         for ( const float & value : list){
             if( value >= 0.0f){
-                nextScore.push_back(  pdsp::SequencerMessage( time , value, out) );            
+                message( time, value, out, MValue );
             }
            time += 1.0;     
         }
@@ -247,7 +340,7 @@ void pdsp::Sequence::set( std::initializer_list<float> init, double division, do
     double time=0.0;
     for (const float & value : init){
         if( value >= 0.0f){
-            nextScore.push_back(  pdsp::SequencerMessage( time , value, 0) );            
+            message( time, value, 0, MValue );
         }
         time += 1.0;
     }
@@ -271,7 +364,7 @@ void pdsp::Sequence::set(  std::initializer_list<std::initializer_list<float> >
         double time = 0.0;
         for ( const float & value : list){
             if( value >= 0.0f){
-                nextScore.push_back(  pdsp::SequencerMessage( time , value, out) );            
+                message( time, value, out, MValue );
             }
            time += 1.0;     
         }
@@ -286,7 +379,7 @@ void pdsp::Sequence::messageVector( std::vector<float> vect, int outputIndex) {
     double time=0.0;
     for (const float & value : vect){
         if( value >= 0.0f){
-            nextScore.push_back(  pdsp::SequencerMessage( time , value, outputIndex) );            
+            message( time, value, outputIndex, MValue );
         }
         time += 1.0;
     }
@@ -299,8 +392,8 @@ void pdsp::Sequence::trigVector( std::vector<float> vect, double gateLength, int
     double offTime = gateLength;
     for (const float & value : vect){
         if( value > 0.0f){
-            nextScore.push_back(  pdsp::SequencerMessage( time,    value, outputIndex) );            
-            nextScore.push_back(  pdsp::SequencerMessage( offTime , 0.0f, outputIndex) );            
+            message( time, value, outputIndex, MValue );
+            message( offTime, 0.0f, outputIndex, MValue );
         }
         time    += 1.0;
         offTime += 1.0;
@@ -314,8 +407,8 @@ void pdsp::Sequence::trigVector( std::vector<float> vect, double gateLength, int
     double offTime = gateLength;
     for (const float & value : vect){
         if( value > 0.0f){
-            nextScore.push_back(  pdsp::SequencerMessage( time,    value*multiply, outputIndex) );            
-            nextScore.push_back(  pdsp::SequencerMessage( offTime , 0.0f,          outputIndex) );            
+            message( time, value*multiply, outputIndex, MValue );
+            message( offTime, 0.0f, outputIndex, MValue );
         }
         time    += 1.0;
         offTime += 1.0;
@@ -25,6 +25,7 @@ namespace pdsp{
     class Sequence {
         friend class SequencerSection;
         friend class SequencerProcessor;
+        friend class SequenceGenerator;
     public:
         Sequence( double stepDivision );
         Sequence();
@@ -32,6 +33,7 @@ namespace pdsp{
         Sequence(Sequence && other);
         Sequence& operator= (const Sequence & other);
         Sequence& operator= (Sequence && other);
+        ~Sequence();
       
       
         /*!
@@ -96,10 +98,17 @@ namespace pdsp{
 
         /*!
         @brief this lambda function is executed each time the Sequence starts from the begin. Assign your own functions to it.
-        This lambda function is executed each time the Sequence starts from the begin. Usually is empty, but you can assign your own lambdas to generate new values each time the Sequence starts. Remember that the code executed can make a previosly called set() method ininfluent. Remember that this function will be executed into the audio-thread so the access to some variable used also into the main thread could cause race conditions.
+        This lambda function is executed each time the Sequence starts from the begin. Usually is empty, but you can assign your own lambdas to generate new values each time the Sequence starts. Remember that the code executed can make a previosly called set() method ininfluent. Remember that this function will be executed into the audio-thread (or into the generator thread if generateAhead() is active) so the access to some variable used also into the main thread could cause race conditions.
         */
         std::function<void()> code;
 
+        /*!
+        @brief when active the code is executed on a background thread before the Sequence restarts instead of being executed into the audio-thread, and the score it generates is sorted and scaled there. The generation starts when the Sequence is the next to be played and it is missing the given time to its start. If the generation is not completed in time the last score is played again, as when the Sequence is launched without waiting the lookahead time. Inactive by default, set it before the Sequence is played. The code is not executed until the Sequence is going to be played, so it can be assigned after this method.
+        @param[in] active true to generate the score ahead of time
+        @param[in] lookahead time in bars before the start of the Sequence when the code is executed, defaults to one bar
+        */
+        void generateAhead( bool active, double lookahead = 1.0 );
+
         /*!
         @brief returns the percentual of completion of this sequence. When the sequence is not playing it will return the last value. Thread-safe.
         */ 
@@ -170,10 +179,15 @@ namespace pdsp{
         // this is not deprecated, just hidden from docs!
         int getChangeID() const;
 
+        // messages dropped because a code executed into the audio thread exceeded the reserved score, from all the Sequences
+        static int getOverflows();
+        static void resetOverflows();
+
     private:
         std::atomic<float> atomic_meter_percent;
         std::atomic<int> loopCounter;
         std::atomic<bool> modified;
+        bool generating;
         
         int id;
         int currentOutput;
@@ -184,10 +198,25 @@ namespace pdsp{
         std::vector<SequencerMessage> nextScore;
         
         void executeGenerateScore() noexcept;
+
+        // called by the audio thread at each buffer while the sequence is scheduled to be played next
+        void requestAhead( double timeToStart ) noexcept;
+        void copyAhead( const Sequence & other );
+
+        // scores generated ahead, the generator thread takes the spare buffer and publishes it as prepared
+        // the audio thread swaps the prepared buffer with the score and gives it back as spare
+        std::atomic<bool> ahead;
+        std::atomic<double> lookahead;
+        std::atomic<bool> pending;
+        bool requested;
+        std::vector<SequencerMessage> aheadBuffer;
+        std::atomic<std::vector<SequencerMessage>*> prepared;
+        std::atomic<std::vector<SequencerMessage>*> spare;
                 
         void message(double step, float value, int outputIndex, MessageType mtype ) noexcept;
 
         static double defaultSteplen;
+        static std::atomic<int> overflows;
         
     };
     
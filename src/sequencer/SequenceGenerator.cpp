@@ -0,0 +1,84 @@
+
+#include "SequenceGenerator.h"
+#include "Sequence.h"
+#include <algorithm>
+#include <chrono>
+
+pdsp::SequenceGenerator::SequenceGenerator(){}
+
+pdsp::SequenceGenerator & pdsp::SequenceGenerator::get(){
+    // never destroyed, so Sequences with static storage can be removed at exit
+    static SequenceGenerator* generator = new SequenceGenerator();
+    return *generator;
+}
+
+void pdsp::SequenceGenerator::add( Sequence* sequence ){
+    SequenceGenerator & generator = get();
+    {
+        std::lock_guard<std::mutex> lock( generator.mutex );
+        if( std::find( generator.sequences.begin(), generator.sequences.end(), sequence ) == generator.sequences.end() ){
+            generator.sequences.push_back( sequence );
+        }
+
+        // the thread is started only if some Sequence is generated ahead
+        if( ! generator.worker.joinable() ){
+            generator.worker = std::thread( &SequenceGenerator::threadFunction, &generator );
+        }
+    }
+    generator.condition.notify_one();
+}
+
+void pdsp::SequenceGenerator::remove( Sequence* sequence ){
+    SequenceGenerator & generator = get();
+    std::lock_guard<std::mutex> lock( generator.mutex );
+    generator.sequences.erase( std::remove( generator.sequences.begin(), generator.sequences.end(), sequence ), generator.sequences.end() );
+}
+
+void pdsp::SequenceGenerator::notify(){
+    get().condition.notify_one();
+}
+
+void pdsp::SequenceGenerator::flush(){
+    SequenceGenerator & generator = get();
+    std::lock_guard<std::mutex> lock( generator.mutex );
+    for( size_t i=0; i<generator.sequences.size(); ++i ){
+        generator.generate( *generator.sequences[i] );
+    }
+}
+
+void pdsp::SequenceGenerator::generate( Sequence & sequence ){
+
+    if( ! sequence.pending.exchange( false, std::memory_order_acquire ) ){ return; }
+
+    // the last generated score is still waiting to be played, the request is dropped
+    std::vector<SequencerMessage>* buffer = sequence.spare.exchange( nullptr, std::memory_order_acquire );
+    if( buffer == nullptr ){ return; }
+
+    sequence.code();
+
+    if( sequence.modified ){
+        buffer->swap( sequence.nextScore );
+        std::sort( buffer->begin(), buffer->end(), messageSort );
+        double steplen = sequence.steplen;
+        for( size_t i=0; i<buffer->size(); ++i ){
+            (*buffer)[i].time *= steplen;
+        }
+        sequence.modified = false;
+        sequence.prepared.store( buffer, std::memory_order_release );
+    }else{
+        sequence.spare.store( buffer, std::memory_order_release );
+    }
+}
+
+void pdsp::SequenceGenerator::threadFunction(){
+
+    std::unique_lock<std::mutex> lock( mutex );
+
+    while( true ){
+        for( size_t i=0; i<sequences.size(); ++i ){
+            generate( *sequences[i] );
+        }
+        // the audio thread notifies without locking, so a notification can be missed
+        condition.wait_for( lock, std::chrono::microseconds( PDSP_SEQUENCEGENERATOR_WAIT_US ) );
+    }
+}
@@ -0,0 +1,56 @@
+
+// SequenceGenerator.h
+// ofxPDSP
+// Nicola Pisanti, MIT License, 2016
+
+#ifndef PDSP_SEQUENCEGENERATOR_H_INCLUDED
+#define PDSP_SEQUENCEGENERATOR_H_INCLUDED
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*!
+    @cond HIDDEN_SYMBOLS
+*/
+
+namespace pdsp{
+
+    class Sequence;
+
+    // background thread that executes the code of the Sequences generated ahead of time
+    // and prepares their sorted and scaled scores for the audio thread
+    class SequenceGenerator {
+    public:
+        static void add( Sequence* sequence );
+
+        // after this returns the generator thread doesn't use the sequence anymore
+        static void remove( Sequence* sequence );
+
+        // wakes up the generator, it doesn't lock so it can be called from the audio thread
+        static void notify();
+
+        // generates all the requested scores on the calling thread, used between the buffers of an offline rendering
+        static void flush();
+
+    private:
+        SequenceGenerator();
+        static SequenceGenerator & get();
+
+        void generate( Sequence & sequence );
+        void threadFunction();
+
+        std::vector<Sequence*>      sequences;
+        std::thread                 worker;
+        std::mutex                  mutex;
+        std::condition_variable     condition;
+    };
+
+}
+
+/*!
+    @endcond
+*/
+
+#endif // PDSP_SEQUENCEGENERATOR_H_INCLUDED
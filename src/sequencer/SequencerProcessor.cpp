@@ -1,5 +1,6 @@
 
 #include "SequencerProcessor.h"
+#include "../DSP/core/RealtimeChecker.h"
 
 
 
@@ -38,6 +39,9 @@ void pdsp::SequencerProcessor::setMaxBars(double maxBars){
 
 
 void pdsp::SequencerProcessor::process(int const &bufferSize) noexcept{
+#ifdef PDSP_REALTIME_CHECKS
+    RealtimeChecker::Scope check;
+#endif
 
     if( tempo != tempoControl.load() ){
         tempo = tempoControl;
@@ -243,6 +243,14 @@ void pdsp::SequencerSection::processSection(const double &startPlayHead,
 
                 if(patternIndex!=-1 && patterns[patternIndex].sequence!=nullptr) playScore(playHeadDifference, schedulePoint, oneSlashBarsPerSample);//process new clip
             }
+
+            // lets the sequences generated ahead of time start their generation
+            if(scheduledPattern!=-1 && patterns[scheduledPattern].sequence!=nullptr){
+                patterns[scheduledPattern].sequence->requestAhead( scheduledTime - endPlayHead );
+            }
+            if(launchSchedule!=std::numeric_limits<double>::infinity() && patterns[launchedPattern2].sequence!=nullptr){
+                patterns[launchedPattern2].sequence->requestAhead( launchSchedule - endPlayHead );
+            }
             
             processBuffersDestinations(bufferSize);
             
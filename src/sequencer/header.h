@@ -11,5 +11,6 @@
 #include "SequencerMessage.h"
 #include "stockBehaviors.h"
 #include "Sequence.h"
+#include "OfflineRenderer.h"
 
 #endif // PDSP_SEQUENCERHEADER_H_INCLUDE
@@ -12,7 +12,7 @@ namespace pdsp{
 
 enum Window_t { Rectangular, Triangular, Hann, Hamming, Blackman, BlackmanHarris, SineWindow, Welch, Gaussian, Tukey };
 
-enum Interpolator_t {Linear, Smooth};
+enum Interpolator_t {Linear, Smooth, Sinc};
 
 enum SlewMode_t {Rate, Time};
 